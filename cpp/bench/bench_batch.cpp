@@ -0,0 +1,87 @@
+/**
+ * @file bench_batch.cpp
+ * @brief Per-entry JSON formatting vs. RecordBatch + format_json_batch
+ */
+
+#include <agora/log/batch.hpp>
+#include <agora/log/entry.hpp>
+#include <agora/log/formatter.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace agora::log;
+
+namespace {
+
+template<typename Fn>
+void run(const char* name, std::size_t batch_size, std::size_t records, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t done = 0; done < records; done += batch_size) {
+        fn();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-30s batch %5zu %10.1f ns/record %8.2f M records/s\n",
+        name,
+        batch_size,
+        elapsed * 1e9 / static_cast<double>(records),
+        static_cast<double>(records) / elapsed / 1e6);
+}
+
+}  // anonymous namespace
+
+int main() {
+    LogEntry entry;
+    entry.level = Level::Info;
+    entry.message = "Order executed for client \"acme\"";
+    entry.logger_name = "agora.trading.orders";
+    entry.location = SourceLocation{"order_router.cpp", 217, "void OrderRouter::route(const Order&)"};
+    entry.service_name = "order-router";
+    entry.environment = "production";
+    entry.version = "2.4.1";
+    entry.context = {
+        {"correlation_id", std::string("5f0c2c6e-1d3b-4a5e-9b7c-2f1e0d9c8b7a")},
+        {"symbol", std::string("AAPL")},
+        {"quantity", std::int64_t{1500}},
+        {"price", 187.42},
+        {"is_short", false}
+    };
+
+    constexpr std::size_t kRecords = 1'048'576;
+    const auto base = std::chrono::system_clock::now();
+
+    for (std::size_t batch_size : {64u, 1024u}) {
+        std::vector<LogEntry> entries(batch_size, entry);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            entries[i].timestamp = base + std::chrono::microseconds(i * 37);
+        }
+
+        JsonFormatter formatter;
+        std::string buffer;
+        run("JsonFormatter per entry", batch_size, kRecords, [&] {
+            buffer.clear();
+            for (const auto& e : entries) {
+                formatter.format(e, buffer);
+            }
+        });
+
+        RecordBatch batch;
+        run("push_back + format_json_batch", batch_size, kRecords, [&] {
+            batch.clear();
+            for (const auto& e : entries) {
+                batch.push_back(e);
+            }
+            buffer.clear();
+            format_json_batch(batch, buffer);
+        });
+
+        run("format_json_batch only", batch_size, kRecords, [&] {
+            buffer.clear();
+            format_json_batch(batch, buffer);
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bench_binary.cpp
+ * @brief Binary encoder vs. JSON: bytes per record and encode cost
+ */
+
+#include <agora/log/binary.hpp>
+#include <agora/log/entry.hpp>
+#include <agora/log/formatter.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using namespace agora::log;
+
+namespace {
+
+template<typename Fn>
+void run(const char* name, std::size_t iterations, Fn&& fn) {
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        bytes += fn(i);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-28s %10.1f ns/entry %8.1f bytes/entry %8.1f MB/s\n",
+        name,
+        elapsed * 1e9 / static_cast<double>(iterations),
+        static_cast<double>(bytes) / static_cast<double>(iterations),
+        static_cast<double>(bytes) / elapsed / 1e6);
+}
+
+}  // anonymous namespace
+
+int main() {
+    LogEntry entry;
+    entry.timestamp = std::chrono::system_clock::now();
+    entry.level = Level::Info;
+    entry.message = "Order executed for client \"acme\"";
+    entry.logger_name = "agora.trading.orders";
+    entry.location = SourceLocation{"order_router.cpp", 217, "void OrderRouter::route(const Order&)"};
+    entry.service_name = "order-router";
+    entry.environment = "production";
+    entry.version = "2.4.1";
+    entry.context = {
+        {"correlation_id", std::string("5f0c2c6e-1d3b-4a5e-9b7c-2f1e0d9c8b7a")},
+        {"symbol", std::string("AAPL")},
+        {"quantity", std::int64_t{1500}},
+        {"price", 187.42},
+        {"is_short", false}
+    };
+
+    constexpr std::size_t kIterations = 500'000;
+    const auto base = entry.timestamp;
+
+    std::string buffer;
+    run("format_json (reused buffer)", kIterations, [&](std::size_t i) {
+        entry.timestamp = base + std::chrono::microseconds(i * 37);
+        buffer.clear();
+        format_json(entry, buffer);
+        return buffer.size() + 1;
+    });
+
+    BinaryEncoder encoder;
+    run("BinaryEncoder", kIterations, [&](std::size_t i) {
+        entry.timestamp = base + std::chrono::microseconds(i * 37);
+        buffer.clear();
+        encoder.encode(entry, buffer);
+        return buffer.size();
+    });
+
+    // Decode cost for the offline tool
+    std::string stream;
+    BinaryEncoder stream_encoder;
+    for (std::size_t i = 0; i < kIterations; ++i) {
+        entry.timestamp = base + std::chrono::microseconds(i * 37);
+        stream_encoder.encode(entry, stream);
+    }
+    std::istringstream in(stream);
+    BinaryDecoder decoder(in);
+    LogEntry decoded;
+    run("BinaryDecoder", kIterations, [&](std::size_t) {
+        auto result = decoder.next(decoded);
+        return result && *result ? decoded.message.size() : 0;
+    });
+
+    return 0;
+}
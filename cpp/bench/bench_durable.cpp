@@ -0,0 +1,179 @@
+/**
+ * @file bench_durable.cpp
+ * @brief Durable records/s: fdatasync per record vs. group commit
+ *
+ * Each writer thread logs a critical record and waits for its commit
+ * token before the next one, like an order gateway acknowledging orders.
+ * Run on the storage the audit log will live on; tmpfs syncs are free.
+ *
+ *   ./bench_durable [directory]   (default: current directory)
+ */
+
+#include <agora/log/commit.hpp>
+#include <agora/log/config.hpp>
+#include <agora/log/entry.hpp>
+#include <agora/log/logger.hpp>
+#include <agora/log/handlers/durable_file.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace agora::log;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto kDuration = std::chrono::seconds(2);
+
+// syncs == 0: not observable (Logger API)
+void report(const char* name, std::size_t threads, std::size_t records, double seconds, std::size_t syncs) {
+    char per_sync[32] = "-";
+    if (syncs > 0) {
+        std::snprintf(per_sync, sizeof(per_sync), "%.1f", static_cast<double>(records) / static_cast<double>(syncs));
+    }
+    std::printf("%-34s %3zu threads %10.0f records/s %8s records/sync %8.1f us/ack\n",
+        name,
+        threads,
+        static_cast<double>(records) / seconds,
+        per_sync,
+        seconds * 1e6 * static_cast<double>(threads) / static_cast<double>(records));
+}
+
+// Baseline: every writer writes and fdatasyncs its own record
+void bench_sync_per_record(const fs::path& path, std::size_t threads) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_TRUNC | O_CLOEXEC, 0644);
+    std::atomic<std::size_t> records{0};
+    std::atomic<bool> stop{false};
+    const std::string record = "{\"level\":\"CRITICAL\",\"message\":\"order acknowledged\"}\n";
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (::write(fd, record.data(), record.size()) < 0 || ::fdatasync(fd) != 0) {
+                    return;
+                }
+                records.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::this_thread::sleep_for(kDuration);
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ::close(fd);
+    report("write + fdatasync per record", threads, records.load(), seconds, records.load());
+}
+
+// Logger::critical() into a DurableFileHandler, waiting on each token
+void bench_group_commit(const fs::path& path, std::size_t threads, std::size_t delay_us) {
+    fs::remove(path);
+
+    Config config;
+    config.service_name = "bench";
+    config.console_enabled = false;
+    config.file_enabled = false;
+    config.durable_file_enabled = true;
+    config.durable_file_path = path;
+    config.durable_max_batch_delay_us = delay_us;
+    config.routes = {Route{.prefix = "bench.audit", .handlers = {"durable"}}};
+    if (!initialize(config)) {
+        std::fprintf(stderr, "initialize failed\n");
+        return;
+    }
+
+    auto logger = get_logger("bench.audit");
+    std::atomic<std::size_t> records{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::int64_t order = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto token = logger.critical("order acknowledged", {
+                    {"thread", static_cast<std::int64_t>(t)},
+                    {"order", order++}
+                });
+                if (!token.durable() || !token.wait()) {
+                    return;
+                }
+                records.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::this_thread::sleep_for(kDuration);
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    shutdown();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "group commit (delay %zu us)", delay_us);
+    report(name, threads, records.load(), seconds, 0);
+}
+
+// Same workload on the handler directly, to report records per fdatasync
+void bench_handler(const fs::path& path, std::size_t threads) {
+    fs::remove(path);
+    DurableFileHandler handler(path);
+    std::atomic<std::size_t> records{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                LogEntry entry;
+                entry.timestamp = std::chrono::system_clock::now();
+                entry.level = Level::Critical;
+                entry.message = "order acknowledged";
+                entry.commit = std::make_shared<CommitState>(1);
+                CommitToken token(entry.commit);
+                handler.write(entry);
+                if (!token.wait()) {
+                    return;
+                }
+                records.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::this_thread::sleep_for(kDuration);
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report("DurableFileHandler", threads, records.load(), seconds, handler.sync_calls());
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    fs::path directory = argc > 1 ? fs::path(argv[1]) : fs::current_path();
+    fs::path path = directory / "bench_durable.log";
+
+    for (std::size_t threads : {1, 4, 16, 64}) {
+        bench_sync_per_record(path, threads);
+        bench_handler(path, threads);
+        bench_group_commit(path, threads, 0);
+        bench_group_commit(path, threads, 200);
+    }
+
+    fs::remove(path);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file bench_formatter.cpp
+ * @brief Formatter throughput: streaming JSON writer vs. nlohmann::json DOM,
+ *        CBOR, and the compiled text pattern layout
+ */
+
+#include <agora/log/entry.hpp>
+#include <agora/log/formatter.hpp>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace agora::log;
+using json = nlohmann::json;
+
+namespace {
+
+// Original DOM-based implementation, kept here as the baseline
+std::string dom_format_json(const LogEntry& entry) {
+    auto time_t_val = std::chrono::system_clock::to_time_t(entry.timestamp);
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        entry.timestamp.time_since_epoch()
+    ) % 1'000'000;
+    std::tm tm{};
+    gmtime_r(&time_t_val, &tm);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    oss << '.' << std::setfill('0') << std::setw(6) << microseconds.count() << 'Z';
+
+    json j;
+    j["timestamp"] = oss.str();
+    j["level"] = to_string(entry.level);
+    j["message"] = entry.message;
+    j["service"] = entry.service_name;
+    j["environment"] = entry.environment;
+    j["version"] = entry.version;
+    j["logger_name"] = entry.logger_name;
+    j["file"] = entry.location.file;
+    j["line"] = entry.location.line;
+    j["function"] = entry.location.function;
+    if (!entry.context.empty()) {
+        json context_obj;
+        for (const auto& [key, value] : entry.context) {
+            context_obj[key] = std::visit([](const auto& v) -> json { return v; }, value);
+        }
+        j["context"] = context_obj;
+    }
+    return j.dump();
+}
+
+template<typename Fn>
+void run(const char* name, std::size_t iterations, Fn&& fn) {
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        bytes += fn();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-28s %10.1f ns/entry %10.2f M entries/s %8.1f MB/s %8.1f bytes/entry\n",
+        name,
+        elapsed * 1e9 / static_cast<double>(iterations),
+        static_cast<double>(iterations) / elapsed / 1e6,
+        static_cast<double>(bytes) / elapsed / 1e6,
+        static_cast<double>(bytes) / static_cast<double>(iterations));
+}
+
+}  // anonymous namespace
+
+int main() {
+    LogEntry entry;
+    entry.timestamp = std::chrono::system_clock::now();
+    entry.level = Level::Info;
+    entry.message = "Order executed for client \"acme\"";
+    entry.logger_name = "agora.trading.orders";
+    entry.location = SourceLocation{"order_router.cpp", 217, "void OrderRouter::route(const Order&)"};
+    entry.service_name = "order-router";
+    entry.environment = "production";
+    entry.version = "2.4.1";
+    entry.context = {
+        {"correlation_id", std::string("5f0c2c6e-1d3b-4a5e-9b7c-2f1e0d9c8b7a")},
+        {"symbol", std::string("AAPL")},
+        {"quantity", std::int64_t{1500}},
+        {"price", 187.42},
+        {"is_short", false}
+    };
+
+    constexpr std::size_t kIterations = 500'000;
+
+    run("nlohmann::json DOM", kIterations, [&] {
+        return dom_format_json(entry).size();
+    });
+
+    run("format_json (string)", kIterations, [&] {
+        return format_json(entry).size();
+    });
+
+    std::string buffer;
+    run("format_json (reused buffer)", kIterations, [&] {
+        buffer.clear();
+        format_json(entry, buffer);
+        return buffer.size();
+    });
+
+    const auto compact = make_format_options(OutputProfile::Compact);
+    run("format_json (compact profile)", kIterations, [&] {
+        buffer.clear();
+        format_json(entry, buffer, compact);
+        return buffer.size();
+    });
+
+    const auto minimal = make_format_options(OutputProfile::Minimal);
+    run("format_json (minimal profile)", kIterations, [&] {
+        buffer.clear();
+        format_json(entry, buffer, minimal);
+        return buffer.size();
+    });
+
+    run("format_cbor (reused buffer)", kIterations, [&] {
+        buffer.clear();
+        format_cbor(entry, buffer);
+        return buffer.size();
+    });
+
+    run("format_text (reused buffer)", kIterations, [&] {
+        buffer.clear();
+        format_text(entry, buffer);
+        return buffer.size();
+    });
+
+    return 0;
+}
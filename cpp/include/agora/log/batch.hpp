@@ -0,0 +1,121 @@
+/**
+ * @file batch.hpp
+ * @brief Structure-of-arrays record batches and the batch JSON formatter
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "entry.hpp"
+#include "formatter.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Batch of log records stored column-wise for backend formatting.
+ *
+ * push_back() copies every string of an entry into one contiguous text
+ * buffer and sorts its context once, so a backend thread can render the
+ * whole batch with format_json_batch() in a single pass over dense
+ * memory. Reuse a batch with clear() to keep its capacity.
+ */
+class RecordBatch {
+public:
+    /** Slice of the batch's text storage. */
+    struct Text {
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    /** Context field, with values stored inline or in text storage. */
+    struct Field {
+        Text key;
+        std::uint8_t type = 0;  ///< ContextValue alternative: 0 string, 1 int64, 2 double, 3 bool
+        Text string;
+        std::int64_t integer = 0;
+        double number = 0.0;
+        bool boolean = false;
+    };
+
+    /** Append a copy of @p entry. */
+    void push_back(const LogEntry& entry);
+
+    /** Remove all records, keeping allocated capacity. */
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept { return timestamps_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return timestamps_.empty(); }
+
+    /** Resolve a text slice (valid until the next push_back or clear). */
+    [[nodiscard]] std::string_view text(Text t) const noexcept {
+        return std::string_view(text_.data() + t.offset, t.length);
+    }
+
+    // Column accessors for record @p i
+    [[nodiscard]] std::chrono::system_clock::time_point timestamp(std::size_t i) const noexcept { return timestamps_[i]; }
+    [[nodiscard]] Level level(std::size_t i) const noexcept { return levels_[i]; }
+    [[nodiscard]] std::uint32_t line(std::size_t i) const noexcept { return lines_[i]; }
+    [[nodiscard]] std::string_view message(std::size_t i) const noexcept { return text(messages_[i]); }
+    [[nodiscard]] std::string_view logger_name(std::size_t i) const noexcept { return text(logger_names_[i]); }
+    [[nodiscard]] std::string_view file(std::size_t i) const noexcept { return text(files_[i]); }
+    [[nodiscard]] std::string_view function(std::size_t i) const noexcept { return text(functions_[i]); }
+    [[nodiscard]] const std::optional<double>& duration_ms(std::size_t i) const noexcept { return durations_[i]; }
+
+    /** Context fields of record @p i, sorted by key. */
+    [[nodiscard]] std::span<const Field> context(std::size_t i) const noexcept {
+        return std::span<const Field>(fields_).subspan(field_begin_[i], field_begin_[i + 1] - field_begin_[i]);
+    }
+
+    /** Exception (type, message) of record @p i, if any. */
+    [[nodiscard]] const std::array<Text, 2>* exception(std::size_t i) const noexcept {
+        return exception_index_[i] < 0 ? nullptr : &exceptions_[static_cast<std::size_t>(exception_index_[i])];
+    }
+
+    /**
+     * @brief Index of the (environment, service, version) triple of record @p i.
+     *
+     * Consecutive records with the same metadata share one triple, so a
+     * formatter can render it once per batch instead of once per record.
+     */
+    [[nodiscard]] std::uint32_t metadata_index(std::size_t i) const noexcept { return metadata_[i]; }
+    [[nodiscard]] const std::vector<std::array<Text, 3>>& metadata() const noexcept { return metadata_table_; }
+
+private:
+    std::vector<std::chrono::system_clock::time_point> timestamps_;
+    std::vector<Level> levels_;
+    std::vector<std::uint32_t> lines_;
+    std::vector<Text> messages_;
+    std::vector<Text> logger_names_;
+    std::vector<Text> files_;
+    std::vector<Text> functions_;
+    std::vector<std::optional<double>> durations_;
+    std::vector<std::int32_t> exception_index_;
+    std::vector<std::array<Text, 2>> exceptions_;
+    std::vector<std::uint32_t> field_begin_{0};
+    std::vector<Field> fields_;
+    std::vector<std::uint32_t> metadata_;
+    std::vector<std::array<Text, 3>> metadata_table_;
+    std::string text_;
+
+    Text store(std::string_view value);
+};
+
+/**
+ * @brief Append every record of @p batch as newline-delimited JSON.
+ *
+ * Output is byte-identical to calling JsonFormatter::format() per record,
+ * written into one contiguous buffer ready for a single write(). The
+ * escaped service/environment/version strings are rendered once per
+ * distinct triple rather than once per record.
+ */
+void format_json_batch(const RecordBatch& batch, std::string& out, const FormatOptions& options = {});
+
+}  // namespace agora::log
@@ -0,0 +1,136 @@
+/**
+ * @file binary.hpp
+ * @brief Compact binary log record format (encoder and decoder)
+ *
+ * A binary log is a sequence of length-prefixed records:
+ *
+ *   record   := type:u8  length:varint  payload[length]
+ *
+ *   Session  (0x00): "AGLB" version:u8 schema:str
+ *       Starts a stream. Resets all dictionaries and the timestamp base,
+ *       so appending a new session to an existing file is always valid.
+ *   String   (0x01): id:varint  value:str
+ *       Dictionary entry for logger names, files, functions, context keys
+ *       and the service/environment/version strings.
+ *   CallSite (0x02): id:varint  file:id  line:varint  function:id
+ *   Entry    (0x03): ts_delta:zigzag  level:u8  callsite:id  logger:id
+ *                    service:id  environment:id  version:id  message:str
+ *                    flags:u8  ctx_count:varint  ctx[ctx_count]
+ *                    [exception: type:str message:str]  [duration:f64]
+ *       ts_delta is nanoseconds relative to the previous entry.
+ *       ctx      := key:id  tag:u8  value
+ *                   (0 string:str, 1 int:zigzag, 2 double:f64, 3 bool:u8)
+ *
+ *   str := length:varint bytes;  f64 := 8 bytes little-endian IEEE 754
+ *
+ * Unknown record types are skipped by length, so the format can grow.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "entry.hpp"
+
+namespace agora::log {
+
+/** Binary format version written in the session record. */
+inline constexpr std::uint8_t kBinaryFormatVersion = 1;
+
+/**
+ * @brief Stateful encoder for the binary log format.
+ *
+ * Keeps the string/call-site dictionaries and the previous timestamp for
+ * one output stream. Not thread-safe; callers serialize access.
+ */
+class BinaryEncoder {
+public:
+    static constexpr std::size_t kMaxDictionarySize = 64 * 1024;
+
+    BinaryEncoder() = default;
+
+    /**
+     * @brief Append a session record and reset all encoder state.
+     */
+    void begin_session(std::string& out);
+
+    /**
+     * @brief Append any new dictionary records followed by the entry record.
+     *
+     * Starts a new session automatically before the first entry and when
+     * the dictionary grows past kMaxDictionarySize, which bounds memory
+     * for streams with unbounded distinct context keys or logger names.
+     */
+    void encode(const LogEntry& entry, std::string& out);
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
+
+    struct CallSiteKey {
+        std::uint32_t file;
+        std::uint32_t function;
+        std::uint32_t line;
+        bool operator==(const CallSiteKey&) const = default;
+    };
+
+    struct CallSiteHash {
+        std::size_t operator()(const CallSiteKey& k) const noexcept {
+            return (std::size_t{k.file} * 0x9E3779B1u) ^ (std::size_t{k.function} << 20) ^ k.line;
+        }
+    };
+
+    std::unordered_map<std::string, std::uint32_t, StringHash, std::equal_to<>> strings_;
+    std::unordered_map<CallSiteKey, std::uint32_t, CallSiteHash> call_sites_;
+    std::int64_t last_timestamp_ns_ = 0;
+    bool in_session_ = false;
+    std::string scratch_;
+    std::vector<std::uint32_t> key_ids_;
+
+    std::uint32_t intern(std::string_view value, std::string& out);
+    std::uint32_t call_site(const SourceLocation& location, std::string& out);
+};
+
+/**
+ * @brief Streaming decoder for the binary log format.
+ *
+ * Decoded entries reference dictionary storage owned by the decoder
+ * (SourceLocation::file/function); they stay valid until the next
+ * session record is read or the decoder is destroyed.
+ */
+class BinaryDecoder {
+public:
+    explicit BinaryDecoder(std::istream& in)
+        : in_(in) {}
+
+    /**
+     * @brief Decode the next entry.
+     *
+     * @return true if @p entry was filled, false at end of stream, or an
+     *         Error for corrupt or truncated input.
+     */
+    std::expected<bool, Error> next(LogEntry& entry);
+
+private:
+    std::istream& in_;
+    std::deque<std::string> strings_;  // deque keeps element addresses stable
+    std::vector<SourceLocation> call_sites_;
+    std::int64_t last_timestamp_ns_ = 0;
+    bool in_session_ = false;
+    std::string payload_;
+
+    [[nodiscard]] const std::string* string_at(std::uint64_t id) const noexcept;
+};
+
+}  // namespace agora::log
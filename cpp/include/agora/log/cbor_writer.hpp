@@ -0,0 +1,77 @@
+/**
+ * @file cbor_writer.hpp
+ * @brief Low-level CBOR (RFC 8949) encoding primitives used by the formatters
+ *
+ * Like json_writer.hpp, all functions append to a caller-owned buffer.
+ * Heads always use the shortest argument encoding (preferred serialization).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace agora::log {
+
+/**
+ * @brief CBOR major types (high three bits of the initial byte).
+ */
+enum class CborMajor : std::uint8_t {
+    Unsigned = 0,
+    Negative = 1,
+    Bytes = 2,
+    Text = 3,
+    Array = 4,
+    Map = 5,
+    Tag = 6,
+    Simple = 7
+};
+
+/**
+ * @brief Append an initial byte plus the shortest argument for @p value.
+ */
+void append_cbor_head(std::string& out, CborMajor major, std::uint64_t value);
+
+/**
+ * @brief Append a UTF-8 text string.
+ *
+ * Invalid UTF-8 is replaced with U+FFFD, matching append_json_string().
+ */
+void append_cbor_text(std::string& out, std::string_view value);
+
+/**
+ * @brief Append a signed integer (major type 0 or 1).
+ */
+inline void append_cbor_int(std::string& out, std::int64_t value) {
+    if (value >= 0) {
+        append_cbor_head(out, CborMajor::Unsigned, static_cast<std::uint64_t>(value));
+    } else {
+        // -1 - n without overflow for INT64_MIN
+        append_cbor_head(out, CborMajor::Negative, ~static_cast<std::uint64_t>(value));
+    }
+}
+
+/**
+ * @brief Append an unsigned integer (major type 0).
+ */
+inline void append_cbor_uint(std::string& out, std::uint64_t value) {
+    append_cbor_head(out, CborMajor::Unsigned, value);
+}
+
+/**
+ * @brief Append a floating-point number.
+ *
+ * Uses single precision when it round-trips exactly, double otherwise.
+ * NaN and infinity are encoded natively (unlike JSON, which writes null).
+ */
+void append_cbor_double(std::string& out, double value);
+
+/**
+ * @brief Append true/false.
+ */
+inline void append_cbor_bool(std::string& out, bool value) {
+    out.push_back(static_cast<char>(value ? 0xF5 : 0xF4));
+}
+
+}  // namespace agora::log
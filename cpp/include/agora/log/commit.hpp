@@ -0,0 +1,35 @@
+/**
+ * @file commit.hpp
+ * @brief Shared completion state behind CommitToken
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "logger.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Completion state of one durable record.
+ *
+ * Created by the logger with the number of durable handlers the record
+ * goes to; each of them calls complete() exactly once, after its
+ * fdatasync or on failure. The first error is kept.
+ */
+struct CommitState {
+    explicit CommitState(std::size_t handlers) noexcept : remaining(handlers) {}
+
+    /** One handler is done; @p error is an errno value or 0. */
+    void complete(int error = 0) noexcept;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t remaining;
+    int error = 0;
+};
+
+}  // namespace agora::log
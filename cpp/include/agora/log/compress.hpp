@@ -0,0 +1,67 @@
+/**
+ * @file compress.hpp
+ * @brief Whole-file compression for rotated log backups
+ */
+
+#pragma once
+
+#include "logger.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <istream>
+#include <string_view>
+
+namespace agora::log {
+
+/**
+ * @brief Compression codec for backups.
+ *
+ * Codecs are compiled in when their library is found at build time
+ * (AGORA_LOG_HAVE_ZSTD, AGORA_LOG_HAVE_ZLIB).
+ */
+enum class Compression {
+    None,
+    Zlib,  ///< gzip stream, ".gz" (readable with zcat)
+    Zstd   ///< zstd frame, ".zst"
+};
+
+/**
+ * @brief Best codec available in this build: zstd, then zlib, then None.
+ */
+[[nodiscard]] Compression default_compression() noexcept;
+
+/**
+ * @brief File name suffix for @p compression (".zst", ".gz" or "").
+ */
+constexpr std::string_view compression_suffix(Compression compression) noexcept {
+    switch (compression) {
+        case Compression::None: return "";
+        case Compression::Zlib: return ".gz";
+        case Compression::Zstd: return ".zst";
+    }
+    return "";
+}
+
+/**
+ * @brief Compress everything remaining in @p source into @p destination.
+ *
+ * Streams in chunks; @p destination is replaced. Returns the compressed
+ * size in bytes.
+ */
+[[nodiscard]] std::expected<std::uint64_t, Error> compress_file(
+    std::istream& source,
+    const std::filesystem::path& destination,
+    Compression compression
+);
+
+/**
+ * @brief Compress the file @p source into @p destination (source is kept).
+ */
+[[nodiscard]] std::expected<std::uint64_t, Error> compress_file(
+    const std::filesystem::path& source,
+    const std::filesystem::path& destination,
+    Compression compression
+);
+
+}  // namespace agora::log
@@ -9,8 +9,15 @@
 #include <filesystem>
 #include <expected>
 #include <optional>
+#include <vector>
 
 #include "logger.hpp"
+#include "formatter.hpp"
+#include "limits.hpp"
+#include "pattern.hpp"
+#include "routing.hpp"
+#include "timestamp.hpp"
+#include "handlers/rotating_file.hpp"
 
 namespace agora::log {
 
@@ -22,16 +29,109 @@ struct Config {
     std::string environment = "development";
     std::string version = "0.0.0";
     Level level = Level::Info;
+
+    // Timestamp representation in formatted output
+    TimestampFormat timestamp_format = TimestampFormat::Iso8601;
+
+    // Field selection for JSON/CBOR output (see make_format_options)
+    OutputProfile output_profile = OutputProfile::Full;
+
+    // Size caps applied before formatting (0 = unlimited, see limits.hpp)
+    RecordLimits limits{
+        .max_field_bytes = 64 * 1024,
+        .max_record_bytes = 256 * 1024
+    };
     
     // Console output
     bool console_enabled = true;
     bool console_json = true;
+    std::string console_pattern = std::string(kDefaultTextPattern);  // Text layout (see pattern.hpp)
+    // Batched console output written by a background thread; with
+    // console_drop_when_full records are dropped instead of waiting for a
+    // slow pipe (see BufferedConsoleHandler)
+    bool console_buffered = false;
+    bool console_drop_when_full = false;
+    Level console_level = Level::Debug;  // Threshold on top of `level`
     
     // File output
     bool file_enabled = true;
     std::filesystem::path file_path = "/agora/logs/app.log";
     double max_file_size_mb = 100.0;   // Supports fractional MB for small test files
     std::size_t max_backup_count = 5;
+    // Time-based rotation; with max_file_size_mb = 0 it is the only trigger,
+    // otherwise files rotate on whichever comes first (hybrid)
+    RotationInterval file_rotation_interval = RotationInterval::None;
+    BackupNaming file_backup_naming = BackupNaming::Cascade;  // sequence: O(1) rotation
+    bool file_compress = false;  // Compress backups in the background (zstd/zlib)
+    // Retention across all backups (compressed at their compressed size), on
+    // top of max_backup_count; enforced by a background thread (see RetentionOptions)
+    double file_retention_max_mb = 0.0;            // 0 = no total size limit
+    std::size_t file_retention_max_age_s = 0;      // 0 = no age limit
+    std::size_t file_retention_rescan_s = 300;     // 0 = never re-list the directory
+    FileFormat file_format = FileFormat::Json;  // json or length-delimited cbor
+    bool file_preallocate = false;  // fallocate each segment to the rotation size
+    bool file_direct_io = false;    // O_DIRECT, block-aligned writes (see SegmentFile)
+    Level file_level = Level::Debug;  // Threshold on top of `level` (also route and durable files)
+
+    // Failing or stalled disk: the rotating file handler keeps records in a
+    // bounded memory buffer (shedding DEBUG first) and retries the disk with
+    // exponential backoff (see SpillOptions, disk_stats())
+    std::size_t file_spill_bytes = 4 * 1024 * 1024;
+    std::size_t file_slow_write_ms = 100;  // 0 = only errors degrade
+    std::size_t file_retry_initial_ms = 100;
+    std::size_t file_retry_max_ms = 30'000;
+
+    // Buffered file output: records are appended to memory and written by a
+    // background thread in large chunks (see BufferedFileHandler)
+    bool file_buffered = false;
+    std::size_t file_buffer_size = 256 * 1024;
+    std::size_t file_flush_interval_ms = 100;
+
+    // io_uring file output with several buffer writes in flight; uses the
+    // buffer size and flush interval above. Falls back to the buffered
+    // handler when io_uring is unavailable (see IoUringFileHandler)
+    bool file_io_uring = false;
+    std::size_t file_io_uring_queue_depth = 4;
+
+    // Memory-mapped file output: producers copy records into a mapped
+    // segment of the rotation size without locking (see MmapFileHandler)
+    bool file_mmap = false;
+
+    // Per-thread file output: every thread appends to its own segment next
+    // to file_path (app.log.t0, ...) without sharing a lock; merge them with
+    // agora-log-merge. Uses file_buffer_size per thread and
+    // file_flush_interval_ms; no rotation (see PerThreadFileHandler)
+    bool file_per_thread = false;
+
+    // Durable file output: every record is fdatasync'ed (group commit) and
+    // Logger::critical()/audit() tokens complete once it is on stable
+    // storage. Only loggers routed to it with handlers=durable write there
+    // (see DurableFileHandler)
+    bool durable_file_enabled = false;
+    std::filesystem::path durable_file_path = "/agora/logs/audit.log";
+    std::size_t durable_max_batch_delay_us = 0;  // Extra wait to grow a batch
+
+    // Binary file output (decode with agora-log-decode)
+    bool binary_file_enabled = false;
+    std::filesystem::path binary_file_path = "/agora/logs/app.binlog";
+
+    // Local daemons over Unix datagram sockets (see JournaldHandler, SyslogHandler)
+    bool journald_enabled = false;
+    std::filesystem::path journald_socket = "/run/systemd/journal/socket";
+    bool syslog_enabled = false;
+    std::filesystem::path syslog_socket = "/dev/log";
+    int syslog_facility = 1;  // user-level
+
+    // Parallel fan-out: with sink_workers > 0, handlers are written by a
+    // pool with one queue per handler instead of on the logging thread (see
+    // SinkExecutor)
+    std::size_t sink_workers = 0;
+    std::size_t sink_queue_capacity = 8192;  // Records per handler queue
+    bool sink_drop_when_full = false;
+
+    // Per-logger handler selection and level by name prefix, resolved when
+    // each logger is created (see Route)
+    std::vector<Route> routes;
     
     // Default context
     Context default_context;
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <chrono>
+#include <memory>
 #include <optional>
 #include "logger.hpp"
 
@@ -43,6 +44,10 @@ struct LogEntry {
     std::optional<ExceptionInfo> exception;
     std::optional<double> duration_ms;
 
+    // Set when the caller waits for durability; durable handlers complete
+    // it once the record is on stable storage (see commit.hpp)
+    std::shared_ptr<CommitState> commit;
+
     // Config metadata
     std::string service_name;
     std::string environment;
@@ -6,18 +6,229 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "entry.hpp"
+#include "timestamp.hpp"
 
 namespace agora::log {
 
+/**
+ * @brief Options shared by the formatters.
+ *
+ * The defaults reproduce the full record. Structured formatters (JSON,
+ * CBOR) honour every option; text layouts only honour timestamp_format
+ * and trim_function.
+ */
+struct FormatOptions {
+    TimestampFormat timestamp_format = TimestampFormat::Iso8601;
+
+    bool short_keys = false;           ///< "ts", "lvl", "msg", ... instead of full field names
+    bool trim_function = false;        ///< Unqualified function name instead of the full signature
+    bool metadata_in_header = false;   ///< service/environment/version once per stream header, not per record
+    bool include_logger_name = true;
+    bool include_function = true;
+};
+
+/**
+ * @brief Predefined FormatOptions presets.
+ */
+enum class OutputProfile {
+    Full,     ///< Every field on every record (default)
+    Compact,  ///< Short keys, trimmed function, metadata in a stream header
+    Minimal   ///< Compact without logger_name and function (file and line kept)
+};
+
+/**
+ * @brief Convert output profile to string.
+ */
+constexpr std::string_view to_string(OutputProfile profile) noexcept {
+    switch (profile) {
+        case OutputProfile::Full: return "full";
+        case OutputProfile::Compact: return "compact";
+        case OutputProfile::Minimal: return "minimal";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse output profile from string.
+ */
+inline OutputProfile from_string(std::string_view str, OutputProfile default_profile) noexcept {
+    if (str == "full" || str == "FULL") return OutputProfile::Full;
+    if (str == "compact" || str == "COMPACT") return OutputProfile::Compact;
+    if (str == "minimal" || str == "MINIMAL") return OutputProfile::Minimal;
+    return default_profile;
+}
+
+/**
+ * @brief Build the FormatOptions for a profile.
+ */
+constexpr FormatOptions make_format_options(
+    OutputProfile profile,
+    TimestampFormat timestamp_format = TimestampFormat::Iso8601
+) noexcept {
+    FormatOptions options;
+    options.timestamp_format = timestamp_format;
+    if (profile != OutputProfile::Full) {
+        options.short_keys = true;
+        options.trim_function = true;
+        options.metadata_in_header = true;
+    }
+    if (profile == OutputProfile::Minimal) {
+        options.include_logger_name = false;
+        options.include_function = false;
+    }
+    return options;
+}
+
+/**
+ * @brief Record encoding written by file handlers.
+ */
+enum class FileFormat {
+    Json,  ///< Newline-delimited JSON (format_json)
+    Cbor   ///< Length-delimited CBOR (format_cbor, see CborFormatter)
+};
+
+/**
+ * @brief Convert file format to string.
+ */
+constexpr std::string_view to_string(FileFormat format) noexcept {
+    switch (format) {
+        case FileFormat::Json: return "json";
+        case FileFormat::Cbor: return "cbor";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse file format from string.
+ */
+inline FileFormat from_string(std::string_view str, FileFormat default_format) noexcept {
+    if (str == "json" || str == "JSON") return FileFormat::Json;
+    if (str == "cbor" || str == "CBOR") return FileFormat::Cbor;
+    return default_format;
+}
+
 /**
  * @brief Format log entry as JSON string.
  */
-std::string format_json(const LogEntry& entry);
+std::string format_json(const LogEntry& entry, const FormatOptions& options = {});
+
+/**
+ * @brief Append log entry as JSON to a caller-provided buffer.
+ *
+ * Writes directly into @p out without building an intermediate DOM, so
+ * a reused buffer makes formatting allocation-free in the steady state.
+ */
+void format_json(const LogEntry& entry, std::string& out, const FormatOptions& options = {});
+
+/**
+ * @brief Append the JSON stream header: {"log_header":{"environment":...}}.
+ *
+ * Carries the process-constant fields omitted from records when
+ * FormatOptions::metadata_in_header is set.
+ */
+void format_json_header(const LogEntry& entry, std::string& out, const FormatOptions& options = {});
 
 /**
  * @brief Format log entry as human-readable text.
  */
-std::string format_text(const LogEntry& entry);
+std::string format_text(const LogEntry& entry, const FormatOptions& options = {});
+
+/**
+ * @brief Append log entry as text to a caller-provided buffer.
+ *
+ * Uses the default pattern layout (see pattern.hpp).
+ */
+void format_text(const LogEntry& entry, std::string& out, const FormatOptions& options = {});
+
+/**
+ * @brief Append log entry as a CBOR map to a caller-provided buffer.
+ *
+ * Same field names and structure as format_json(). Context values keep
+ * their native CBOR types; timestamps are text or integers exactly as
+ * in JSON (untagged, so generic decoders need no tag support). Context
+ * key order is unspecified.
+ */
+void format_cbor(const LogEntry& entry, std::string& out, const FormatOptions& options = {});
+
+/**
+ * @brief Format log entry as a CBOR map.
+ */
+std::string format_cbor(const LogEntry& entry, const FormatOptions& options = {});
+
+/**
+ * @brief Append the CBOR stream header (same structure as format_json_header()).
+ */
+void format_cbor_header(const LogEntry& entry, std::string& out, const FormatOptions& options = {});
+
+/**
+ * @brief Serializes a log entry into a complete output record.
+ *
+ * Formatters are stateless after construction and shared between
+ * handlers: Logger formats each entry once per distinct formatter and
+ * hands the same bytes to every handler that uses it.
+ */
+class Formatter {
+public:
+    Formatter() noexcept = default;
+    virtual ~Formatter() noexcept = default;
+
+    Formatter(const Formatter&) = delete;
+    Formatter& operator=(const Formatter&) = delete;
+    Formatter(Formatter&&) = delete;
+    Formatter& operator=(Formatter&&) = delete;
+
+    /**
+     * @brief Append one record, including its terminator, to @p out.
+     */
+    virtual void format(const LogEntry& entry, std::string& out) const = 0;
+
+    /**
+     * @brief Append a header record written once at the start of each
+     *        output stream (file open, rotation, first console write).
+     *
+     * @p entry is the first record of the stream and supplies the
+     * process-constant fields. The default writes nothing.
+     */
+    virtual void format_header(const LogEntry& /*entry*/, std::string& /*out*/) const {}
+};
+
+/**
+ * @brief Newline-delimited JSON formatter (format_json + '\n').
+ */
+class JsonFormatter : public Formatter {
+public:
+    explicit JsonFormatter(FormatOptions options = {}) noexcept
+        : options_(options) {}
+
+    void format(const LogEntry& entry, std::string& out) const override;
+    void format_header(const LogEntry& entry, std::string& out) const override;
+
+    [[nodiscard]] const FormatOptions& options() const noexcept { return options_; }
+
+private:
+    FormatOptions options_;
+};
+
+/**
+ * @brief Length-delimited CBOR formatter.
+ *
+ * Each record is a 4-byte big-endian payload length followed by one
+ * format_cbor() map, so readers can frame records without parsing CBOR.
+ */
+class CborFormatter : public Formatter {
+public:
+    explicit CborFormatter(FormatOptions options = {}) noexcept
+        : options_(options) {}
+
+    void format(const LogEntry& entry, std::string& out) const override;
+    void format_header(const LogEntry& entry, std::string& out) const override;
+
+    [[nodiscard]] const FormatOptions& options() const noexcept { return options_; }
+
+private:
+    FormatOptions options_;
+};
 
 }  // namespace agora::log
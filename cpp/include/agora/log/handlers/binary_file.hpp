@@ -0,0 +1,50 @@
+/**
+ * @file binary_file.hpp
+ * @brief File handler writing the compact binary log format
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include "../binary.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace agora::log {
+
+/**
+ * @brief File handler that writes entries in the binary format (binary.hpp).
+ *
+ * Call-site, logger-name and context-key strings are written once per
+ * session and referenced by id afterwards; timestamps are delta-encoded.
+ * Each open of the file starts a new session, so appending is safe. A
+ * failed write throws and closes the file; the next write reopens it.
+ * Convert back to JSON lines with the agora-log-decode tool.
+ */
+class BinaryFileHandler : public Handler {
+public:
+    explicit BinaryFileHandler(const std::filesystem::path& file_path);
+    ~BinaryFileHandler() noexcept override;
+
+    void write(const LogEntry& entry) override;
+    void flush() noexcept override;
+
+    /** Get the file path */
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_path_; }
+
+private:
+    std::filesystem::path file_path_;
+    std::ofstream file_;
+    std::mutex mutex_;
+    BinaryEncoder encoder_;
+    std::string buffer_;
+
+    void open_file();
+    void close_file() noexcept;
+    /** Throw and close the file if the last write failed. */
+    void check_stream();
+};
+
+}  // namespace agora::log
@@ -0,0 +1,116 @@
+/**
+ * @file buffered_console.hpp
+ * @brief Batched stdout/stderr handler for container log collection
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include "../formatter.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace agora::log {
+
+/**
+ * @brief Console handler that writes whole batches from a background thread.
+ *
+ * Records are appended to a preallocated buffer per stream (ERROR and
+ * CRITICAL go to stderr, everything else to stdout). A writer thread swaps
+ * the buffers and writes each with one write(2). Only that thread writes to
+ * the descriptors, so records from different threads never interleave, and
+ * a slow pipe (e.g. a lagging log agent) stalls the writer thread, not the
+ * application.
+ *
+ * Each stream buffers at most buffer_size bytes. When a stream is full:
+ * - blocking (default): the caller waits until the writer thread swaps
+ *   the buffers, so memory stays bounded;
+ * - drop_when_full: the record is discarded and counted in dropped().
+ *
+ * The descriptors themselves stay blocking (O_NONBLOCK would apply to
+ * every user of the shared stdout), so "full" means the buffer is full.
+ * Records of a batch whose write fails are counted as dropped as well.
+ */
+class BufferedConsoleHandler : public Handler {
+public:
+    /**
+     * @param formatter Record formatter (default: JsonFormatter)
+     * @param buffer_size Bytes buffered per stream (default: 256KB)
+     * @param flush_interval_ms Maximum time a record waits in the buffer
+     * @param drop_when_full Drop records instead of waiting for space
+     * @param stdout_fd Descriptor for records below ERROR
+     * @param stderr_fd Descriptor for ERROR and CRITICAL records
+     */
+    explicit BufferedConsoleHandler(
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        std::size_t buffer_size = 256 * 1024,
+        std::size_t flush_interval_ms = 100,
+        bool drop_when_full = false,
+        int stdout_fd = STDOUT_FILENO,
+        int stderr_fd = STDERR_FILENO
+    );
+
+    ~BufferedConsoleHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Write all buffered records before returning.
+     */
+    void flush() noexcept override;
+
+    /** Get buffer size per stream */
+    [[nodiscard]] std::size_t buffer_size() const noexcept { return buffer_size_; }
+
+    /** Check if records are dropped when a buffer is full */
+    [[nodiscard]] bool drop_when_full() const noexcept { return drop_when_full_; }
+
+    /** Get number of records accepted into a buffer */
+    [[nodiscard]] std::size_t entries_written() const noexcept { return entries_written_.load(); }
+
+    /** Get number of records dropped (full buffer or failed write) */
+    [[nodiscard]] std::size_t dropped() const noexcept { return dropped_.load(); }
+
+    /** Get number of write(2) calls issued */
+    [[nodiscard]] std::size_t write_calls() const noexcept { return write_calls_.load(); }
+
+private:
+    struct Stream {
+        int fd;
+        std::string front;              // Appended to by callers, guarded by mutex_
+        std::string back;               // Written by the writer, guarded by io_mutex_
+        std::size_t front_records = 0;
+        std::size_t back_records = 0;
+    };
+
+    std::size_t buffer_size_;
+    std::size_t flush_interval_ms_;
+    bool drop_when_full_;
+    Stream out_;
+    Stream err_;
+    bool header_pending_ = true;  // Stream header goes to stdout before the first record
+
+    // Synchronization. Lock order: io_mutex_ before mutex_.
+    std::mutex mutex_;
+    std::mutex io_mutex_;
+    std::condition_variable cv_;        // Wakes the writer thread
+    std::condition_variable space_cv_;  // Wakes callers waiting for buffer space
+    bool flush_requested_ = false;
+    bool stop_ = false;
+    std::atomic<std::size_t> entries_written_{0};
+    std::atomic<std::size_t> dropped_{0};
+    std::atomic<std::size_t> write_calls_{0};
+
+    std::thread writer_thread_;
+
+    [[nodiscard]] bool has_room(const Stream& stream, std::size_t size) const noexcept;
+    void write_buffers();
+    void write_batch(Stream& stream) noexcept;
+    void writer_thread_func();
+};
+
+}  // namespace agora::log
@@ -6,8 +6,8 @@
 #pragma once
 
 #include "handler.hpp"
+#include "../formatter.hpp"
 #include <filesystem>
-#include <fstream>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
@@ -20,15 +20,19 @@ namespace agora::log {
 /**
  * @brief High-performance file handler with double buffering.
  *
- * Uses two buffers to minimize write latency:
- * - Front buffer: Accumulates log entries from application threads
- * - Back buffer: Being flushed to disk by background thread
+ * Uses two contiguous byte buffers to minimize write latency:
+ * - Front buffer: Records from application threads are appended here
+ * - Back buffer: Being written to disk by the background thread
  *
- * When front buffer reaches threshold, buffers are swapped and
- * the background thread writes the back buffer to disk.
+ * When the front buffer reaches buffer_size bytes (or flush_interval_ms
+ * elapses), the buffers are swapped and the background thread writes the
+ * back buffer with a single write(2). Both buffers are preallocated, so
+ * appending a record does not allocate.
  *
- * This design allows application threads to continue logging
- * while disk I/O is in progress.
+ * With max_size_bytes > 0 the file is rotated like RotatingFileHandler
+ * (app.log -> app.log.1 ...). Rotation points are decided when records
+ * are appended, so every file still starts with the formatter's header and
+ * never splits a record.
  */
 class BufferedFileHandler : public Handler {
 public:
@@ -38,16 +42,26 @@ public:
      * @param file_path Path to the log file
      * @param buffer_size Size of each buffer in bytes (default: 64KB)
      * @param flush_interval_ms Maximum time before flushing (default: 100ms)
+     * @param formatter Record formatter (default: JsonFormatter)
+     * @param max_size_bytes Rotate when the file would exceed this size (0 = never)
+     * @param max_backup_count Number of rotated backups to keep
      */
     BufferedFileHandler(
         const std::filesystem::path& file_path,
         std::size_t buffer_size = 64 * 1024,
-        std::size_t flush_interval_ms = 100
+        std::size_t flush_interval_ms = 100,
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        std::size_t max_size_bytes = 0,
+        std::size_t max_backup_count = 5
     );
 
     ~BufferedFileHandler() noexcept override;
 
-    void write(const LogEntry& entry) override;
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Write all buffered records before returning.
+     */
     void flush() noexcept override;
 
     /** Get the file path */
@@ -59,31 +73,47 @@ public:
     /** Get number of entries written */
     [[nodiscard]] std::size_t entries_written() const noexcept { return entries_written_.load(); }
 
+    /** Get number of write(2) calls issued for buffer flushes */
+    [[nodiscard]] std::size_t write_calls() const noexcept { return write_calls_.load(); }
+
+    /** Check if rotation is disabled due to errors */
+    [[nodiscard]] bool rotation_disabled() const noexcept { return rotation_disabled_.load(); }
+
 private:
     std::filesystem::path file_path_;
-    std::ofstream file_;
+    int fd_ = -1;
     std::size_t buffer_size_;
     std::size_t flush_interval_ms_;
+    std::size_t max_size_bytes_;
+    std::size_t max_backup_count_;
 
-    // Double buffer
-    std::vector<std::string> front_buffer_;
-    std::vector<std::string> back_buffer_;
-    std::size_t front_buffer_bytes_ = 0;
+    // Double buffer; *_rotations_ hold offsets at which to rotate before
+    // writing the rest of the buffer
+    std::string front_buffer_;
+    std::string back_buffer_;
+    std::vector<std::size_t> front_rotations_;
+    std::vector<std::size_t> back_rotations_;
+    std::size_t file_size_ = 0;  // Bytes written plus bytes buffered for the current file
+    bool header_pending_ = true;
 
-    // Synchronization
-    mutable std::mutex mutex_;
+    // Synchronization. Lock order: io_mutex_ before mutex_.
+    mutable std::mutex mutex_;     // Front buffer
+    std::mutex io_mutex_;          // Back buffer and fd_
     std::condition_variable cv_;
     std::atomic<bool> stop_{false};
     std::atomic<bool> flush_requested_{false};
+    std::atomic<bool> rotation_disabled_{false};
     std::atomic<std::size_t> entries_written_{0};
+    std::atomic<std::size_t> write_calls_{0};
 
     // Background flush thread
     std::thread flush_thread_;
 
     void open_file();
     void close_file() noexcept;
-    void swap_buffers();
-    void flush_back_buffer();
+    void rotate();
+    void write_buffers();
+    void write_all(const char* data, std::size_t size);
     void flush_thread_func();
 };
 
@@ -6,21 +6,39 @@
 #pragma once
 
 #include "handler.hpp"
+#include "../formatter.hpp"
+#include "../pattern.hpp"
 #include <iostream>
+#include <mutex>
 
 namespace agora::log {
 
 /**
  * @brief Console handler that writes to stdout/stderr.
+ *
+ * Each record is written and flushed under a lock, so lines from
+ * different threads do not interleave. For high volumes see
+ * BufferedConsoleHandler.
  */
 class ConsoleHandler : public Handler {
 public:
     /**
      * @param json_format If true, output JSON; otherwise text format
+     * @param options Formatter options (timestamp format)
+     * @param text_pattern Layout used when json_format is false
      */
-    explicit ConsoleHandler(bool json_format = true) noexcept;
+    explicit ConsoleHandler(
+        bool json_format = true,
+        FormatOptions options = {},
+        std::string_view text_pattern = kDefaultTextPattern
+    );
 
-    void write(const LogEntry& entry) override;
+    /**
+     * @param formatter Shared formatter (e.g. the file handler's JsonFormatter)
+     */
+    explicit ConsoleHandler(std::shared_ptr<const Formatter> formatter) noexcept;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
     void flush() noexcept override;
 
     /** Check if JSON format is enabled */
@@ -28,6 +46,8 @@ public:
 
 private:
     bool json_format_;
+    std::once_flag header_once_;  // Stream header goes to stdout before the first record
+    std::mutex mutex_;
 };
 
 }  // namespace agora::log
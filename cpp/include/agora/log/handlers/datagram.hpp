@@ -0,0 +1,139 @@
+/**
+ * @file datagram.hpp
+ * @brief Batched sender for local Unix datagram log daemons
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/un.h>
+
+namespace agora::log {
+
+/**
+ * @brief Syslog severity (RFC 5424 section 6.2.1) for a level.
+ */
+constexpr int syslog_severity(Level level) noexcept {
+    switch (level) {
+        case Level::Debug: return 7;     // debug
+        case Level::Info: return 6;      // informational
+        case Level::Warning: return 4;   // warning
+        case Level::Error: return 3;     // error
+        case Level::Critical: return 2;  // critical
+    }
+    return 6;
+}
+
+/**
+ * @brief Base for handlers that send one datagram per record to a local
+ *        AF_UNIX socket (journald, syslog).
+ *
+ * Each formatted record is one datagram. Records are queued in a
+ * contiguous buffer and a sender thread transmits them with sendmmsg(2),
+ * up to 64 per call. The socket is non-blocking and callers never wait:
+ * when the daemon falls behind, the sender thread waits for the socket
+ * and the queue fills; records that do not fit into buffer_size bytes
+ * are dropped and counted. Datagrams the socket rejects as too large
+ * are passed to send_oversized().
+ *
+ * The socket is connected so that poll(2) reports the daemon's queue,
+ * and is reconnected when the daemon restarts (a missing daemon at
+ * construction is not an error). Send failures are reported to stderr
+ * once per failure streak; those records count as dropped.
+ */
+class DatagramHandler : public Handler {
+public:
+    ~DatagramHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Send all queued records before returning.
+     */
+    void flush() noexcept override;
+
+    /** Get the daemon socket path */
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return socket_path_; }
+
+    /** Get number of records delivered to the socket */
+    [[nodiscard]] std::size_t entries_sent() const noexcept { return entries_sent_.load(); }
+
+    /** Get number of records dropped (queue full or send failure) */
+    [[nodiscard]] std::size_t dropped() const noexcept { return dropped_.load(); }
+
+    /** Get number of sendmmsg(2) calls issued */
+    [[nodiscard]] std::size_t send_calls() const noexcept { return send_calls_.load(); }
+
+protected:
+    /**
+     * @param formatter Record formatter (one record = one datagram)
+     * @param socket_path Daemon socket, e.g. /dev/log
+     * @param buffer_size Bytes of records queued before dropping
+     * @param flush_interval_ms Maximum time a record waits in the queue
+     */
+    DatagramHandler(
+        std::shared_ptr<const Formatter> formatter,
+        const std::filesystem::path& socket_path,
+        std::size_t buffer_size,
+        std::size_t flush_interval_ms
+    );
+
+    /**
+     * @brief Deliver a datagram the socket rejected with EMSGSIZE.
+     *
+     * Called on the sender thread. Returns false to drop the record (the
+     * default).
+     */
+    virtual bool send_oversized(std::string_view datagram) noexcept;
+
+    /**
+     * @brief Send what is queued and stop the sender thread.
+     *
+     * Derived classes overriding send_oversized() call this from their
+     * destructor, before their part of the object is gone.
+     */
+    void stop() noexcept;
+
+    int fd_ = -1;  // Connected to the daemon socket
+
+private:
+    sockaddr_un address_{};
+    socklen_t address_size_ = 0;
+    std::filesystem::path socket_path_;
+    std::size_t buffer_size_;
+    std::size_t flush_interval_ms_;
+
+    // Double buffer of records; *_ends_ hold the end offset of each record
+    std::string front_;
+    std::string back_;
+    std::vector<std::size_t> front_ends_;
+    std::vector<std::size_t> back_ends_;
+
+    // Synchronization. Lock order: io_mutex_ before mutex_.
+    std::mutex mutex_;     // Front buffer
+    std::mutex io_mutex_;  // Back buffer and sends
+    std::condition_variable cv_;
+    bool flush_requested_ = false;
+    std::atomic<bool> stop_{false};
+    bool error_reported_ = false;  // Guarded by io_mutex_
+    std::atomic<std::size_t> entries_sent_{0};
+    std::atomic<std::size_t> dropped_{0};
+    std::atomic<std::size_t> send_calls_{0};
+
+    std::thread sender_thread_;
+
+    bool connect_socket() noexcept;
+    void send_buffers();
+    void send_batch();
+    void report_error(int error) noexcept;
+    void sender_thread_func();
+};
+
+}  // namespace agora::log
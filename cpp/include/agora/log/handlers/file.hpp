@@ -6,6 +6,10 @@
 #pragma once
 
 #include "handler.hpp"
+#include "segment_file.hpp"
+#include "../formatter.hpp"
+#include "../spill.hpp"
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
@@ -13,26 +17,103 @@
 namespace agora::log {
 
 /**
- * @brief File handler that writes JSON logs to a file.
+ * @brief File handler that writes formatted records (JSON by default) to a file.
+ *
+ * By default records are appended through std::ofstream. With
+ * SegmentOptions::preallocate_bytes or direct_io set, the file is written
+ * through a SegmentFile instead (preallocated, block-aligned).
+ *
+ * A failed or slow write switches the handler to degraded mode (see
+ * SpillOptions): records are kept in a SpillBuffer, and the disk is only
+ * touched again, reopening the file if needed, when the retry backoff
+ * expires. The first successful retry replays the spilled records in
+ * order. disk_stats() reports the transitions and what was shed.
  */
 class FileHandler : public Handler {
 public:
-    explicit FileHandler(const std::filesystem::path& file_path);
+    /**
+     * @param file_path Path to the log file
+     * @param formatter Record formatter (default: JsonFormatter)
+     * @param segment On-disk layout (default: plain append)
+     * @param spill Degraded-mode behaviour on disk errors and stalls
+     */
+    explicit FileHandler(
+        const std::filesystem::path& file_path,
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        SegmentOptions segment = {},
+        SpillOptions spill = {}
+    );
     ~FileHandler() noexcept override;
 
-    void write(const LogEntry& entry) override;
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
     void flush() noexcept override;
 
     /** Get the file path */
     [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_path_; }
 
+    /** Get degradation, spill and shedding counters */
+    [[nodiscard]] DiskStats disk_stats() const;
+
 protected:
     std::filesystem::path file_path_;
     std::ofstream file_;
-    std::mutex mutex_;
+    SegmentFile segment_;           // Used instead of file_ when segment_options_ is set
+    SegmentOptions segment_options_;
+    mutable std::mutex mutex_;
+    bool header_pending_ = true;  // Set by open_file(); cleared by write_header()
+
+    // Degraded mode, guarded by mutex_
+    SpillOptions spill_options_;
+    SpillBuffer spill_;
+    DiskStats disk_stats_;
+    std::chrono::milliseconds retry_delay_{0};
+    std::chrono::nanoseconds retry_at_{0};  // Coarse monotonic time of the next disk retry
+
+    [[nodiscard]] bool use_segment() const noexcept {
+        return segment_options_.preallocate_bytes > 0 || segment_options_.direct_io;
+    }
+    [[nodiscard]] bool is_open() const noexcept {
+        return use_segment() ? segment_.is_open() : file_.is_open();
+    }
 
     void open_file();
     void close_file() noexcept;
+
+    /**
+     * @brief File open_file() opens: file_path_ unless a subclass writes
+     *        elsewhere for a while (a rotation in progress). Caller must
+     *        hold mutex_.
+     */
+    [[nodiscard]] virtual std::filesystem::path live_path() const { return file_path_; }
+    void write_bytes(std::string_view bytes);
+
+    /**
+     * @brief Write @p record (and a pending header) unless the disk is
+     *        degraded; spill it otherwise.
+     *
+     * Caller must hold mutex_. Returns the bytes that reached the file,
+     * including spilled records replayed by a successful retry.
+     */
+    std::size_t write_guarded(const LogEntry& entry, std::string_view record);
+
+    /**
+     * @brief Flush the open file; a failure degrades the handler like a
+     *        failed write. Caller must hold mutex_.
+     */
+    void flush_file() noexcept;
+
+    /**
+     * @brief Write the formatter's stream header if the file was just opened.
+     *
+     * Caller must hold mutex_. Returns the number of bytes written.
+     */
+    std::size_t write_header(const LogEntry& entry);
+
+private:
+    void check_stream();
+    void degrade(const char* reason);
+    void spill(Level level, std::string_view record);
+    bool retry_disk(const LogEntry* entry, std::size_t& written);
 };
 
 }  // namespace agora::log
@@ -6,15 +6,27 @@
 #pragma once
 
 #include "../entry.hpp"
+#include "../formatter.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace agora::log {
 
 /**
  * @brief Abstract base class for log handlers.
+ *
+ * A handler pairs a Formatter (entry -> bytes) with a sink
+ * (write_formatted: bytes -> destination). Logger formats each entry once
+ * per distinct formatter instance and passes the shared bytes to every
+ * handler using it, so handlers that should share output must share the
+ * same Formatter object. Handlers without a formatter override write().
  */
 class Handler {
 public:
-    Handler() noexcept = default;
+    explicit Handler(std::shared_ptr<const Formatter> formatter = nullptr) noexcept
+        : formatter_(std::move(formatter)) {}
     virtual ~Handler() noexcept = default;
 
     // Non-copyable, non-movable (polymorphic base class)
@@ -25,13 +37,57 @@ public:
 
     /**
      * @brief Write a log entry.
+     *
+     * Default implementation formats with formatter() into a per-thread
+     * buffer and forwards to write_formatted().
      */
-    virtual void write(const LogEntry& entry) = 0;
+    virtual void write(const LogEntry& entry) {
+        if (!formatter_) {
+            return;
+        }
+        thread_local std::string record;
+        record.clear();
+        formatter_->format(entry, record);
+        write_formatted(entry, record);
+    }
+
+    /**
+     * @brief Write an already formatted record.
+     *
+     * @p record is only valid for the duration of the call; sinks that
+     * keep the bytes must copy them.
+     */
+    virtual void write_formatted(const LogEntry& entry, std::string_view record) {
+        (void)entry;
+        (void)record;
+    }
 
     /**
      * @brief Flush any buffered entries.
      */
     virtual void flush() noexcept = 0;
+
+    /**
+     * @brief Whether the handler commits records to stable storage and
+     *        completes LogEntry::commit (see DurableFileHandler).
+     */
+    [[nodiscard]] virtual bool durable() const noexcept { return false; }
+
+    /** Get the formatter (nullptr if the handler formats itself) */
+    [[nodiscard]] const Formatter* formatter() const noexcept { return formatter_.get(); }
+
+protected:
+    std::shared_ptr<const Formatter> formatter_;
 };
 
+/**
+ * @brief Write an entry to @p handlers, formatting it once per distinct
+ *        formatter.
+ *
+ * The logger's synchronous path (SinkExecutor is the parallel one).
+ * Handler exceptions are ignored; a durable handler that throws fails the
+ * entry's commit token.
+ */
+void dispatch(const std::vector<std::shared_ptr<Handler>>& handlers, const LogEntry& entry);
+
 }  // namespace agora::log
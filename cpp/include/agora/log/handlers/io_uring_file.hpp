@@ -0,0 +1,205 @@
+/**
+ * @file io_uring_file.hpp
+ * @brief File handler that submits buffer writes through io_uring (Linux)
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include "../formatter.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace agora::log {
+
+/**
+ * @brief Check whether io_uring can be set up in this process.
+ *
+ * False on non-Linux builds, on kernels without io_uring and where it is
+ * disabled (seccomp, io_uring_disabled sysctl). The result is cached.
+ */
+[[nodiscard]] bool io_uring_available() noexcept;
+
+/**
+ * @brief Buffered file handler that keeps several writes in flight via io_uring.
+ *
+ * Records are appended to one of queue_depth preallocated buffers that are
+ * registered with the ring (IORING_OP_WRITE_FIXED). A full buffer, or the
+ * current one after flush_interval_ms, is handed to a writer thread that
+ * submits it at an explicit file offset and moves on without waiting, so
+ * up to queue_depth buffers are written concurrently. Application threads
+ * only wait when every buffer is still in flight.
+ *
+ * With sync, each write is followed by a linked IORING_OP_FSYNC
+ * (datasync), so a buffer is reported complete only once it is durable.
+ *
+ * If io_uring_enter fails for good, the writer switches to pwrite (and
+ * fdatasync with sync) for the rest of the handler's life.
+ *
+ * Rotation follows BufferedFileHandler: rotation points are recorded on
+ * append, and the writer drains in-flight writes before rotating the file.
+ *
+ * The constructor throws std::system_error when io_uring is unavailable;
+ * use make_io_uring_file_handler() to fall back to BufferedFileHandler.
+ */
+class IoUringFileHandler : public Handler {
+public:
+    /**
+     * @param file_path Path to the log file
+     * @param buffer_size Size of each buffer in bytes
+     * @param queue_depth Number of buffers (maximum writes in flight + 1)
+     * @param flush_interval_ms Maximum time before a partial buffer is written
+     * @param formatter Record formatter (default: JsonFormatter)
+     * @param sync Link an fdatasync to every write
+     * @param max_size_bytes Rotate when the file would exceed this size (0 = never)
+     * @param max_backup_count Number of rotated backups to keep
+     */
+    IoUringFileHandler(
+        const std::filesystem::path& file_path,
+        std::size_t buffer_size = 256 * 1024,
+        std::size_t queue_depth = 4,
+        std::size_t flush_interval_ms = 100,
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        bool sync = false,
+        std::size_t max_size_bytes = 0,
+        std::size_t max_backup_count = 5
+    );
+
+    ~IoUringFileHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Wait until all records appended so far have completed.
+     */
+    void flush() noexcept override;
+
+    /** Get the file path */
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_path_; }
+
+    /** Get buffer size */
+    [[nodiscard]] std::size_t buffer_size() const noexcept { return buffer_size_; }
+
+    /** Get number of buffers */
+    [[nodiscard]] std::size_t queue_depth() const noexcept { return slots_.size(); }
+
+    /** Check whether the buffers are registered with the ring */
+    [[nodiscard]] bool registered_buffers() const noexcept;
+
+    /** Get number of entries written */
+    [[nodiscard]] std::size_t entries_written() const noexcept { return entries_written_.load(); }
+
+    /** Get number of write operations submitted */
+    [[nodiscard]] std::size_t writes_submitted() const noexcept { return writes_submitted_.load(); }
+
+    /** Get number of failed write or fsync operations */
+    [[nodiscard]] std::size_t write_errors() const noexcept { return write_errors_.load(); }
+
+private:
+    class Ring;
+
+    struct Slot {
+        std::size_t used = 0;        // Bytes appended (application side)
+        std::uint64_t end = 0;       // Stream position after this buffer (writer side)
+        std::uint32_t pending = 0;   // Outstanding ring operations (writer side)
+    };
+
+    struct Op {
+        std::uint32_t slot = 0;
+        std::uint32_t offset = 0;    // Offset in the slot's buffer
+        std::uint32_t length = 0;
+        std::uint64_t file_offset = 0;
+        bool fsync = false;
+    };
+
+    std::filesystem::path file_path_;
+    std::size_t buffer_size_;
+    std::size_t flush_interval_ms_;
+    bool sync_;
+    std::size_t max_size_bytes_;
+    std::size_t max_backup_count_;
+
+    std::unique_ptr<char, void (*)(void*)> memory_{nullptr, nullptr};
+    std::unique_ptr<Ring> ring_;  // Declared after memory_: unregisters before it is freed
+    std::vector<Slot> slots_;
+
+    // Application side, guarded by mutex_
+    std::mutex append_mutex_;            // Serializes producers (held across buffer waits)
+    std::mutex mutex_;
+    std::condition_variable cv_;         // Wakes the writer thread
+    std::condition_variable space_cv_;   // Signals free buffers and completed writes
+    int current_ = -1;
+    std::vector<std::uint32_t> free_;
+    std::vector<std::uint32_t> ready_;
+    std::vector<std::uint64_t> rotations_;  // Stream positions where a new file starts
+    std::uint64_t appended_ = 0;            // Stream bytes appended
+    std::uint64_t completed_ = 0;           // Stream bytes whose writes completed
+    std::size_t file_size_ = 0;
+    std::size_t waiters_ = 0;
+    bool header_pending_ = true;
+    bool flush_requested_ = false;
+    bool stop_ = false;
+
+    // Writer thread only
+    int fd_ = -1;
+    std::uint64_t file_offset_ = 0;
+    std::uint64_t submitted_ = 0;
+    std::deque<std::uint32_t> in_flight_;
+    std::deque<std::uint64_t> pending_rotations_;
+    std::vector<Op> ops_;
+    std::vector<std::uint32_t> free_ops_;
+    std::size_t ops_in_flight_ = 0;
+    std::size_t queued_ = 0;
+    bool ring_failed_ = false;  // io_uring_enter failed: pwrite from now on
+
+    std::atomic<std::size_t> entries_written_{0};
+    std::atomic<std::size_t> writes_submitted_{0};
+    std::atomic<std::size_t> write_errors_{0};
+
+    std::thread writer_thread_;
+
+    void append(std::string_view data, std::unique_lock<std::mutex>& lock);
+    void open_file();
+    void close_file() noexcept;
+    void rotate();
+    void submit(std::uint32_t slot);
+    void queue_write(std::uint32_t slot, std::size_t offset, std::size_t length);
+    enum class Wait { None, Buffer, All };
+
+    void reap(Wait wait);
+    void enter_ring(unsigned min_complete);
+    void fail_ring(int error);
+    void complete_sync(const Op& op);
+    std::size_t process_completions();
+    std::size_t release_buffers();
+    void complete(const Op& op, std::int32_t result);
+    void writer_thread_func();
+};
+
+/**
+ * @brief Create an IoUringFileHandler, or a BufferedFileHandler if io_uring
+ * is unavailable.
+ *
+ * The fallback writes with write(2) from a background thread and does not
+ * fsync.
+ */
+[[nodiscard]] std::shared_ptr<Handler> make_io_uring_file_handler(
+    const std::filesystem::path& file_path,
+    std::size_t buffer_size = 256 * 1024,
+    std::size_t queue_depth = 4,
+    std::size_t flush_interval_ms = 100,
+    std::shared_ptr<const Formatter> formatter = nullptr,
+    bool sync = false,
+    std::size_t max_size_bytes = 0,
+    std::size_t max_backup_count = 5
+);
+
+}  // namespace agora::log
@@ -0,0 +1,52 @@
+/**
+ * @file journald.hpp
+ * @brief systemd-journald native protocol handler
+ */
+
+#pragma once
+
+#include "datagram.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Formats an entry as a journald native protocol datagram.
+ *
+ * One field per line: `KEY=value`, or for values containing a newline
+ * `KEY`, newline, 64-bit little-endian length, value, newline. Fields:
+ * MESSAGE, PRIORITY (syslog severity), SYSLOG_IDENTIFIER (service name),
+ * LOGGER, CODE_FILE, CODE_LINE, CODE_FUNC, plus ENVIRONMENT,
+ * SERVICE_VERSION, EXCEPTION_TYPE, EXCEPTION_MESSAGE and DURATION_MS when
+ * set. Context keys become fields of their own, upper-cased with other
+ * characters replaced by '_' (journald only accepts [A-Z0-9_], 64 chars);
+ * a name that starts with a digit or equals one of the fields above gets a
+ * CTX_ prefix.
+ */
+class JournaldFormatter : public Formatter {
+public:
+    void format(const LogEntry& entry, std::string& out) const override;
+};
+
+/**
+ * @brief Sends records to journald over its native datagram socket.
+ *
+ * Records too large for a datagram are written to a sealed memfd whose
+ * descriptor is sent instead, as sd_journal_send() does.
+ */
+class JournaldHandler : public DatagramHandler {
+public:
+    static constexpr const char* kDefaultSocket = "/run/systemd/journal/socket";
+
+    explicit JournaldHandler(
+        const std::filesystem::path& socket_path = kDefaultSocket,
+        std::size_t buffer_size = 1024 * 1024,
+        std::size_t flush_interval_ms = 20
+    );
+
+    ~JournaldHandler() noexcept override;
+
+protected:
+    bool send_oversized(std::string_view datagram) noexcept override;
+};
+
+}  // namespace agora::log
@@ -0,0 +1,127 @@
+/**
+ * @file mmap_file.hpp
+ * @brief Memory-mapped append handler with lock-free space reservation (Linux)
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include "../formatter.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+
+namespace agora::log {
+
+/**
+ * @brief File handler that copies records straight into a mapped segment.
+ *
+ * Each log file is a preallocated segment of segment_size bytes mapped
+ * with MAP_SHARED. A producer reserves space with one fetch_add on the
+ * segment's write offset and memcpy's its record into the mapping: no
+ * lock and no syscall per record. The first reservation that does not fit
+ * seals the segment; that producer (or whichever one gets the roll mutex
+ * first) maps a fresh segment as `<file_path>.next`, then rotates the file
+ * like RotatingFileHandler and renames the new segment in. It starts with
+ * the formatter header; the old one is retired once its in-progress copies
+ * finish, truncated to the bytes used. If the new segment cannot be
+ * allocated (e.g. ENOSPC), nothing is rotated and the record throws; the
+ * next record tries again. If the rotation itself fails, rotation stops and
+ * every later segment continues the live file right after its data.
+ *
+ * flush() runs msync(MS_SYNC) on the used part of the current segment.
+ *
+ * Crash behaviour: the kernel keeps every byte copied into the mapping.
+ * Because producers copy concurrently, the file may end with a torn record
+ * or contain NUL-filled gaps where a reservation was not copied yet, plus
+ * NUL bytes up to the preallocated size. Readers skip NUL bytes and a
+ * trailing record without its terminator (for JSON, a line without '\n').
+ * On open, a non-empty file from an earlier run is cut at its trailing
+ * NUL bytes and rotated to a backup; new records start a fresh segment.
+ */
+class MmapFileHandler : public Handler {
+public:
+    /**
+     * @param file_path Path to the log file
+     * @param segment_size Size of each mapped segment (rotation size)
+     * @param max_backup_count Number of rotated backups to keep
+     * @param formatter Record formatter (default: JsonFormatter)
+     */
+    MmapFileHandler(
+        const std::filesystem::path& file_path,
+        std::size_t segment_size = 64 * 1024 * 1024,
+        std::size_t max_backup_count = 5,
+        std::shared_ptr<const Formatter> formatter = nullptr
+    );
+
+    ~MmapFileHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief msync the used part of the current segment.
+     */
+    void flush() noexcept override;
+
+    /** Get the file path */
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_path_; }
+
+    /** Get the segment (rotation) size */
+    [[nodiscard]] std::size_t segment_size() const noexcept { return segment_size_; }
+
+    /** Get number of entries written */
+    [[nodiscard]] std::size_t entries_written() const noexcept { return entries_written_.load(); }
+
+    /** Get number of segments mapped so far */
+    [[nodiscard]] std::size_t segments_mapped() const noexcept { return segments_mapped_.load(); }
+
+private:
+    struct Segment {
+        int fd = -1;
+        char* data = nullptr;
+        std::size_t capacity = 0;
+        std::uint64_t sequence = 0;                    // Identifies the segment across reuse of its address
+        std::atomic<std::uint64_t> reserved{0};        // Next free offset (may run past capacity)
+        std::atomic<std::uint64_t> end{UINT64_MAX};    // Offset of the first reservation that did not fit
+        bool continued = false;                        // The next segment maps the same file
+    };
+
+    std::filesystem::path file_path_;
+    std::size_t segment_size_;
+    std::size_t max_backup_count_;
+
+    std::atomic<Segment*> current_{nullptr};
+
+    // A producer pins the segments of the current epoch before loading
+    // current_; a roller bumps the epoch and waits for the previous epoch's
+    // pins to drain before unmapping the old segment
+    std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<std::uint32_t> pins_[2] = {};
+
+    std::mutex roll_mutex_;
+    std::uint64_t next_sequence_ = 1;  // Guarded by roll_mutex_
+    bool rotation_failed_ = false;     // Guarded by roll_mutex_; segments then grow app.log
+    std::atomic<std::size_t> entries_written_{0};
+    std::atomic<std::size_t> segments_mapped_{0};
+
+    /** Pin the current segment, or return nullptr (unpinned) if there is none. */
+    Segment* pin(std::size_t& slot) noexcept;
+    void unpin(std::size_t slot) noexcept { pins_[slot].fetch_sub(1, std::memory_order_release); }
+
+    /** Replace segment @p full (0 at start) with a new segment beginning with a header. */
+    void roll(std::uint64_t full, const LogEntry& entry, std::size_t min_capacity);
+
+    /** Bump the epoch and wait until no producer still holds the old one's segment. */
+    void quiesce() noexcept;
+
+    /** Map the next segment; @p full is the segment it replaces, quiesced (nullptr at start). */
+    Segment* map_segment(std::size_t min_capacity, bool rotate_first, Segment* full = nullptr);
+    /** Allocate and map @p fd (closed on failure) to @p capacity, data ending at @p size. */
+    static Segment* map_file(int fd, const std::filesystem::path& path, std::uint64_t size, std::size_t capacity);
+    /** Bytes of @p segment holding data */
+    static std::uint64_t used_bytes(const Segment& segment) noexcept;
+    static void retire(Segment* segment) noexcept;
+};
+
+}  // namespace agora::log
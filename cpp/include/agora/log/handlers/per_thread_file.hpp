@@ -0,0 +1,96 @@
+/**
+ * @file per_thread_file.hpp
+ * @brief File handler with one unshared segment file per logging thread
+ */
+
+#pragma once
+
+#include "handler.hpp"
+#include "../formatter.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace agora::log {
+
+/**
+ * @brief File handler where every thread appends to its own segment.
+ *
+ * The first record of a thread creates a segment next to the base path
+ * (`app.log.t0`, `app.log.t1`, ..., see thread_segment.hpp) and caches it
+ * in a thread-local slot. Later records of that thread are framed with
+ * their timestamp and appended to the segment's private buffer, which is
+ * written with one write(2) when it fills: threads share no lock, file
+ * offset or counter on the hot path. Each segment has a mutex of its own,
+ * only ever contended by flush() and the flush thread.
+ *
+ * Ordering comes from the timestamps alone, so no global sequence counter
+ * is needed; they are clamped to never decrease within a segment (clock
+ * steps), which lets SegmentMerger or agora-log-merge rebuild one ordered
+ * stream with a streaming k-way merge.
+ *
+ * A segment whose thread exits is reused by the next new thread. Segments
+ * of an earlier run are never appended to (new files get the next free
+ * index), so a torn tail only ever ends a file. Segments are not rotated.
+ */
+class PerThreadFileHandler : public Handler {
+public:
+    /**
+     * @param base_path Path the segment names are derived from
+     * @param formatter Record formatter (default: JsonFormatter)
+     * @param buffer_size Bytes buffered per thread before a write
+     * @param flush_interval_ms Max time a record stays buffered (0 = until full or flush())
+     */
+    explicit PerThreadFileHandler(
+        const std::filesystem::path& base_path,
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        std::size_t buffer_size = 64 * 1024,
+        std::size_t flush_interval_ms = 100
+    );
+
+    ~PerThreadFileHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Write the buffered records of every segment.
+     */
+    void flush() noexcept override;
+
+    /** Get the base path */
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return base_path_; }
+
+    /** Get the segment files created so far, in creation order */
+    [[nodiscard]] std::vector<std::filesystem::path> segment_paths() const;
+
+    /** Get number of entries written over all segments */
+    [[nodiscard]] std::size_t entries_written() const;
+
+private:
+    struct Segment;
+    struct Registry;
+    struct ThreadCache;
+
+    std::filesystem::path base_path_;
+    std::size_t buffer_size_;
+    std::size_t flush_interval_ms_;
+    std::uint64_t id_;                    // Key of this handler in the thread-local caches
+    std::shared_ptr<Registry> registry_;  // Shared with the caches of threads that wrote
+
+    // Periodic flush
+    std::thread flush_thread_;
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    bool stop_ = false;
+
+    /** The calling thread's segment, created or reused on its first record. */
+    Segment& local_segment();
+    Segment* acquire_segment();
+    void flush_thread_func();
+};
+
+}  // namespace agora::log
@@ -6,28 +6,188 @@
 #pragma once
 
 #include "file.hpp"
+#include "../compress.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <thread>
 
 namespace agora::log {
 
 /**
- * @brief File handler with automatic size-based rotation.
+ * @brief Shift numbered backups of @p file_path up by one.
  *
- * When file exceeds max_size_bytes:
- * - Close current file
- * - Rotate backups: app.log -> app.log.1, app.log.1 -> app.log.2, etc.
- * - Delete oldest backup if exceeds max_backup_count
- * - Open new file
+ * Deletes `<file_path>.<max_backup_count>`, renames `.N` to `.N+1` and
+ * finally moves @p file_path to `.1`. Compressed backups (`.N.gz`,
+ * `.N.zst`) are shifted the same way. The caller closes the file first and
+ * reopens it afterwards. Throws std::filesystem::filesystem_error.
+ */
+void rotate_backups(const std::filesystem::path& file_path, std::size_t max_backup_count);
+
+/**
+ * @brief Time-based rotation period (UTC boundaries).
+ */
+enum class RotationInterval {
+    None,    ///< Size-based rotation only
+    Hourly,  ///< New file at every full hour
+    Daily    ///< New file at midnight UTC
+};
+
+/**
+ * @brief Convert rotation interval to string.
+ */
+constexpr std::string_view to_string(RotationInterval interval) noexcept {
+    switch (interval) {
+        case RotationInterval::None: return "none";
+        case RotationInterval::Hourly: return "hourly";
+        case RotationInterval::Daily: return "daily";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse rotation interval from string.
+ */
+inline RotationInterval from_string(std::string_view str, RotationInterval default_interval) noexcept {
+    if (str == "none" || str == "NONE") return RotationInterval::None;
+    if (str == "hourly" || str == "HOURLY") return RotationInterval::Hourly;
+    if (str == "daily" || str == "DAILY") return RotationInterval::Daily;
+    return default_interval;
+}
+
+/**
+ * @brief How rotated files are named.
+ */
+enum class BackupNaming {
+    Cascade,  ///< app.log.1 is the newest; every rotation renames the whole chain
+    Sequence  ///< app.log.000042 never moves; app.log is a symlink to the newest
+};
+
+/**
+ * @brief Convert backup naming to string.
+ */
+constexpr std::string_view to_string(BackupNaming naming) noexcept {
+    switch (naming) {
+        case BackupNaming::Cascade: return "cascade";
+        case BackupNaming::Sequence: return "sequence";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse backup naming from string.
+ */
+inline BackupNaming from_string(std::string_view str, BackupNaming default_naming) noexcept {
+    if (str == "cascade" || str == "CASCADE") return BackupNaming::Cascade;
+    if (str == "sequence" || str == "SEQUENCE") return BackupNaming::Sequence;
+    return default_naming;
+}
+
+/**
+ * @brief Retention limits across all backups of a rotating file.
+ *
+ * They apply on top of max_backup_count: backups are deleted, oldest
+ * first, while together they exceed max_total_bytes (on-disk size, so
+ * compressed backups count compressed) and once their last record is older
+ * than max_age. The file being written and the prepared next segment are
+ * never backups, so they are never deleted.
+ */
+struct RetentionOptions {
+    std::uint64_t max_total_bytes = 0;            // 0 = no size limit
+    std::chrono::seconds max_age{0};              // 0 = no age limit
+    std::chrono::seconds rescan_interval{300};    // Re-list the directory for outside changes; 0 = never
+};
+
+/**
+ * @brief File handler with automatic size- and/or time-based rotation.
+ *
+ * Rotation does not block writers on the filesystem. A background thread
+ * keeps the next segment open (and preallocated) as `<file_path>.next`.
+ * When file exceeds max_size_bytes, the writer swaps that file in under
+ * the mutex and hands the full one back to the thread, which:
+ * - Closes the full file
+ * - Rotates backups: app.log -> app.log.1, app.log.1 -> app.log.2, etc.
+ * - Deletes the oldest backup if it exceeds max_backup_count
+ * - Renames app.log.next -> app.log and prepares the next segment
+ *
+ * Writers only wait when they fill a segment before the previous
+ * rotation has finished. A `.next` file left with data by a crash is
+ * rotated in on startup.
+ *
+ * A failed step (preparing `.next`, moving backups, the final rename) is
+ * retried with a backoff of 1 s doubling up to 60 s; writers keep writing
+ * and do not rotate meanwhile. If the full file was still app.log, the
+ * records already written to `.next` are appended back to it and writing
+ * continues there, so app.log stays the live file. Rotation is disabled
+ * only if that reopen fails too.
+ *
+ * With a RotationInterval, the file also rotates when an entry's timestamp
+ * reaches the next hour/day boundary (UTC). The boundary is kept as one
+ * integer (nanoseconds since the epoch), so the per-write check is a
+ * single comparison with no clock or filesystem calls. Rotated files are
+ * then named after the period they cover instead of being numbered:
+ * app.log.2024-01-15T13 (hourly) or app.log.2024-01-15 (daily), with
+ * .1, .2, ... appended when size rotation splits a period. The oldest
+ * beyond max_backup_count are deleted. max_size_bytes = 0 disables size
+ * rotation (time only); both set gives hybrid rotation.
+ *
+ * BackupNaming::Sequence makes rotation O(1) in max_backup_count: records
+ * go to numbered segments (app.log.000001, app.log.000002, ...) that are
+ * never renamed, and app.log is a symlink to the newest one, so tailers
+ * keep a stable name. The next segment is prepared under its final name;
+ * rotation repoints the symlink (one rename) and the rotator deletes the
+ * segment that fell out of max_backup_count. Time boundaries still rotate
+ * but do not change the names. Existing segments are picked up on start;
+ * a plain app.log becomes the newest segment.
+ *
+ * With compress, each backup is compressed (app.log.N.zst with zstd, .gz
+ * with zlib; whichever the build found, see default_compression()) by a
+ * second thread at the lowest CPU priority. Neither writers nor the
+ * rotator wait for it. Backups still uncompressed at shutdown are picked
+ * up on the next start. backup_bytes() counts backups at their on-disk
+ * (compressed) size.
+ *
+ * With RetentionOptions, a third thread (also at the lowest priority)
+ * deletes backups beyond the size and age limits. It works from an
+ * inventory of backups listed once on start and then kept up to date by
+ * the rotator and the compressor, so neither rotation nor retention lists
+ * the directory; a rescan every rescan_interval picks up files removed or
+ * added by others. While backups are waiting to be compressed the size
+ * limit waits for them, so a burst of rotations does not delete history
+ * that compression would have made room for.
+ *
+ * With SegmentOptions, each new file is preallocated (usually to
+ * max_size_bytes) and written block-aligned; sizes are counted in bytes of
+ * log data, so padding and preallocated space never trigger rotation.
  */
 class RotatingFileHandler : public FileHandler {
 public:
     RotatingFileHandler(
         const std::filesystem::path& file_path,
         std::size_t max_size_bytes,
-        std::size_t max_backup_count
+        std::size_t max_backup_count,
+        std::shared_ptr<const Formatter> formatter = nullptr,
+        SegmentOptions segment = {},
+        RotationInterval interval = RotationInterval::None,
+        bool compress = false,
+        BackupNaming naming = BackupNaming::Cascade,
+        SpillOptions spill = {},
+        RetentionOptions retention = {}
     );
 
-    void write(const LogEntry& entry) override;
+    ~RotatingFileHandler() noexcept override;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override;
+
+    /**
+     * @brief Flush the current file once the rotator is idle: every record
+     * is in its final file and the next segment is prepared.
+     */
+    void flush() noexcept override;
 
     /** Get maximum file size before rotation */
     [[nodiscard]] std::size_t max_size_bytes() const noexcept { return max_size_bytes_; }
@@ -38,17 +198,141 @@ public:
     /** Get current file size */
     [[nodiscard]] std::size_t current_size() const noexcept { return current_size_; }
 
+    /** Get the time-based rotation interval */
+    [[nodiscard]] RotationInterval interval() const noexcept { return interval_; }
+
+    /** Get the backup naming scheme */
+    [[nodiscard]] BackupNaming naming() const noexcept { return naming_; }
+
+    /** Get the sequence number of the segment being written (Sequence naming) */
+    [[nodiscard]] std::uint64_t sequence() const noexcept { return sequence_.load(); }
+
     /** Check if rotation is disabled due to errors */
-    [[nodiscard]] bool rotation_disabled() const noexcept { return rotation_disabled_; }
+    [[nodiscard]] bool rotation_disabled() const noexcept { return rotation_disabled_.load(); }
+
+    /** Check if rotation is waiting to retry a failed step */
+    [[nodiscard]] bool rotation_paused() const noexcept { return rotation_paused_.load(); }
+
+    /** Get number of rotations performed */
+    [[nodiscard]] std::size_t rotations() const noexcept { return rotations_.load(); }
+
+    /** Get the backup codec (None when compression is off or unavailable) */
+    [[nodiscard]] Compression compression() const noexcept { return compression_; }
+
+    /** Get number of backups compressed */
+    [[nodiscard]] std::size_t backups_compressed() const noexcept { return backups_compressed_.load(); }
+
+    /** Get on-disk bytes of all backups (compressed size where compressed) */
+    [[nodiscard]] std::uint64_t backup_bytes() const noexcept { return backup_bytes_.load(); }
+
+    /** Get the size and age limits */
+    [[nodiscard]] const RetentionOptions& retention() const noexcept { return retention_; }
+
+    /** Get number of backups deleted for exceeding the size or age limit */
+    [[nodiscard]] std::size_t backups_expired() const noexcept { return backups_expired_.load(); }
+
+protected:
+    /** The file being written, which a reopen after a disk error must find */
+    [[nodiscard]] std::filesystem::path live_path() const override { return live_path_; }
 
 private:
     std::size_t max_size_bytes_;
     std::size_t max_backup_count_;
     std::size_t current_size_ = 0;
-    bool rotation_disabled_ = false;  // Disable rotation if filesystem errors occur
+    std::atomic<bool> rotation_disabled_{false};  // Disable rotation if filesystem errors occur
+    std::atomic<bool> rotation_paused_{false};    // A failed step waits for its retry
+    std::atomic<std::size_t> rotations_{0};
+
+    // Time-based rotation (nanoseconds since the epoch), guarded by mutex_
+    RotationInterval interval_;
+    std::int64_t period_ns_ = 0;
+    std::int64_t period_start_ = 0;            // Period of the current file
+    std::int64_t next_boundary_ = INT64_MAX;   // Entries at or past this rotate
+
+    // Sequence naming; sequence_ only changes on the rotator thread
+    BackupNaming naming_;
+    std::atomic<std::uint64_t> sequence_{0};  // Segment app.log points to
+
+    // Segment hand-off with the rotator thread, guarded by mutex_
+    std::filesystem::path next_path_;
+    std::ofstream next_file_;
+    SegmentFile next_segment_;
+    bool next_ready_ = false;        // next_* is open at next_path_
+    std::ofstream retired_file_;
+    SegmentFile retired_segment_;
+    bool retire_pending_ = false;    // retired_* is full and app.log.next is live
+    std::int64_t retired_period_ = 0;  // Period of retired_* (timestamped naming)
+    bool stop_ = false;
+    std::filesystem::path live_path_;  // Where records go now: .next or a segment until renamed
+    bool link_pending_ = false;      // The live file is not under file_path_ yet
+    std::chrono::steady_clock::time_point rotation_retry_at_{};
+    std::chrono::milliseconds rotation_backoff_{0};
+    std::condition_variable rotator_cv_;
+    std::condition_variable ready_cv_;
+    std::thread rotator_thread_;
+
+    // Backup compression. backup_mutex_ serializes renames of backups between
+    // the rotator and the compressor; cascades_ lets a compression job find
+    // a numbered backup again after cascades moved it
+    struct CompressJob {
+        std::filesystem::path path;  // Backup path when queued
+        std::uint64_t cascade = 0;   // cascades_ when queued (numbered backups)
+        bool numbered = false;
+    };
+    Compression compression_;
+    std::mutex backup_mutex_;
+    std::uint64_t cascades_ = 0;
+    std::deque<CompressJob> compress_queue_;  // Guarded by backup_mutex_
+    bool compressing_ = false;                // A job is off the queue but not done
+    bool backup_stop_ = false;                // Stops the compressor and retention threads
+    std::condition_variable compress_cv_;
+    std::thread compressor_thread_;
+    std::atomic<std::size_t> backups_compressed_{0};
+    std::atomic<std::uint64_t> backup_bytes_{0};
+
+    // Backup inventory, oldest first, guarded by backup_mutex_. Listed on
+    // start and every rescan_interval; the rotator, compressor and retention
+    // thread keep it current in between
+    struct BackupFile {
+        std::filesystem::path path;
+        std::string_view suffix;       // Compression suffix; empty if uncompressed
+        std::size_t index = 0;         // Cascade position (.N); 0 if the name never changes
+        bool stamped = false;          // Named after its period
+        std::uint64_t bytes = 0;
+        std::int64_t modified_ns = 0;  // Last write (kept through compression)
+    };
+    RetentionOptions retention_;
+    std::deque<BackupFile> backups_;
+    bool retention_pending_ = false;  // The inventory changed since the last pass
+    std::condition_variable retention_cv_;
+    std::thread retention_thread_;
+    std::atomic<std::size_t> backups_expired_{0};
 
-    void rotate();
-    [[nodiscard]] std::filesystem::path get_backup_path(std::size_t index) const noexcept;
+    void rotate(std::size_t entry_size, std::int64_t timestamp, std::unique_lock<std::mutex>& lock);
+    void start_period(std::int64_t timestamp) noexcept;
+    void move_to_backup(std::int64_t period);
+    void queue_uncompressed_backups();
+    void scan_backups();
+    void track_backup(std::filesystem::path path, std::size_t index, bool stamped);
+    void shift_numbered_backups();
+    std::deque<BackupFile>::iterator delete_backup(std::deque<BackupFile>::iterator backup);
+    void remove_backup(const std::filesystem::path& path);
+    void update_backup_bytes();
+    void compressor_thread_func();
+    [[nodiscard]] bool retention_enabled() const noexcept;
+    void enforce_retention();
+    void retention_thread_func();
+    [[nodiscard]] std::filesystem::path stamped_path(std::int64_t period) const;
+    void prune_stamped_backups();
+    void recover_next();
+    void start_sequence();
+    void point_current(std::uint64_t sequence);
+    [[nodiscard]] std::filesystem::path prepared_path() const;
+    bool open_next(std::ofstream& file, SegmentFile& segment) noexcept;
+    bool link_live_file() noexcept;
+    void take_back_live_file() noexcept;
+    void schedule_rotation_retry() noexcept;
+    void rotator_thread_func();
     [[nodiscard]] bool should_rotate(std::size_t entry_size) const noexcept;
 };
 
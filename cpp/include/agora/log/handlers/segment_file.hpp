@@ -0,0 +1,96 @@
+/**
+ * @file segment_file.hpp
+ * @brief Preallocated, block-aligned log segment writer (Linux)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace agora::log {
+
+/**
+ * @brief How FileHandler lays out the file on disk.
+ *
+ * With the defaults, FileHandler appends through std::ofstream.
+ */
+struct SegmentOptions {
+    std::size_t preallocate_bytes = 0;  ///< fallocate this much at open (0 = no preallocation)
+    bool direct_io = false;             ///< Write block-aligned buffers with O_DIRECT
+};
+
+/**
+ * @brief Append-only file writer for preallocated segments.
+ *
+ * On open, the segment is preallocated with fallocate(FALLOC_FL_KEEP_SIZE),
+ * so the filesystem does not have to allocate blocks while the file grows
+ * and readers never see unwritten space. Writes are staged in a
+ * block-aligned buffer and issued with pwrite at explicit offsets.
+ *
+ * With direct_io the file is opened with O_DIRECT, so every write is a
+ * whole number of blocks. A partial tail block is written zero-padded and
+ * rewritten on the next flush. close() truncates the file to its real
+ * length; after a failed write, to the data that did reach the disk. After a crash the file can end with up to one block of NUL
+ * padding. On reopen, trailing NULs are dropped from a block-aligned file.
+ *
+ * Falls back to buffered I/O when the filesystem rejects O_DIRECT, and
+ * skips preallocation when fallocate is unsupported. Not thread-safe.
+ */
+class SegmentFile {
+public:
+    static constexpr std::size_t kBlockSize = 4096;
+    static constexpr std::size_t kBufferSize = 256 * 1024;
+
+    SegmentFile() = default;
+    ~SegmentFile() noexcept { close(); }
+
+    SegmentFile(const SegmentFile&) = delete;
+    SegmentFile& operator=(const SegmentFile&) = delete;
+
+    /**
+     * @brief Open (or create) @p path for appending.
+     *
+     * Throws std::system_error on failure.
+     */
+    void open(const std::filesystem::path& path, const SegmentOptions& options);
+
+    /** Append @p data. Throws std::system_error on write failure. */
+    void write(std::string_view data);
+
+    /** Write all staged bytes to the file. */
+    void flush();
+
+    /** Flush, truncate to the real length and close. */
+    void close() noexcept;
+
+    /** Exchange open files (and staged bytes) with @p other. */
+    void swap(SegmentFile& other) noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+
+    /** Bytes of log data in the file (excluding padding and preallocation). */
+    [[nodiscard]] std::uint64_t size() const noexcept { return base_ + buffered_; }
+
+    /** Whether the file is open with O_DIRECT */
+    [[nodiscard]] bool direct() const noexcept { return direct_; }
+
+    /** Whether the segment was preallocated */
+    [[nodiscard]] bool preallocated() const noexcept { return preallocated_; }
+
+private:
+    int fd_ = -1;
+    bool direct_ = false;
+    bool preallocated_ = false;
+    std::unique_ptr<char, void (*)(void*)> buffer_{nullptr, nullptr};
+    std::size_t buffered_ = 0;  // Bytes staged in buffer_
+    std::size_t synced_ = 0;    // Staged bytes already on disk (direct_io tail block)
+    std::uint64_t base_ = 0;    // File offset of buffer_[0]
+
+    void write_at(const char* data, std::size_t size, std::uint64_t offset);
+};
+
+}  // namespace agora::log
@@ -0,0 +1,53 @@
+/**
+ * @file syslog.hpp
+ * @brief RFC 5424 syslog handler over a local Unix datagram socket
+ */
+
+#pragma once
+
+#include "datagram.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Formats an entry as an RFC 5424 syslog message.
+ *
+ * `<PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID [SD] MSG`, with the
+ * service name as APP-NAME and the logger name as MSGID. Structured data
+ * carries the source location (`src@32473`) and the context plus
+ * exception and duration (`ctx@32473`). 32473 is the private enterprise
+ * number reserved for examples (RFC 5612). Parameter names are cut to
+ * the 32 characters RFC 5424 allows. No trailing newline.
+ */
+class Rfc5424Formatter : public Formatter {
+public:
+    /**
+     * @param facility Syslog facility (default 1, user-level)
+     */
+    explicit Rfc5424Formatter(int facility = 1);
+
+    void format(const LogEntry& entry, std::string& out) const override;
+
+private:
+    int facility_;
+    std::string hostname_;
+    std::string procid_;
+};
+
+/**
+ * @brief Sends RFC 5424 messages to the local syslog daemon (rsyslog,
+ *        syslog-ng) over its Unix datagram socket.
+ */
+class SyslogHandler : public DatagramHandler {
+public:
+    static constexpr const char* kDefaultSocket = "/dev/log";
+
+    explicit SyslogHandler(
+        const std::filesystem::path& socket_path = kDefaultSocket,
+        int facility = 1,
+        std::size_t buffer_size = 1024 * 1024,
+        std::size_t flush_interval_ms = 20
+    );
+};
+
+}  // namespace agora::log
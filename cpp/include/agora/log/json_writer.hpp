@@ -0,0 +1,67 @@
+/**
+ * @file json_writer.hpp
+ * @brief Low-level JSON serialization primitives used by the formatters
+ *
+ * All functions append to a caller-owned std::string so a single buffer
+ * can be reused across entries without per-field allocations. Output is
+ * byte-compatible with nlohmann::json::dump() (compact, ensure_ascii=false).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace agora::log {
+
+/**
+ * @brief Append a quoted, escaped JSON string.
+ *
+ * Escapes '"', '\\' and control characters; valid UTF-8 is copied
+ * verbatim. Invalid UTF-8 sequences are replaced with U+FFFD.
+ */
+void append_json_string(std::string& out, std::string_view value);
+
+/**
+ * @brief Check that @p value is well-formed UTF-8 (no overlongs/surrogates).
+ */
+[[nodiscard]] bool is_valid_utf8(std::string_view value) noexcept;
+
+/**
+ * @brief Append @p value with invalid UTF-8 sequences replaced by U+FFFD.
+ *
+ * Same replacement rule as append_json_string(), without quoting or
+ * escaping; used by binary formats whose text strings must be UTF-8.
+ */
+void append_utf8_sanitized(std::string& out, std::string_view value);
+
+/**
+ * @brief Append a signed integer.
+ */
+void append_json_int(std::string& out, std::int64_t value);
+
+/**
+ * @brief Append an unsigned integer.
+ */
+void append_json_uint(std::string& out, std::uint64_t value);
+
+/**
+ * @brief Append a floating-point number.
+ *
+ * Uses the shortest round-trip representation (std::to_chars) and the
+ * same layout rules as nlohmann::json (e.g. "1.0", "0.001", "1e+20").
+ * NaN and infinity are written as null. Grisu2 in nlohmann::json is not
+ * always shortest, so a small fraction of values differ in the last
+ * digit; both forms parse back to the identical double.
+ */
+void append_json_double(std::string& out, double value);
+
+/**
+ * @brief Append true/false.
+ */
+inline void append_json_bool(std::string& out, bool value) {
+    out.append(value ? "true" : "false");
+}
+
+}  // namespace agora::log
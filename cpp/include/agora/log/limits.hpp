@@ -0,0 +1,59 @@
+/**
+ * @file limits.hpp
+ * @brief Per-field and per-record size caps applied before formatting
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "entry.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Byte caps on user-supplied record content (0 = unlimited).
+ *
+ * Caps apply to raw field bytes before escaping. A truncated field keeps
+ * a UTF-8-safe prefix followed by a "...[truncated N bytes]" marker and,
+ * marker included, fits in the cap (for caps above 48 bytes). The
+ * worst-case formatted size, and the time a handler holds its lock, is
+ * therefore bounded by roughly max_record_bytes.
+ */
+struct RecordLimits {
+    std::size_t max_field_bytes = 0;   ///< message, context string values, exception message
+    std::size_t max_record_bytes = 0;  ///< Sum of all variable-length fields
+};
+
+/**
+ * @brief Longest prefix of @p value of at most @p max_bytes bytes that
+ *        does not split a UTF-8 sequence.
+ */
+[[nodiscard]] std::string_view utf8_prefix(std::string_view value, std::size_t max_bytes) noexcept;
+
+/**
+ * @brief Assign @p value to @p out, truncated (marker included) to @p max_bytes.
+ *
+ * Copies at most @p max_bytes of the source, so oversized inputs are
+ * never copied in full. @p max_bytes of 0 means unlimited.
+ *
+ * @return true if @p value was truncated.
+ */
+bool assign_truncated(std::string& out, std::string_view value, std::size_t max_bytes);
+
+/**
+ * @brief Enforce @p limits on @p entry in place.
+ *
+ * Field caps are applied first. If the record is still over
+ * max_record_bytes, the largest truncatable fields are shortened to a
+ * common length (smaller fields are left intact); if context keys alone
+ * exceed the budget, context entries are dropped and counted in a
+ * "_dropped_keys" context field.
+ *
+ * @return true if anything was truncated or dropped.
+ */
+bool apply_limits(LogEntry& entry, const RecordLimits& limits);
+
+}  // namespace agora::log
@@ -5,7 +5,8 @@
  * Provides a high-performance, thread-safe logging API with:
  * - Automatic source location capture (file, line, function - REQUIRED)
  * - Context injection and inheritance
- * - Dual output (console + file)
+ * - Console, file and daemon outputs with per-handler levels and
+ *   routing by logger-name prefix
  * - Compile-time log level filtering
  */
 
@@ -31,6 +32,8 @@ namespace agora::log {
 class Config;
 class Handler;
 class Timer;
+struct RoutedHandlers;
+struct CommitState;
 
 /**
  * @brief Error information for logging operations.
@@ -40,6 +43,44 @@ struct Error {
     int code = 0;
 };
 
+/**
+ * @brief Completion of a durable write (see DurableFileHandler).
+ *
+ * Returned by Logger::critical() and Logger::audit(). The token completes
+ * once every durable handler that received the record has it on stable
+ * storage (written and fdatasync'ed), or has failed. A token for a record
+ * no durable handler received (none configured, or filtered out) is
+ * complete from the start and reports durable() == false.
+ */
+class CommitToken {
+public:
+    CommitToken() noexcept = default;
+    explicit CommitToken(std::shared_ptr<CommitState> state) noexcept
+        : state_(std::move(state)) {}
+
+    /** Whether a durable handler received the record */
+    [[nodiscard]] bool durable() const noexcept { return state_ != nullptr; }
+
+    /** Whether the commit has completed (successfully or not) */
+    [[nodiscard]] bool ready() const noexcept;
+
+    /**
+     * @brief Block until the record is on stable storage.
+     *
+     * Returns the write or fdatasync error (code = errno) if a handler
+     * failed to commit it.
+     */
+    [[nodiscard]] std::expected<void, Error> wait() const;
+
+    /**
+     * @brief Block for at most @p timeout; false if still pending.
+     */
+    [[nodiscard]] bool wait_for(std::chrono::nanoseconds timeout) const;
+
+private:
+    std::shared_ptr<CommitState> state_;
+};
+
 /**
  * @brief Source location information for log entries.
  * 
@@ -62,6 +103,73 @@ struct SourceLocation {
             .function = loc.function_name()
         };
     }
+
+    /**
+     * @brief Unqualified function name, e.g. "route" for
+     *        "void agora::OrderRouter::route(const Order&) const".
+     *
+     * Drops the return type, scope, parameter list, cv/ref qualifiers and
+     * template arguments. Operators keep their symbol ("operator()").
+     * Falls back to the full name when it cannot be parsed.
+     */
+    [[nodiscard]] constexpr std::string_view unqualified_function() const noexcept {
+        constexpr auto npos = std::string_view::npos;
+        std::string_view name = function;
+
+        // GCC/Clang template suffix: "... [with T = int]" / "... [T = int]"
+        if (!name.empty() && name.back() == ']') {
+            if (auto bracket = name.rfind(" ["); bracket != npos) {
+                name = name.substr(0, bracket);
+            }
+        }
+
+        // Match the last ')' back to the '(' that opens the parameter list
+        auto close = name.rfind(')');
+        if (close == npos) {
+            return function;
+        }
+        std::size_t depth = 0;
+        std::size_t open = npos;
+        for (std::size_t i = close + 1; i-- > 0;) {
+            if (name[i] == ')') {
+                ++depth;
+            } else if (name[i] == '(' && --depth == 0) {
+                open = i;
+                break;
+            }
+        }
+        if (open == npos) {
+            return function;
+        }
+        auto qualified = name.substr(0, open);
+
+        if (auto op = qualified.rfind("operator");
+            op != npos && (op == 0 || qualified[op - 1] == ':' || qualified[op - 1] == ' ')) {
+            return qualified.substr(op);
+        }
+
+        // Walk back to the start of the name, skipping template arguments
+        std::size_t start = qualified.size();
+        int angle = 0;
+        while (start > 0) {
+            char c = qualified[start - 1];
+            if (c == '>') {
+                ++angle;
+            } else if (c == '<') {
+                if (angle == 0) break;
+                --angle;
+            } else if (angle == 0 && (c == ' ' || c == ':' || c == '*' || c == '&')) {
+                break;
+            }
+            --start;
+        }
+
+        auto unqualified = qualified.substr(start);
+        if (auto lt = unqualified.find('<'); lt != npos && lt > 0) {
+            unqualified = unqualified.substr(0, lt);
+        }
+        return unqualified.empty() ? function : unqualified;
+    }
     
 private:
     static constexpr std::string_view extract_filename(
@@ -134,7 +242,22 @@ public:
         SourceLocation loc = SourceLocation::current()
     ) const;
     
-    void critical(
+    /**
+     * @brief Log at CRITICAL level.
+     *
+     * Durable handlers commit the record; wait on the token before acting
+     * on it (e.g. acknowledging an order).
+     */
+    CommitToken critical(
+        std::string_view message,
+        Context ctx = {},
+        SourceLocation loc = SourceLocation::current()
+    ) const;
+
+    /**
+     * @brief Log an audit record at INFO level and get its commit token.
+     */
+    CommitToken audit(
         std::string_view message,
         Context ctx = {},
         SourceLocation loc = SourceLocation::current()
@@ -159,18 +282,30 @@ public:
 private:
     friend class Timer;  // Timer needs access to private members for logging
 
-    void log(
+    Logger(
+        std::string name,
+        std::shared_ptr<const Config> config,
+        Context context,
+        std::shared_ptr<const RoutedHandlers> handlers
+    );
+
+    // Returns a commit token when `commit` is set and a durable handler
+    // accepts the level
+    CommitToken log(
         Level level,
         std::string_view message,
         const SourceLocation& loc,
         Context ctx = {},
-        const std::exception* ex = nullptr
+        const std::exception* ex = nullptr,
+        bool commit = false
     ) const;
 
     std::string name_;
     std::shared_ptr<const Config> config_;
     Context context_;
-    std::vector<std::shared_ptr<Handler>> handlers_;
+    // Handlers accepting each level, resolved from Config::routes and the
+    // handler thresholds when the logger is created
+    std::shared_ptr<const RoutedHandlers> handlers_;
 };
 
 /**
@@ -230,4 +365,10 @@ void shutdown();
 [[nodiscard]]
 Logger get_logger(std::string_view name);
 
+/**
+ * @brief Number of records truncated by Config::limits since process start.
+ */
+[[nodiscard]]
+std::uint64_t truncated_records() noexcept;
+
 }  // namespace agora::log
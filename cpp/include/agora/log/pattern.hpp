@@ -0,0 +1,112 @@
+/**
+ * @file pattern.hpp
+ * @brief Compiled pattern layouts for text output
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "entry.hpp"
+#include "formatter.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Default text layout, equivalent to the classic format_text output:
+ *   [2024-01-15 12:34:56.789123] [INFO] [service] message (k=v, ...)
+ */
+inline constexpr std::string_view kDefaultTextPattern = "[%t] [%l] [%S] %m%C%D%E";
+
+/**
+ * @brief Text layout compiled from a pattern string.
+ *
+ * The pattern is parsed once into a flat list of emit operations; format()
+ * then appends into a caller-provided buffer without iostreams or locale.
+ *
+ * Conversion specifiers:
+ *   %T  timestamp, UTC ISO 8601 (or epoch integer per FormatOptions)
+ *   %t  timestamp, local "YYYY-MM-DD HH:MM:SS.ffffff" (or epoch integer)
+ *   %l  level            %n  logger name
+ *   %S  service          %e  environment       %v  version
+ *   %s  source file      %#  source line       %f  function (unqualified
+ *                                                  with trim_function)
+ *   %m  message
+ *   %C  " (k=v, ...)"    context, omitted when empty
+ *   %D  " [12.5ms]"      duration, omitted when absent
+ *   %E  " [type: msg]"   exception, omitted when absent
+ *   %%  literal '%'
+ *
+ * Optional fields (%C, %D, %E) carry their own leading space so they
+ * vanish cleanly. Unknown specifiers are emitted literally.
+ */
+class PatternLayout {
+public:
+    explicit PatternLayout(std::string_view pattern = kDefaultTextPattern);
+
+    /**
+     * @brief Append the formatted entry to @p out (no trailing newline).
+     */
+    void format(const LogEntry& entry, std::string& out, const FormatOptions& options = {}) const;
+
+    /** Get the source pattern */
+    [[nodiscard]] const std::string& pattern() const noexcept { return pattern_; }
+
+private:
+    enum class Op : std::uint8_t {
+        Literal,
+        Timestamp,
+        LocalTime,
+        Level,
+        LoggerName,
+        Service,
+        Environment,
+        Version,
+        File,
+        Line,
+        Function,
+        Message,
+        Context,
+        Duration,
+        Exception
+    };
+
+    struct Step {
+        Op op;
+        std::uint32_t offset = 0;  // Literal: slice of literals_
+        std::uint32_t length = 0;
+    };
+
+    std::string pattern_;
+    std::string literals_;
+    std::vector<Step> steps_;
+};
+
+/**
+ * @brief Newline-delimited text formatter backed by a PatternLayout.
+ */
+class PatternFormatter : public Formatter {
+public:
+    explicit PatternFormatter(
+        std::string_view pattern = kDefaultTextPattern,
+        FormatOptions options = {}
+    )
+        : layout_(pattern)
+        , options_(options) {}
+
+    void format(const LogEntry& entry, std::string& out) const override {
+        layout_.format(entry, out, options_);
+        out.push_back('\n');
+    }
+
+    [[nodiscard]] const PatternLayout& layout() const noexcept { return layout_; }
+
+private:
+    PatternLayout layout_;
+    FormatOptions options_;
+};
+
+}  // namespace agora::log
@@ -0,0 +1,77 @@
+/**
+ * @file routing.hpp
+ * @brief Routing rules by logger-name prefix
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "level.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Sends the records of loggers under a name prefix to a chosen set
+ *        of handlers, with their own minimum level.
+ *
+ * Rules are resolved once, when a logger is created: the longest matching
+ * prefix wins, and loggers no rule matches use Config::level and all
+ * standard handlers. Handlers are named "console", "file", "binary",
+ * "journald" and "syslog"; "durable" (Config::durable_file_enabled) only
+ * receives loggers a rule routes to it. Per-handler thresholds
+ * (Config::console_level, Config::file_level) still apply on top of the
+ * rule.
+ */
+struct Route {
+    // "agora.audit" matches "agora.audit" and "agora.audit.trades", not
+    // "agora.auditor"; an empty prefix matches every logger
+    std::string prefix{};
+
+    // Minimum level for matching loggers (default: Config::level)
+    std::optional<Level> level{};
+
+    // Handlers receiving the records. Empty means all standard handlers,
+    // or only `file` when that is set
+    std::vector<std::string> handlers{};
+
+    // Dedicated file for matching loggers, written with the file settings
+    // of Config (rotation, format, buffering); routes naming the same path
+    // share one handler
+    std::filesystem::path file{};
+};
+
+/**
+ * @brief Whether @p prefix covers @p logger_name (dot-separated).
+ */
+[[nodiscard]] constexpr bool matches_prefix(std::string_view prefix, std::string_view logger_name) noexcept {
+    if (prefix.empty()) {
+        return true;
+    }
+    if (!logger_name.starts_with(prefix)) {
+        return false;
+    }
+    return logger_name.size() == prefix.size() || logger_name[prefix.size()] == '.';
+}
+
+/**
+ * @brief The rule with the longest prefix matching @p logger_name, or
+ *        nullptr. Among equal prefixes the first rule wins.
+ */
+[[nodiscard]] const Route* find_route(const std::vector<Route>& routes, std::string_view logger_name) noexcept;
+
+/**
+ * @brief Parse rules of the form
+ *        `prefix:key=value,key=value;prefix:...`.
+ *
+ * Keys are `level`, `handlers` (names separated by '+') and `file`, e.g.
+ * `agora.audit:file=/var/log/agora/audit.log;agora.marketdata:level=INFO`.
+ * Unknown keys and invalid levels are ignored.
+ */
+[[nodiscard]] std::vector<Route> parse_routes(std::string_view spec);
+
+}  // namespace agora::log
@@ -0,0 +1,153 @@
+/**
+ * @file sink_executor.hpp
+ * @brief Parallel fan-out of records to independent sinks
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "entry.hpp"
+#include "handlers/handler.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief Queue and lag metrics of one sink.
+ */
+struct SinkStats {
+    std::string name;
+    std::size_t queued = 0;          // Records waiting now
+    std::size_t max_queued = 0;      // High-water mark of queued
+    std::uint64_t written = 0;       // Records handed to the handler
+    std::uint64_t dropped = 0;       // Records rejected by a full queue
+    std::chrono::nanoseconds last_lag{0};  // Submit to write completion, latest record
+    std::chrono::nanoseconds max_lag{0};   // Highest lag seen
+};
+
+/**
+ * @brief Writes records to several handlers in parallel on a small pool.
+ *
+ * Every sink has its own queue. submit() formats an entry once per
+ * distinct formatter on the calling thread (as the synchronous path
+ * does), then appends one reference to the shared record to the queue of
+ * each target sink. A worker takes a sink with queued records, drains its
+ * whole queue as one batch and writes it in order; a sink is served by at
+ * most one worker at a time, so its records keep submission order while a
+ * slow sink only delays its own queue.
+ *
+ * A full queue blocks the caller until the sink catches up, or drops the
+ * record for that sink (counted in SinkStats::dropped) with
+ * drop_when_full. Handler exceptions are ignored, as in the synchronous
+ * path. Either way a durable handler's commit token is failed rather than
+ * left pending.
+ */
+class SinkExecutor {
+public:
+    /**
+     * @param sinks Named handlers; submit() addresses them by index
+     * @param workers Pool threads (at most one per sink is useful)
+     * @param queue_capacity Records queued per sink before blocking or dropping
+     * @param drop_when_full Drop instead of waiting when a queue is full
+     */
+    SinkExecutor(
+        std::vector<std::pair<std::string, std::shared_ptr<Handler>>> sinks,
+        std::size_t workers,
+        std::size_t queue_capacity = 8192,
+        bool drop_when_full = false
+    );
+
+    /** Writes what is queued and joins the pool (see stop()). */
+    ~SinkExecutor() noexcept;
+
+    SinkExecutor(const SinkExecutor&) = delete;
+    SinkExecutor& operator=(const SinkExecutor&) = delete;
+
+    /**
+     * @brief Queue @p entry for the sinks at @p sinks (indices into the
+     *        constructor's list).
+     *
+     * After stop(), the entry is written on the calling thread instead,
+     * once the records already queued for each sink have been written.
+     */
+    void submit(std::span<const std::size_t> sinks, LogEntry entry);
+
+    /**
+     * @brief Wait until every record submitted so far has been written.
+     *
+     * Does not flush the handlers themselves.
+     */
+    void drain() noexcept;
+
+    /**
+     * @brief Drain the queues and join the pool. Idempotent.
+     */
+    void stop() noexcept;
+
+    /** Get metrics of every sink, in constructor order */
+    [[nodiscard]] std::vector<SinkStats> stats() const;
+
+    /** Get number of sinks */
+    [[nodiscard]] std::size_t size() const noexcept { return sinks_.size(); }
+
+private:
+    /** Entry plus its records, formatted once per distinct formatter. */
+    struct Record {
+        LogEntry entry;
+        std::vector<std::pair<const Formatter*, std::string>> formatted;
+    };
+
+    struct Item {
+        std::shared_ptr<const Record> record;
+        std::int32_t slot = -1;  // Index into Record::formatted, -1 for write()
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    struct Sink {
+        std::shared_ptr<Handler> handler;
+
+        mutable std::mutex mutex;
+        std::condition_variable space_cv;    // Queue below capacity
+        std::condition_variable drained_cv;  // Nothing queued or in flight
+        std::vector<Item> queue;
+        std::size_t in_flight = 0;  // Taken by a worker, not yet written
+        bool scheduled = false;     // In ready_ or held by a worker
+        SinkStats stats;
+    };
+
+    std::vector<std::unique_ptr<Sink>> sinks_;
+    std::size_t queue_capacity_;
+    bool drop_when_full_;
+    std::atomic<bool> stopped_{false};
+
+    // Pool: sinks with queued records, served in FIFO order
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    std::deque<std::size_t> ready_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    void write(Sink& sink, const Item& item) noexcept;
+    void fail_commit(Sink& sink, const Record& record, int error) noexcept;
+    void schedule(std::size_t index);
+    void worker_thread_func();
+};
+
+/**
+ * @brief Metrics of the sinks run by the executor initialize() created
+ *        (empty unless Config::sink_workers is set).
+ */
+[[nodiscard]] std::vector<SinkStats> sink_stats();
+
+}  // namespace agora::log
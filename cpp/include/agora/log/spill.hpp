@@ -0,0 +1,125 @@
+/**
+ * @file spill.hpp
+ * @brief In-memory spill buffer and disk-health counters for file sinks
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "level.hpp"
+
+namespace agora::log {
+
+/**
+ * @brief How a file sink degrades when its disk fails or stalls.
+ *
+ * A write that fails (ENOSPC, EIO, a vanished directory, ...) or takes
+ * longer than slow_write switches the sink to degraded mode. Degraded
+ * records go to a SpillBuffer of spill_bytes instead of the disk. The disk
+ * is retried after retry_initial, doubling up to retry_max while it keeps
+ * failing. A successful retry writes the spilled records back in order.
+ */
+struct SpillOptions {
+    std::size_t spill_bytes = 4 * 1024 * 1024;                   // 0 = shed everything while degraded
+    std::chrono::milliseconds slow_write{100};                   // 0 = ignore latency
+    std::chrono::milliseconds retry_initial{100};
+    std::chrono::milliseconds retry_max{30'000};
+};
+
+/**
+ * @brief Degradation and recovery counters of a file sink.
+ */
+struct DiskStats {
+    bool degraded = false;             // Currently spilling
+    std::uint64_t degradations = 0;    // Healthy -> degraded transitions
+    std::uint64_t recoveries = 0;      // Degraded -> healthy transitions
+    std::uint64_t write_errors = 0;    // Failed writes and reopens
+    std::uint64_t slow_writes = 0;     // Writes slower than SpillOptions::slow_write
+    std::uint64_t retries = 0;         // Recovery attempts, successful or not
+    std::uint64_t spilled = 0;         // Records kept in memory
+    std::uint64_t replayed = 0;        // Spilled records written after recovery
+    std::array<std::uint64_t, 5> shed{};  // Records dropped, by level (DEBUG .. CRITICAL)
+    std::size_t spill_bytes = 0;       // Bytes held in memory now
+
+    /** Total records dropped */
+    [[nodiscard]] std::uint64_t shed_total() const noexcept {
+        std::uint64_t total = 0;
+        for (auto count : shed) {
+            total += count;
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief Bounded buffer of formatted records that sheds by level.
+ *
+ * Records are kept per level and handed back in arrival order. When the
+ * buffer is full, a new record displaces the oldest records of lower
+ * levels (DEBUG first); if only records of its own level or above are
+ * left, the new record is dropped instead. Not thread-safe.
+ */
+class SpillBuffer {
+public:
+    explicit SpillBuffer(std::size_t capacity_bytes = 4 * 1024 * 1024)
+        : capacity_(capacity_bytes) {}
+
+    /**
+     * @brief Keep @p record, shedding lower levels if needed.
+     *
+     * @return false if @p record itself was shed.
+     */
+    bool push(Level level, std::string_view record);
+
+    /** Oldest record kept. Requires !empty(). */
+    [[nodiscard]] std::string_view front() const noexcept;
+
+    /** Remove the oldest record. Requires !empty(). */
+    void pop_front() noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] std::size_t bytes() const noexcept { return bytes_; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    /** Records shed so far, by level index (DEBUG .. CRITICAL) */
+    [[nodiscard]] const std::array<std::uint64_t, 5>& shed() const noexcept { return shed_; }
+
+    /** Index of @p level in shed() */
+    static constexpr std::size_t index(Level level) noexcept {
+        int value = static_cast<int>(level) / 10 - 1;
+        return static_cast<std::size_t>(value < 0 ? 0 : value > 4 ? 4 : value);
+    }
+
+private:
+    struct Item {
+        std::uint64_t sequence;
+        std::string record;
+    };
+
+    std::size_t capacity_;
+    std::array<std::deque<Item>, 5> levels_;
+    std::size_t count_ = 0;
+    std::size_t bytes_ = 0;
+    std::uint64_t next_sequence_ = 0;
+    std::array<std::uint64_t, 5> shed_{};
+
+    [[nodiscard]] std::size_t oldest_level() const noexcept;
+};
+
+/**
+ * @brief Disk counters of the file handlers initialize() created, by
+ *        sink name ("file" and route files).
+ */
+[[nodiscard]] std::vector<std::pair<std::string, DiskStats>> disk_stats();
+
+}  // namespace agora::log
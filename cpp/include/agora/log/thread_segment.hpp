@@ -0,0 +1,175 @@
+/**
+ * @file thread_segment.hpp
+ * @brief Per-thread segment format, reader and k-way merge
+ *
+ * PerThreadFileHandler writes one segment file per logging thread, named
+ * after the handler's base path: `app.log` becomes `app.log.t0`,
+ * `app.log.t1`, ... A segment is
+ *
+ *   segment := "AGTS" version:u8 0 0 0  frame*
+ *   frame   := timestamp_ns:i64  size:u32  flags:u32  record[size]
+ *
+ * with little-endian integers. record holds the formatter's bytes
+ * unchanged (terminator included); flags bit 0 marks the formatter's
+ * stream header. Timestamps never decrease within a segment, so segments
+ * can be merged by timestamp in one streaming pass.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logger.hpp"
+
+namespace agora::log {
+
+/** Segment format version written after the magic. */
+inline constexpr std::uint8_t kThreadSegmentVersion = 1;
+
+/** Bytes before the first frame: "AGTS", version, three zero bytes. */
+inline constexpr std::size_t kThreadSegmentPreambleSize = 8;
+
+/** Bytes of a frame before its record. */
+inline constexpr std::size_t kThreadSegmentFrameSize = 16;
+
+/** Frame flag: the record is the formatter's stream header. */
+inline constexpr std::uint32_t kThreadSegmentHeaderFlag = 1;
+
+/**
+ * @brief One record read back from a segment.
+ */
+struct SegmentFrame {
+    std::int64_t timestamp_ns = 0;  // Nanoseconds since the epoch
+    bool header = false;            // Formatter stream header, not a log record
+    std::string record;
+};
+
+/**
+ * @brief Append the preamble that starts every segment.
+ */
+void append_thread_segment_preamble(std::string& out);
+
+/**
+ * @brief Append one frame holding @p record.
+ */
+void append_thread_segment_frame(std::string& out, std::int64_t timestamp_ns, std::uint32_t flags, std::string_view record);
+
+/**
+ * @brief Path of segment @p index for @p base_path ("app.log" -> "app.log.t3").
+ */
+[[nodiscard]] std::filesystem::path thread_segment_path(const std::filesystem::path& base_path, std::size_t index);
+
+/**
+ * @brief Index of @p path if it names a segment of @p base_path.
+ */
+[[nodiscard]] std::optional<std::size_t> thread_segment_index(
+    const std::filesystem::path& base_path,
+    const std::filesystem::path& path
+);
+
+/**
+ * @brief Existing segments of @p base_path, ordered by index.
+ */
+[[nodiscard]] std::vector<std::filesystem::path> find_thread_segments(const std::filesystem::path& base_path);
+
+/**
+ * @brief Streaming reader for one segment.
+ *
+ * A frame cut short at the end of the stream (a crash mid-write) ends
+ * the stream and sets truncated(); frames before it are returned.
+ */
+class ThreadSegmentReader {
+public:
+    explicit ThreadSegmentReader(std::istream& in)
+        : in_(in) {}
+
+    /**
+     * @brief Read the next frame.
+     *
+     * @return true if @p frame was filled, false at end of stream, or an
+     *         Error for a missing preamble or a corrupt frame.
+     */
+    std::expected<bool, Error> next(SegmentFrame& frame);
+
+    /** Whether the stream ended inside a frame */
+    [[nodiscard]] bool truncated() const noexcept { return truncated_; }
+
+private:
+    std::istream& in_;
+    bool started_ = false;
+    bool truncated_ = false;
+};
+
+/**
+ * @brief K-way merge of segments into one timestamp-ordered stream.
+ *
+ * Keeps one open file and one pending frame per segment and a min-heap
+ * of their timestamps, so memory does not grow with segment size. Equal
+ * timestamps keep segment order (by position in @p segments), and
+ * frames of one segment keep their file order.
+ */
+class SegmentMerger {
+public:
+    explicit SegmentMerger(std::span<const std::filesystem::path> segments);
+    ~SegmentMerger() noexcept;
+
+    SegmentMerger(const SegmentMerger&) = delete;
+    SegmentMerger& operator=(const SegmentMerger&) = delete;
+
+    /**
+     * @brief Move the next frame in timestamp order into @p frame.
+     *
+     * Segments are opened on the first call.
+     *
+     * @return true if @p frame was filled, false once every segment is
+     *         exhausted, or an Error naming the unreadable segment.
+     */
+    std::expected<bool, Error> next(SegmentFrame& frame);
+
+    /** Segments that ended inside a frame, so far */
+    [[nodiscard]] const std::vector<std::filesystem::path>& truncated() const noexcept { return truncated_; }
+
+private:
+    struct Input;
+
+    std::vector<std::filesystem::path> paths_;
+    std::vector<std::unique_ptr<Input>> inputs_;
+    std::vector<std::size_t> heap_;  // Indices into inputs_, earliest pending frame on top
+    std::vector<std::filesystem::path> truncated_;
+    bool started_ = false;
+
+    /** Read the next frame of input @p index and queue it; false once exhausted. */
+    std::expected<bool, Error> advance(std::size_t index);
+    [[nodiscard]] bool later(std::size_t a, std::size_t b) const noexcept;
+};
+
+/**
+ * @brief Result of merge_thread_segments().
+ */
+struct MergeResult {
+    std::size_t records = 0;  // Log records written (headers excluded)
+    std::vector<std::filesystem::path> truncated;
+};
+
+/**
+ * @brief Merge @p segments into @p out by timestamp.
+ *
+ * Writes the records unchanged, plus the first stream header (segments
+ * of one handler all carry the same one).
+ */
+std::expected<MergeResult, Error> merge_thread_segments(
+    std::span<const std::filesystem::path> segments,
+    std::ostream& out
+);
+
+}  // namespace agora::log
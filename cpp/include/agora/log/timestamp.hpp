@@ -0,0 +1,70 @@
+/**
+ * @file timestamp.hpp
+ * @brief Cached timestamp rendering for the formatters
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace agora::log {
+
+/**
+ * @brief Timestamp representation written by the formatters.
+ */
+enum class TimestampFormat {
+    Iso8601,      ///< "2024-01-15T12:34:56.789123Z" (UTC, microseconds)
+    EpochMicros,  ///< 1705322096789123 (integer microseconds since epoch)
+    EpochNanos    ///< 1705322096789123456 (integer nanoseconds since epoch)
+};
+
+/**
+ * @brief Convert timestamp format to string.
+ */
+constexpr std::string_view to_string(TimestampFormat format) noexcept {
+    switch (format) {
+        case TimestampFormat::Iso8601: return "iso8601";
+        case TimestampFormat::EpochMicros: return "epoch_us";
+        case TimestampFormat::EpochNanos: return "epoch_ns";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Parse timestamp format from string.
+ */
+inline TimestampFormat from_string(std::string_view str, TimestampFormat default_format) noexcept {
+    if (str == "iso8601" || str == "ISO8601") return TimestampFormat::Iso8601;
+    if (str == "epoch_us" || str == "EPOCH_US") return TimestampFormat::EpochMicros;
+    if (str == "epoch_ns" || str == "EPOCH_NS") return TimestampFormat::EpochNanos;
+    return default_format;
+}
+
+/**
+ * @brief Append "YYYY-MM-DDTHH:MM:SS.ffffffZ" (UTC).
+ *
+ * The date/time prefix is cached per thread for the current second, so
+ * only the sub-second digits are rendered for most entries.
+ */
+void append_iso8601_utc(std::string& out, std::chrono::system_clock::time_point tp);
+
+/**
+ * @brief Append "YYYY-MM-DD HH:MM:SS.ffffff" (local time).
+ *
+ * Cached per thread like append_iso8601_utc(); localtime_r (and glibc's
+ * tz lock) is only hit once per second per thread.
+ */
+void append_local_datetime(std::string& out, std::chrono::system_clock::time_point tp);
+
+/**
+ * @brief Append the timestamp in the requested format (unquoted).
+ */
+void append_timestamp(
+    std::string& out,
+    std::chrono::system_clock::time_point tp,
+    TimestampFormat format
+);
+
+}  // namespace agora::log
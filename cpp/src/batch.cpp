@@ -0,0 +1,88 @@
+/**
+ * @file batch.cpp
+ * @brief Record batch implementation
+ */
+
+#include <agora/log/batch.hpp>
+#include <algorithm>
+
+namespace agora::log {
+
+RecordBatch::Text RecordBatch::store(std::string_view value) {
+    Text t{static_cast<std::uint32_t>(text_.size()), static_cast<std::uint32_t>(value.size())};
+    text_.append(value);
+    return t;
+}
+
+void RecordBatch::push_back(const LogEntry& entry) {
+    timestamps_.push_back(entry.timestamp);
+    levels_.push_back(entry.level);
+    lines_.push_back(entry.location.line);
+    messages_.push_back(store(entry.message));
+    logger_names_.push_back(store(entry.logger_name));
+    files_.push_back(store(entry.location.file));
+    functions_.push_back(store(entry.location.function));
+    durations_.push_back(entry.duration_ms);
+
+    if (entry.exception) {
+        exception_index_.push_back(static_cast<std::int32_t>(exceptions_.size()));
+        exceptions_.push_back({store(entry.exception->type), store(entry.exception->message)});
+    } else {
+        exception_index_.push_back(-1);
+    }
+
+    // Context, sorted once here so the formatter walks it linearly
+    std::size_t begin = fields_.size();
+    for (const auto& [key, value] : entry.context) {
+        Field field;
+        field.key = store(key);
+        field.type = static_cast<std::uint8_t>(value.index());
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                field.string = store(v);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                field.boolean = v;
+            } else if constexpr (std::is_same_v<T, std::int64_t>) {
+                field.integer = v;
+            } else {
+                field.number = v;
+            }
+        }, value);
+        fields_.push_back(field);
+    }
+    std::sort(fields_.begin() + static_cast<std::ptrdiff_t>(begin), fields_.end(),
+        [this](const Field& a, const Field& b) { return text(a.key) < text(b.key); });
+    field_begin_.push_back(static_cast<std::uint32_t>(fields_.size()));
+
+    // Metadata rarely changes; reuse the previous triple when equal
+    if (metadata_table_.empty() ||
+        text(metadata_table_.back()[0]) != entry.environment ||
+        text(metadata_table_.back()[1]) != entry.service_name ||
+        text(metadata_table_.back()[2]) != entry.version) {
+        metadata_table_.push_back({
+            store(entry.environment), store(entry.service_name), store(entry.version)
+        });
+    }
+    metadata_.push_back(static_cast<std::uint32_t>(metadata_table_.size() - 1));
+}
+
+void RecordBatch::clear() noexcept {
+    timestamps_.clear();
+    levels_.clear();
+    lines_.clear();
+    messages_.clear();
+    logger_names_.clear();
+    files_.clear();
+    functions_.clear();
+    durations_.clear();
+    exception_index_.clear();
+    exceptions_.clear();
+    field_begin_.resize(1);
+    fields_.clear();
+    metadata_.clear();
+    metadata_table_.clear();
+    text_.clear();
+}
+
+}  // namespace agora::log
@@ -0,0 +1,413 @@
+/**
+ * @file binary.cpp
+ * @brief Binary log format implementation
+ */
+
+#include <agora/log/binary.hpp>
+#include <bit>
+#include <cstring>
+
+namespace agora::log {
+
+namespace {
+
+enum RecordType : std::uint8_t {
+    kSession = 0x00,
+    kString = 0x01,
+    kCallSite = 0x02,
+    kEntry = 0x03
+};
+
+enum ValueTag : std::uint8_t {
+    kTagString = 0,
+    kTagInt = 1,
+    kTagDouble = 2,
+    kTagBool = 3
+};
+
+enum EntryFlags : std::uint8_t {
+    kHasException = 0x01,
+    kHasDuration = 0x02
+};
+
+constexpr std::string_view kMagic = "AGLB";
+
+// Upper bound on a single record, guards against corrupt length prefixes
+constexpr std::uint64_t kMaxRecordSize = 256ull * 1024 * 1024;
+
+// Field layout of Entry records, checked by the decoder
+constexpr std::string_view kEntrySchema =
+    "ts_delta:zigzag_ns,level:u8,callsite:id,logger:id,service:id,environment:id,"
+    "version:id,message:str,flags:u8,context:[key:id,tag:u8,value],"
+    "exception?:[type:str,message:str],duration?:f64";
+
+void put_varint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void put_zigzag(std::string& out, std::int64_t value) {
+    put_varint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void put_str(std::string& out, std::string_view value) {
+    put_varint(out, value.size());
+    out.append(value);
+}
+
+void put_f64(std::string& out, double value) {
+    auto bits = std::bit_cast<std::uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+void put_record(std::string& out, RecordType type, std::string_view payload) {
+    out.push_back(static_cast<char>(type));
+    put_varint(out, payload.size());
+    out.append(payload);
+}
+
+/**
+ * @brief Bounds-checked reader over a record payload.
+ */
+class Reader {
+public:
+    explicit Reader(std::string_view data) noexcept
+        : data_(data) {}
+
+    bool varint(std::uint64_t& value) noexcept {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= data_.size()) return false;
+            auto byte = static_cast<std::uint8_t>(data_[pos_++]);
+            value |= std::uint64_t{byte & 0x7Fu} << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool zigzag(std::int64_t& value) noexcept {
+        std::uint64_t raw = 0;
+        if (!varint(raw)) return false;
+        value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+        return true;
+    }
+
+    bool u8(std::uint8_t& value) noexcept {
+        if (pos_ >= data_.size()) return false;
+        value = static_cast<std::uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool str(std::string_view& value) noexcept {
+        std::uint64_t len = 0;
+        if (!varint(len) || len > data_.size() - pos_) return false;
+        value = data_.substr(pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    bool f64(double& value) noexcept {
+        if (data_.size() - pos_ < 8) return false;
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= std::uint64_t{static_cast<std::uint8_t>(data_[pos_++])} << (8 * i);
+        }
+        value = std::bit_cast<double>(bits);
+        return true;
+    }
+
+private:
+    std::string_view data_;
+    std::size_t pos_ = 0;
+};
+
+bool read_varint(std::istream& in, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        value |= std::uint64_t{static_cast<std::uint8_t>(c) & 0x7Fu} << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+}  // anonymous namespace
+
+// BinaryEncoder
+
+void BinaryEncoder::begin_session(std::string& out) {
+    strings_.clear();
+    call_sites_.clear();
+    last_timestamp_ns_ = 0;
+    in_session_ = true;
+
+    scratch_.clear();
+    scratch_.append(kMagic);
+    scratch_.push_back(static_cast<char>(kBinaryFormatVersion));
+    put_str(scratch_, kEntrySchema);
+    put_record(out, kSession, scratch_);
+}
+
+std::uint32_t BinaryEncoder::intern(std::string_view value, std::string& out) {
+    auto it = strings_.find(value);
+    if (it != strings_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<std::uint32_t>(strings_.size());
+    strings_.emplace(std::string(value), id);
+
+    scratch_.clear();
+    put_varint(scratch_, id);
+    put_str(scratch_, value);
+    put_record(out, kString, scratch_);
+    return id;
+}
+
+std::uint32_t BinaryEncoder::call_site(const SourceLocation& location, std::string& out) {
+    CallSiteKey key{intern(location.file, out), intern(location.function, out), location.line};
+
+    auto it = call_sites_.find(key);
+    if (it != call_sites_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<std::uint32_t>(call_sites_.size());
+    call_sites_.emplace(key, id);
+
+    scratch_.clear();
+    put_varint(scratch_, id);
+    put_varint(scratch_, key.file);
+    put_varint(scratch_, key.line);
+    put_varint(scratch_, key.function);
+    put_record(out, kCallSite, scratch_);
+    return id;
+}
+
+void BinaryEncoder::encode(const LogEntry& entry, std::string& out) {
+    if (!in_session_ || strings_.size() > kMaxDictionarySize) [[unlikely]] {
+        begin_session(out);
+    }
+
+    // Dictionary lookups first: they may emit definition records
+    std::uint32_t site = call_site(entry.location, out);
+    std::uint32_t logger = intern(entry.logger_name, out);
+    std::uint32_t service = intern(entry.service_name, out);
+    std::uint32_t environment = intern(entry.environment, out);
+    std::uint32_t version = intern(entry.version, out);
+
+    key_ids_.clear();
+    for (const auto& [key, value] : entry.context) {
+        key_ids_.push_back(intern(key, out));
+    }
+
+    auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        entry.timestamp.time_since_epoch()
+    ).count();
+
+    scratch_.clear();
+    put_zigzag(scratch_, ts - last_timestamp_ns_);
+    last_timestamp_ns_ = ts;
+    scratch_.push_back(static_cast<char>(entry.level));
+    put_varint(scratch_, site);
+    put_varint(scratch_, logger);
+    put_varint(scratch_, service);
+    put_varint(scratch_, environment);
+    put_varint(scratch_, version);
+    put_str(scratch_, entry.message);
+
+    std::uint8_t flags = 0;
+    if (entry.exception) flags |= kHasException;
+    if (entry.duration_ms) flags |= kHasDuration;
+    scratch_.push_back(static_cast<char>(flags));
+
+    put_varint(scratch_, entry.context.size());
+    std::size_t i = 0;
+    for (const auto& [key, value] : entry.context) {
+        put_varint(scratch_, key_ids_[i++]);
+        std::visit([this](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                scratch_.push_back(static_cast<char>(kTagString));
+                put_str(scratch_, v);
+            } else if constexpr (std::is_same_v<T, std::int64_t>) {
+                scratch_.push_back(static_cast<char>(kTagInt));
+                put_zigzag(scratch_, v);
+            } else if constexpr (std::is_same_v<T, double>) {
+                scratch_.push_back(static_cast<char>(kTagDouble));
+                put_f64(scratch_, v);
+            } else {
+                scratch_.push_back(static_cast<char>(kTagBool));
+                scratch_.push_back(static_cast<char>(v ? 1 : 0));
+            }
+        }, value);
+    }
+
+    if (entry.exception) {
+        put_str(scratch_, entry.exception->type);
+        put_str(scratch_, entry.exception->message);
+    }
+    if (entry.duration_ms) {
+        put_f64(scratch_, *entry.duration_ms);
+    }
+
+    put_record(out, kEntry, scratch_);
+}
+
+// BinaryDecoder
+
+const std::string* BinaryDecoder::string_at(std::uint64_t id) const noexcept {
+    return id < strings_.size() ? &strings_[id] : nullptr;
+}
+
+std::expected<bool, Error> BinaryDecoder::next(LogEntry& entry) {
+    auto corrupt = [](const char* what) {
+        return std::unexpected(Error{std::string("Corrupt binary log: ") + what, -1});
+    };
+
+    while (true) {
+        int type = in_.get();
+        if (type == std::char_traits<char>::eof()) {
+            return false;
+        }
+
+        std::uint64_t length = 0;
+        if (!read_varint(in_, length)) {
+            return corrupt("truncated record header");
+        }
+        if (length > kMaxRecordSize) {
+            return corrupt("record length out of range");
+        }
+        payload_.resize(length);
+        if (!in_.read(payload_.data(), static_cast<std::streamsize>(length))) {
+            return corrupt("truncated record");
+        }
+
+        Reader r(payload_);
+
+        if (type == kSession) {
+            std::string_view schema;
+            std::uint8_t version = 0;
+            if (payload_.compare(0, kMagic.size(), kMagic) != 0) {
+                return corrupt("bad magic");
+            }
+            Reader header(std::string_view(payload_).substr(kMagic.size()));
+            if (!header.u8(version) || !header.str(schema)) {
+                return corrupt("bad session header");
+            }
+            if (version != kBinaryFormatVersion || schema != kEntrySchema) {
+                return std::unexpected(Error{"Unsupported binary log version or schema", -2});
+            }
+            strings_.clear();
+            call_sites_.clear();
+            last_timestamp_ns_ = 0;
+            in_session_ = true;
+            continue;
+        }
+
+        if (!in_session_) {
+            return corrupt("record before session header");
+        }
+
+        if (type == kString) {
+            std::uint64_t id = 0;
+            std::string_view value;
+            if (!r.varint(id) || !r.str(value) || id != strings_.size()) {
+                return corrupt("bad string record");
+            }
+            strings_.emplace_back(value);
+            continue;
+        }
+
+        if (type == kCallSite) {
+            std::uint64_t id = 0, file = 0, line = 0, function = 0;
+            if (!r.varint(id) || !r.varint(file) || !r.varint(line) || !r.varint(function) ||
+                id != call_sites_.size() || !string_at(file) || !string_at(function)) {
+                return corrupt("bad call-site record");
+            }
+            call_sites_.push_back(SourceLocation{
+                *string_at(file), static_cast<std::uint32_t>(line), *string_at(function)
+            });
+            continue;
+        }
+
+        if (type != kEntry) {
+            continue;  // Unknown record type: skip for forward compatibility
+        }
+
+        std::int64_t delta = 0;
+        std::uint8_t level = 0, flags = 0;
+        std::uint64_t site = 0, logger = 0, service = 0, environment = 0, version = 0, count = 0;
+        std::string_view message;
+        if (!r.zigzag(delta) || !r.u8(level) || !r.varint(site) || !r.varint(logger) ||
+            !r.varint(service) || !r.varint(environment) || !r.varint(version) ||
+            !r.str(message) || !r.u8(flags) || !r.varint(count)) {
+            return corrupt("bad entry record");
+        }
+        if (site >= call_sites_.size() || !string_at(logger) || !string_at(service) ||
+            !string_at(environment) || !string_at(version)) {
+            return corrupt("dangling dictionary reference");
+        }
+
+        last_timestamp_ns_ += delta;
+        entry = LogEntry{};
+        entry.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(last_timestamp_ns_)
+            )
+        );
+        entry.level = static_cast<Level>(level);
+        entry.location = call_sites_[site];
+        entry.logger_name = *string_at(logger);
+        entry.service_name = *string_at(service);
+        entry.environment = *string_at(environment);
+        entry.version = *string_at(version);
+        entry.message = std::string(message);
+
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint64_t key = 0;
+            std::uint8_t tag = 0;
+            if (!r.varint(key) || !string_at(key) || !r.u8(tag)) {
+                return corrupt("bad context entry");
+            }
+            ContextValue value;
+            bool ok = false;
+            switch (tag) {
+                case kTagString: { std::string_view s; ok = r.str(s); value = std::string(s); break; }
+                case kTagInt: { std::int64_t v = 0; ok = r.zigzag(v); value = v; break; }
+                case kTagDouble: { double v = 0; ok = r.f64(v); value = v; break; }
+                case kTagBool: { std::uint8_t v = 0; ok = r.u8(v); value = (v != 0); break; }
+                default: break;
+            }
+            if (!ok) {
+                return corrupt("bad context value");
+            }
+            entry.context.emplace(*string_at(key), std::move(value));
+        }
+
+        if (flags & kHasException) {
+            std::string_view type_name, what;
+            if (!r.str(type_name) || !r.str(what)) {
+                return corrupt("bad exception");
+            }
+            entry.exception = ExceptionInfo{std::string(type_name), std::string(what)};
+        }
+        if (flags & kHasDuration) {
+            double duration = 0;
+            if (!r.f64(duration)) {
+                return corrupt("bad duration");
+            }
+            entry.duration_ms = duration;
+        }
+
+        return true;
+    }
+}
+
+}  // namespace agora::log
@@ -0,0 +1,74 @@
+/**
+ * @file cbor_writer.cpp
+ * @brief CBOR encoding primitives implementation
+ */
+
+#include <agora/log/cbor_writer.hpp>
+#include <agora/log/json_writer.hpp>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace agora::log {
+
+namespace {
+
+void put_be(std::string& out, std::uint64_t value, int bytes) {
+    char buf[8];
+    for (int i = bytes - 1; i >= 0; --i) {
+        buf[i] = static_cast<char>(value & 0xFF);
+        value >>= 8;
+    }
+    out.append(buf, static_cast<std::size_t>(bytes));
+}
+
+}  // anonymous namespace
+
+void append_cbor_head(std::string& out, CborMajor major, std::uint64_t value) {
+    auto initial = static_cast<std::uint8_t>(static_cast<std::uint8_t>(major) << 5);
+
+    if (value < 24) [[likely]] {
+        out.push_back(static_cast<char>(initial | value));
+    } else if (value <= 0xFF) {
+        out.push_back(static_cast<char>(initial | 24));
+        put_be(out, value, 1);
+    } else if (value <= 0xFFFF) {
+        out.push_back(static_cast<char>(initial | 25));
+        put_be(out, value, 2);
+    } else if (value <= 0xFFFF'FFFF) {
+        out.push_back(static_cast<char>(initial | 26));
+        put_be(out, value, 4);
+    } else {
+        out.push_back(static_cast<char>(initial | 27));
+        put_be(out, value, 8);
+    }
+}
+
+void append_cbor_text(std::string& out, std::string_view value) {
+    if (is_valid_utf8(value)) [[likely]] {
+        append_cbor_head(out, CborMajor::Text, value.size());
+        out.append(value);
+        return;
+    }
+
+    thread_local std::string sanitized;
+    sanitized.clear();
+    append_utf8_sanitized(sanitized, value);
+    append_cbor_head(out, CborMajor::Text, sanitized.size());
+    out.append(sanitized);
+}
+
+void append_cbor_double(std::string& out, double value) {
+    // Out-of-range finite values must not be narrowed (undefined behaviour)
+    bool fits = !std::isfinite(value) || std::fabs(value) <= std::numeric_limits<float>::max();
+    auto narrow = fits ? static_cast<float>(value) : 0.0f;
+    if (fits && (static_cast<double>(narrow) == value || std::isnan(value))) {
+        out.push_back(static_cast<char>(0xFA));
+        put_be(out, std::bit_cast<std::uint32_t>(narrow), 4);
+    } else {
+        out.push_back(static_cast<char>(0xFB));
+        put_be(out, std::bit_cast<std::uint64_t>(value), 8);
+    }
+}
+
+}  // namespace agora::log
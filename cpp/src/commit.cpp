@@ -0,0 +1,54 @@
+/**
+ * @file commit.cpp
+ * @brief Commit token implementation
+ */
+
+#include <agora/log/commit.hpp>
+#include <cstring>
+
+namespace agora::log {
+
+void CommitState::complete(int error_code) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error_code != 0 && error == 0) {
+            error = error_code;
+        }
+        if (remaining > 0) {
+            --remaining;
+        }
+    }
+    cv.notify_all();
+}
+
+bool CommitToken::ready() const noexcept {
+    if (!state_) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->remaining == 0;
+}
+
+std::expected<void, Error> CommitToken::wait() const {
+    if (!state_) {
+        return {};
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [this] { return state_->remaining == 0; });
+    if (state_->error != 0) {
+        return std::unexpected(Error{
+            std::string("Durable write failed: ") + std::strerror(state_->error), state_->error
+        });
+    }
+    return {};
+}
+
+bool CommitToken::wait_for(std::chrono::nanoseconds timeout) const {
+    if (!state_) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    return state_->cv.wait_for(lock, timeout, [this] { return state_->remaining == 0; });
+}
+
+}  // namespace agora::log
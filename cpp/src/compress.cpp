@@ -0,0 +1,167 @@
+/**
+ * @file compress.cpp
+ * @brief Whole-file compression for rotated log backups
+ */
+
+#include <agora/log/compress.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(AGORA_LOG_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+#if defined(AGORA_LOG_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace agora::log {
+
+namespace {
+
+constexpr std::size_t kChunkSize = 256 * 1024;
+
+Error io_error(std::string_view what, const std::filesystem::path& path) {
+    return Error{std::string(what) + ": " + path.string() + ": " + std::strerror(errno), errno};
+}
+
+#if defined(AGORA_LOG_HAVE_ZSTD)
+std::expected<void, Error> compress_zstd(std::istream& in, std::ofstream& out) {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    if (!context) {
+        return std::unexpected(Error{"Failed to create zstd context", 0});
+    }
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, 3);
+    ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+
+    std::vector<char> input(kChunkSize);
+    std::vector<char> output(ZSTD_CStreamOutSize());
+    std::expected<void, Error> result;
+
+    bool last = false;
+    while (!last && result) {
+        in.read(input.data(), static_cast<std::streamsize>(input.size()));
+        auto read = static_cast<std::size_t>(in.gcount());
+        last = read < input.size();
+        ZSTD_inBuffer in_buffer{input.data(), read, 0};
+        bool done = false;
+        while (!done) {
+            ZSTD_outBuffer out_buffer{output.data(), output.size(), 0};
+            std::size_t remaining = ZSTD_compressStream2(
+                context, &out_buffer, &in_buffer, last ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(remaining)) {
+                result = std::unexpected(Error{ZSTD_getErrorName(remaining), 0});
+                break;
+            }
+            out.write(output.data(), static_cast<std::streamsize>(out_buffer.pos));
+            done = last ? remaining == 0 : in_buffer.pos == in_buffer.size;
+        }
+    }
+
+    ZSTD_freeCCtx(context);
+    return result;
+}
+#endif
+
+#if defined(AGORA_LOG_HAVE_ZLIB)
+std::expected<void, Error> compress_zlib(std::istream& in, std::ofstream& out) {
+    z_stream stream{};
+    // 15 + 16: gzip wrapper so backups open with zcat/gunzip
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::unexpected(Error{"Failed to initialize zlib", 0});
+    }
+
+    std::vector<char> input(kChunkSize);
+    std::vector<char> output(kChunkSize);
+    std::expected<void, Error> result;
+
+    int flush = Z_NO_FLUSH;
+    while (flush != Z_FINISH && result) {
+        in.read(input.data(), static_cast<std::streamsize>(input.size()));
+        auto read = static_cast<uInt>(in.gcount());
+        flush = read < input.size() ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef*>(input.data());
+        stream.avail_in = read;
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+            if (deflate(&stream, flush) == Z_STREAM_ERROR) {
+                result = std::unexpected(Error{"zlib deflate failed", 0});
+                break;
+            }
+            out.write(output.data(), static_cast<std::streamsize>(output.size() - stream.avail_out));
+        } while (stream.avail_out == 0);
+    }
+
+    deflateEnd(&stream);
+    return result;
+}
+#endif
+
+}  // anonymous namespace
+
+Compression default_compression() noexcept {
+#if defined(AGORA_LOG_HAVE_ZSTD)
+    return Compression::Zstd;
+#elif defined(AGORA_LOG_HAVE_ZLIB)
+    return Compression::Zlib;
+#else
+    return Compression::None;
+#endif
+}
+
+std::expected<std::uint64_t, Error> compress_file(
+    std::istream& source,
+    const std::filesystem::path& destination,
+    Compression compression
+) {
+    std::ofstream out(destination, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected(io_error("Failed to create", destination));
+    }
+
+    std::expected<void, Error> result = std::unexpected(Error{
+        "Compression not available in this build: " + std::string(compression_suffix(compression)), 0});
+    switch (compression) {
+        case Compression::None:
+            if (source.peek() != std::char_traits<char>::eof()) {
+                out << source.rdbuf();
+            }
+            result = {};
+            break;
+        case Compression::Zlib:
+#if defined(AGORA_LOG_HAVE_ZLIB)
+            result = compress_zlib(source, out);
+#endif
+            break;
+        case Compression::Zstd:
+#if defined(AGORA_LOG_HAVE_ZSTD)
+            result = compress_zstd(source, out);
+#endif
+            break;
+    }
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+
+    out.flush();
+    if (!out) {
+        return std::unexpected(io_error("Failed to write", destination));
+    }
+    return static_cast<std::uint64_t>(out.tellp());
+}
+
+std::expected<std::uint64_t, Error> compress_file(
+    const std::filesystem::path& source,
+    const std::filesystem::path& destination,
+    Compression compression
+) {
+    std::ifstream in(source, std::ios::binary);
+    if (!in) {
+        return std::unexpected(io_error("Failed to open", source));
+    }
+    return compress_file(in, destination, compression);
+}
+
+}  // namespace agora::log
@@ -64,9 +64,29 @@ std::expected<Config, Error> Config::from_env(std::string_view service_name) {
     std::string level_str = getenv_or("AGORA_LOG_LEVEL", "INFO");
     config.level = from_string(level_str, Level::Info);
 
+    // Timestamp format
+    std::string timestamp_str = getenv_or("AGORA_LOG_TIMESTAMP_FORMAT", "iso8601");
+    config.timestamp_format = from_string(timestamp_str, TimestampFormat::Iso8601);
+
+    // Output profile
+    std::string profile_str = getenv_or("AGORA_LOG_OUTPUT_PROFILE", "full");
+    config.output_profile = from_string(profile_str, OutputProfile::Full);
+
+    // Record size caps
+    config.limits.max_field_bytes = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_MAX_FIELD_BYTES", 64 * 1024)
+    );
+    config.limits.max_record_bytes = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_MAX_RECORD_BYTES", 256 * 1024)
+    );
+
     // Console settings
     config.console_enabled = getenv_bool_or("AGORA_LOG_CONSOLE_ENABLED", true);
     config.console_json = getenv_bool_or("AGORA_LOG_CONSOLE_JSON", true);
+    config.console_pattern = getenv_or("AGORA_LOG_CONSOLE_PATTERN", std::string(kDefaultTextPattern));
+    config.console_buffered = getenv_bool_or("AGORA_LOG_CONSOLE_BUFFERED", false);
+    config.console_drop_when_full = getenv_bool_or("AGORA_LOG_CONSOLE_DROP_WHEN_FULL", false);
+    config.console_level = from_string(getenv_or("AGORA_LOG_CONSOLE_LEVEL", "DEBUG"), Level::Debug);
 
     // File settings
     config.file_enabled = getenv_bool_or("AGORA_LOG_FILE_ENABLED", true);
@@ -84,6 +104,85 @@ std::expected<Config, Error> Config::from_env(std::string_view service_name) {
         getenv_int_or("AGORA_LOG_MAX_BACKUP_COUNT", 5)
     );
 
+    std::string interval_str = getenv_or("AGORA_LOG_FILE_ROTATION_INTERVAL", "none");
+    config.file_rotation_interval = from_string(interval_str, RotationInterval::None);
+    std::string naming_str = getenv_or("AGORA_LOG_FILE_BACKUP_NAMING", "cascade");
+    config.file_backup_naming = from_string(naming_str, BackupNaming::Cascade);
+    config.file_compress = getenv_bool_or("AGORA_LOG_FILE_COMPRESS", false);
+    config.file_retention_max_mb = getenv_double_or("AGORA_LOG_FILE_RETENTION_MAX_MB", 0.0);
+    config.file_retention_max_age_s = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_RETENTION_MAX_AGE_S", 0)
+    );
+    config.file_retention_rescan_s = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_RETENTION_RESCAN_S", 300)
+    );
+
+    std::string file_format_str = getenv_or("AGORA_LOG_FILE_FORMAT", "json");
+    config.file_format = from_string(file_format_str, FileFormat::Json);
+    config.file_preallocate = getenv_bool_or("AGORA_LOG_FILE_PREALLOCATE", false);
+    config.file_direct_io = getenv_bool_or("AGORA_LOG_FILE_DIRECT_IO", false);
+    config.file_level = from_string(getenv_or("AGORA_LOG_FILE_LEVEL", "DEBUG"), Level::Debug);
+    config.file_spill_bytes = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_SPILL_BYTES", 4 * 1024 * 1024)
+    );
+    config.file_slow_write_ms = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_SLOW_WRITE_MS", 100)
+    );
+    config.file_retry_initial_ms = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_RETRY_INITIAL_MS", 100)
+    );
+    config.file_retry_max_ms = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_RETRY_MAX_MS", 30'000)
+    );
+
+    config.file_buffered = getenv_bool_or("AGORA_LOG_FILE_BUFFERED", false);
+    config.file_buffer_size = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_BUFFER_SIZE", 256 * 1024)
+    );
+    config.file_flush_interval_ms = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_FLUSH_INTERVAL_MS", 100)
+    );
+    config.file_io_uring = getenv_bool_or("AGORA_LOG_FILE_IO_URING", false);
+    config.file_io_uring_queue_depth = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_FILE_IO_URING_QUEUE_DEPTH", 4)
+    );
+    config.file_mmap = getenv_bool_or("AGORA_LOG_FILE_MMAP", false);
+    config.file_per_thread = getenv_bool_or("AGORA_LOG_FILE_PER_THREAD", false);
+
+    // Durable file settings
+    config.durable_file_enabled = getenv_bool_or("AGORA_LOG_DURABLE_FILE_ENABLED", false);
+    config.durable_file_path = getenv_or(
+        "AGORA_LOG_DURABLE_FILE_PATH",
+        "/var/log/agora/" + std::string(service_name) + ".audit.log"
+    );
+    config.durable_max_batch_delay_us = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_DURABLE_MAX_BATCH_DELAY_US", 0)
+    );
+
+    // Binary file settings
+    config.binary_file_enabled = getenv_bool_or("AGORA_LOG_BINARY_FILE_ENABLED", false);
+    config.binary_file_path = getenv_or(
+        "AGORA_LOG_BINARY_FILE_PATH",
+        "/var/log/agora/" + std::string(service_name) + ".binlog"
+    );
+
+    // Local daemon settings
+    config.journald_enabled = getenv_bool_or("AGORA_LOG_JOURNALD_ENABLED", false);
+    config.journald_socket = getenv_or("AGORA_LOG_JOURNALD_SOCKET", "/run/systemd/journal/socket");
+    config.syslog_enabled = getenv_bool_or("AGORA_LOG_SYSLOG_ENABLED", false);
+    config.syslog_socket = getenv_or("AGORA_LOG_SYSLOG_SOCKET", "/dev/log");
+    config.syslog_facility = static_cast<int>(getenv_int_or("AGORA_LOG_SYSLOG_FACILITY", 1));
+
+    // Parallel sink settings
+    config.sink_workers = static_cast<std::size_t>(getenv_int_or("AGORA_LOG_SINK_WORKERS", 0));
+    config.sink_queue_capacity = static_cast<std::size_t>(
+        getenv_int_or("AGORA_LOG_SINK_QUEUE_CAPACITY", 8192)
+    );
+    config.sink_drop_when_full = getenv_bool_or("AGORA_LOG_SINK_DROP_WHEN_FULL", false);
+
+    // Routing rules, e.g. "agora.audit:file=/var/log/agora/audit.log;agora.marketdata:level=INFO"
+    config.routes = parse_routes(getenv_or("AGORA_LOG_ROUTES", ""));
+
     return config;
 }
 
@@ -4,141 +4,491 @@
  */
 
 #include <agora/log/formatter.hpp>
+#include <agora/log/batch.hpp>
 #include <agora/log/level.hpp>
-#include <nlohmann/json.hpp>
-#include <iomanip>
-#include <sstream>
-#include <ctime>
+#include <agora/log/json_writer.hpp>
+#include <agora/log/cbor_writer.hpp>
+#include <agora/log/pattern.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace agora::log {
 
-using json = nlohmann::json;
+namespace {
 
 /**
- * @brief Convert context value to JSON.
+ * @brief Record field names, indexed by Key; [0] full, [1] short.
  */
-json context_value_to_json(const ContextValue& value) {
-    return std::visit([](const auto& v) -> json {
-        return v;
+enum Key : std::size_t {
+    kContext, kDuration, kEnvironment, kException, kExceptionMessage, kExceptionType,
+    kFile, kFunction, kLevel, kLine, kLoggerName, kMessage, kService, kTimestamp, kVersion
+};
+
+constexpr std::string_view kKeyNames[][2] = {
+    {"context", "ctx"},
+    {"duration_ms", "dur_ms"},
+    {"environment", "env"},
+    {"exception", "exc"},
+    {"message", "msg"},
+    {"type", "type"},
+    {"file", "file"},
+    {"function", "fn"},
+    {"level", "lvl"},
+    {"line", "line"},
+    {"logger_name", "logger"},
+    {"message", "msg"},
+    {"service", "svc"},
+    {"timestamp", "ts"},
+    {"version", "ver"}
+};
+
+constexpr std::string_view key_name(Key key, const FormatOptions& options) noexcept {
+    return kKeyNames[key][options.short_keys ? 1 : 0];
+}
+
+std::string_view function_name(const SourceLocation& location, const FormatOptions& options) noexcept {
+    return options.trim_function ? location.unqualified_function() : location.function;
+}
+
+/**
+ * @brief Append a context value as JSON.
+ */
+void append_context_value(std::string& out, const ContextValue& value) {
+    std::visit([&out](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            append_json_string(out, v);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            append_json_bool(out, v);
+        } else if constexpr (std::is_same_v<T, std::int64_t>) {
+            append_json_int(out, v);
+        } else {
+            append_json_double(out, v);
+        }
     }, value);
 }
 
 /**
- * @brief Format timestamp as ISO 8601 with microseconds.
+ * @brief Append `"key":` (with leading comma unless first).
  */
-std::string format_timestamp(std::chrono::system_clock::time_point tp) {
-    auto time_t_val = std::chrono::system_clock::to_time_t(tp);
-    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
-        tp.time_since_epoch()
-    ) % 1'000'000;
+void append_key(std::string& out, std::string_view key, bool& first) {
+    if (!first) {
+        out.push_back(',');
+    }
+    first = false;
+    append_json_string(out, key);
+    out.push_back(':');
+}
 
-    std::tm tm{};
-    gmtime_r(&time_t_val, &tm);
+/**
+ * @brief Append a fixed field name; no escaping needed.
+ */
+void append_key(std::string& out, Key key, const FormatOptions& options, bool& first) {
+    auto name = key_name(key, options);
+    if (!first) {
+        out.push_back(',');
+    }
+    first = false;
+    out.push_back('"');
+    out.append(name);
+    out.append("\":", 2);
+}
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(6) << microseconds.count();
-    oss << 'Z';
+/**
+ * @brief Append a known-ASCII string (field names, level) as CBOR text.
+ */
+void append_cbor_ascii(std::string& out, std::string_view key) {
+    append_cbor_head(out, CborMajor::Text, key.size());
+    out.append(key);
+}
 
-    return oss.str();
+void append_cbor_key(std::string& out, Key key, const FormatOptions& options) {
+    append_cbor_ascii(out, key_name(key, options));
 }
 
-std::string format_json(const LogEntry& entry) {
-    json j;
+/**
+ * @brief JSON record writer shared by format_json() and format_json_batch().
+ *
+ * Source supplies the fields of one record; append_context() writes the
+ * context members in key order and append_metadata() the escaped
+ * environment/service/version values.
+ */
+template<typename Source>
+void write_json_record(std::string& out, const Source& src, const FormatOptions& options) {
+    // Keys are written in lexicographic order (of the full names), matching
+    // the previous nlohmann::json (std::map backed) output byte for byte.
+    bool first = true;
+    out.push_back('{');
 
-    // Required fields
-    j["timestamp"] = format_timestamp(entry.timestamp);
-    j["level"] = to_string(entry.level);
-    j["message"] = entry.message;
-    j["service"] = entry.service_name;
-    j["environment"] = entry.environment;
-    j["version"] = entry.version;
-    j["logger_name"] = entry.logger_name;
+    // Context (if not empty), keys sorted
+    if (src.has_context()) {
+        append_key(out, kContext, options, first);
+        out.push_back('{');
+        src.append_context(out);
+        out.push_back('}');
+    }
 
-    // Source location (REQUIRED)
-    j["file"] = entry.location.file;
-    j["line"] = entry.location.line;
-    j["function"] = entry.location.function;
+    // Duration (if present)
+    if (const auto& duration = src.duration_ms()) {
+        append_key(out, kDuration, options, first);
+        append_json_double(out, *duration);
+    }
 
-    // Context (if not empty)
-    if (!entry.context.empty()) {
-        json context_obj;
-        for (const auto& [key, value] : entry.context) {
-            context_obj[key] = context_value_to_json(value);
-        }
-        j["context"] = context_obj;
+    if (!options.metadata_in_header) {
+        append_key(out, kEnvironment, options, first);
+        src.append_metadata(out, kEnvironment);
     }
 
     // Exception (if present)
-    if (entry.exception) {
-        j["exception"] = {
-            {"type", entry.exception->type},
-            {"message", entry.exception->message}
-        };
+    if (src.has_exception()) {
+        append_key(out, kException, options, first);
+        out.push_back('{');
+        bool first_exc = true;
+        append_key(out, kExceptionMessage, options, first_exc);
+        append_json_string(out, src.exception_message());
+        append_key(out, kExceptionType, options, first_exc);
+        append_json_string(out, src.exception_type());
+        out.push_back('}');
     }
 
-    // Duration (if present)
-    if (entry.duration_ms) {
-        j["duration_ms"] = *entry.duration_ms;
+    // Source location (file and line are always written)
+    append_key(out, kFile, options, first);
+    append_json_string(out, src.file());
+    if (options.include_function) {
+        append_key(out, kFunction, options, first);
+        append_json_string(out, function_name(SourceLocation{{}, 0, src.function()}, options));
     }
 
-    return j.dump();
+    append_key(out, kLevel, options, first);
+    out.push_back('"');
+    out.append(to_string(src.level()));
+    out.push_back('"');
+    append_key(out, kLine, options, first);
+    append_json_uint(out, src.line());
+    if (options.include_logger_name) {
+        append_key(out, kLoggerName, options, first);
+        append_json_string(out, src.logger_name());
+    }
+    append_key(out, kMessage, options, first);
+    append_json_string(out, src.message());
+    if (!options.metadata_in_header) {
+        append_key(out, kService, options, first);
+        src.append_metadata(out, kService);
+    }
+    append_key(out, kTimestamp, options, first);
+    if (options.timestamp_format == TimestampFormat::Iso8601) {
+        out.push_back('"');
+        append_iso8601_utc(out, src.timestamp());
+        out.push_back('"');
+    } else {
+        append_timestamp(out, src.timestamp(), options.timestamp_format);
+    }
+    if (!options.metadata_in_header) {
+        append_key(out, kVersion, options, first);
+        src.append_metadata(out, kVersion);
+    }
+
+    out.push_back('}');
 }
 
-std::string format_text(const LogEntry& entry) {
-    std::ostringstream oss;
+/**
+ * @brief write_json_record() source over a single LogEntry.
+ */
+struct EntrySource {
+    const LogEntry& entry;
+
+    bool has_context() const noexcept { return !entry.context.empty(); }
+
+    void append_context(std::string& out) const {
+        thread_local std::vector<const Context::value_type*> sorted;
+        sorted.clear();
+        for (const auto& kv : entry.context) {
+            sorted.push_back(&kv);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+            return a->first < b->first;
+        });
+
+        bool first = true;
+        for (const auto* kv : sorted) {
+            append_key(out, kv->first, first);
+            append_context_value(out, kv->second);
+        }
+    }
 
-    // [YYYY-MM-DD HH:MM:SS.ssssss] [LEVEL] [service] message
-    auto time_t_val = std::chrono::system_clock::to_time_t(entry.timestamp);
-    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
-        entry.timestamp.time_since_epoch()
-    ) % 1'000'000;
+    void append_metadata(std::string& out, Key key) const {
+        append_json_string(out,
+            key == kEnvironment ? entry.environment :
+            key == kService ? entry.service_name : entry.version);
+    }
 
-    std::tm tm{};
-    localtime_r(&time_t_val, &tm);
+    const std::optional<double>& duration_ms() const noexcept { return entry.duration_ms; }
+    bool has_exception() const noexcept { return entry.exception.has_value(); }
+    std::string_view exception_type() const noexcept { return entry.exception->type; }
+    std::string_view exception_message() const noexcept { return entry.exception->message; }
+    std::string_view file() const noexcept { return entry.location.file; }
+    std::string_view function() const noexcept { return entry.location.function; }
+    std::uint32_t line() const noexcept { return entry.location.line; }
+    std::string_view logger_name() const noexcept { return entry.logger_name; }
+    std::string_view message() const noexcept { return entry.message; }
+    Level level() const noexcept { return entry.level; }
+    std::chrono::system_clock::time_point timestamp() const noexcept { return entry.timestamp; }
+};
 
-    oss << '[' << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(6) << microseconds.count();
-    oss << "] ";
+/**
+ * @brief write_json_record() source over record @p index of a RecordBatch.
+ *
+ * @p metadata holds the pre-escaped environment/service/version strings,
+ * three per RecordBatch::metadata() triple.
+ */
+struct BatchSource {
+    const RecordBatch& batch;
+    std::size_t index;
+    const std::vector<std::string>& metadata;
 
-    oss << '[' << to_string(entry.level) << "] ";
-    oss << '[' << entry.service_name << "] ";
-    oss << entry.message;
+    bool has_context() const noexcept { return !batch.context(index).empty(); }
 
-    // Add context in parentheses
-    if (!entry.context.empty()) {
-        oss << " (";
+    void append_context(std::string& out) const {
         bool first = true;
-        for (const auto& [key, value] : entry.context) {
-            if (!first) oss << ", ";
-            first = false;
+        for (const auto& field : batch.context(index)) {
+            append_key(out, batch.text(field.key), first);
+            switch (field.type) {
+                case 0: append_json_string(out, batch.text(field.string)); break;
+                case 1: append_json_int(out, field.integer); break;
+                case 2: append_json_double(out, field.number); break;
+                default: append_json_bool(out, field.boolean); break;
+            }
+        }
+    }
+
+    void append_metadata(std::string& out, Key key) const {
+        std::size_t slot = key == kEnvironment ? 0 : key == kService ? 1 : 2;
+        out.append(metadata[batch.metadata_index(index) * 3 + slot]);
+    }
 
-            oss << key << '=';
-            std::visit([&oss](const auto& v) {
+    const std::optional<double>& duration_ms() const noexcept { return batch.duration_ms(index); }
+    bool has_exception() const noexcept { return batch.exception(index) != nullptr; }
+    std::string_view exception_type() const noexcept { return batch.text((*batch.exception(index))[0]); }
+    std::string_view exception_message() const noexcept { return batch.text((*batch.exception(index))[1]); }
+    std::string_view file() const noexcept { return batch.file(index); }
+    std::string_view function() const noexcept { return batch.function(index); }
+    std::uint32_t line() const noexcept { return batch.line(index); }
+    std::string_view logger_name() const noexcept { return batch.logger_name(index); }
+    std::string_view message() const noexcept { return batch.message(index); }
+    Level level() const noexcept { return batch.level(index); }
+    std::chrono::system_clock::time_point timestamp() const noexcept { return batch.timestamp(index); }
+};
+
+}  // anonymous namespace
+
+void format_json(const LogEntry& entry, std::string& out, const FormatOptions& options) {
+    write_json_record(out, EntrySource{entry}, options);
+}
+
+void format_json_batch(const RecordBatch& batch, std::string& out, const FormatOptions& options) {
+    // Escape each distinct metadata triple once for the whole batch
+    thread_local std::vector<std::string> metadata;
+    const auto& triples = batch.metadata();
+    metadata.resize(triples.size() * 3);
+    for (std::size_t t = 0; t < triples.size(); ++t) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            auto& escaped = metadata[t * 3 + k];
+            escaped.clear();
+            append_json_string(escaped, batch.text(triples[t][k]));
+        }
+    }
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        write_json_record(out, BatchSource{batch, i, metadata}, options);
+        out.push_back('\n');
+    }
+}
+
+std::string format_json(const LogEntry& entry, const FormatOptions& options) {
+    std::string out;
+    out.reserve(512);
+    format_json(entry, out, options);
+    return out;
+}
+
+void format_json_header(const LogEntry& entry, std::string& out, const FormatOptions& options) {
+    bool first = true;
+    out.append("{\"log_header\":{");
+    append_key(out, kEnvironment, options, first);
+    append_json_string(out, entry.environment);
+    append_key(out, kService, options, first);
+    append_json_string(out, entry.service_name);
+    append_key(out, kVersion, options, first);
+    append_json_string(out, entry.version);
+    out.append("}}");
+}
+
+void JsonFormatter::format(const LogEntry& entry, std::string& out) const {
+    format_json(entry, out, options_);
+    out.push_back('\n');
+}
+
+void JsonFormatter::format_header(const LogEntry& entry, std::string& out) const {
+    if (options_.metadata_in_header) {
+        format_json_header(entry, out, options_);
+        out.push_back('\n');
+    }
+}
+
+void format_cbor(const LogEntry& entry, std::string& out, const FormatOptions& options) {
+    std::uint64_t fields = 5  // file, level, line, message, timestamp
+        + (entry.context.empty() ? 0 : 1)
+        + (entry.duration_ms ? 1 : 0)
+        + (entry.exception ? 1 : 0)
+        + (options.metadata_in_header ? 0 : 3)
+        + (options.include_function ? 1 : 0)
+        + (options.include_logger_name ? 1 : 0);
+    append_cbor_head(out, CborMajor::Map, fields);
+
+    // Same key order as format_json()
+    if (!entry.context.empty()) {
+        append_cbor_key(out, kContext, options);
+        append_cbor_head(out, CborMajor::Map, entry.context.size());
+        for (const auto& [key, value] : entry.context) {
+            append_cbor_text(out, key);
+            std::visit([&out](const auto& v) {
                 using T = std::decay_t<decltype(v)>;
                 if constexpr (std::is_same_v<T, std::string>) {
-                    oss << v;
+                    append_cbor_text(out, v);
                 } else if constexpr (std::is_same_v<T, bool>) {
-                    oss << (v ? "true" : "false");
+                    append_cbor_bool(out, v);
+                } else if constexpr (std::is_same_v<T, std::int64_t>) {
+                    append_cbor_int(out, v);
                 } else {
-                    oss << v;
+                    append_cbor_double(out, v);
                 }
             }, value);
         }
-        oss << ')';
     }
 
-    // Add duration if present
     if (entry.duration_ms) {
-        oss << " [" << *entry.duration_ms << "ms]";
+        append_cbor_key(out, kDuration, options);
+        append_cbor_double(out, *entry.duration_ms);
+    }
+
+    if (!options.metadata_in_header) {
+        append_cbor_key(out, kEnvironment, options);
+        append_cbor_text(out, entry.environment);
     }
 
-    // Add exception if present
     if (entry.exception) {
-        oss << " [" << entry.exception->type << ": " << entry.exception->message << "]";
+        append_cbor_key(out, kException, options);
+        append_cbor_head(out, CborMajor::Map, 2);
+        append_cbor_key(out, kExceptionMessage, options);
+        append_cbor_text(out, entry.exception->message);
+        append_cbor_key(out, kExceptionType, options);
+        append_cbor_text(out, entry.exception->type);
+    }
+
+    append_cbor_key(out, kFile, options);
+    append_cbor_text(out, entry.location.file);
+    if (options.include_function) {
+        append_cbor_key(out, kFunction, options);
+        append_cbor_text(out, function_name(entry.location, options));
     }
+    append_cbor_key(out, kLevel, options);
+    append_cbor_ascii(out, to_string(entry.level));
+    append_cbor_key(out, kLine, options);
+    append_cbor_uint(out, entry.location.line);
+    if (options.include_logger_name) {
+        append_cbor_key(out, kLoggerName, options);
+        append_cbor_text(out, entry.logger_name);
+    }
+    append_cbor_key(out, kMessage, options);
+    append_cbor_text(out, entry.message);
+    if (!options.metadata_in_header) {
+        append_cbor_key(out, kService, options);
+        append_cbor_text(out, entry.service_name);
+    }
+
+    append_cbor_key(out, kTimestamp, options);
+    switch (options.timestamp_format) {
+        case TimestampFormat::Iso8601:
+            // "YYYY-MM-DDTHH:MM:SS.ffffffZ" is always 27 bytes
+            append_cbor_head(out, CborMajor::Text, 27);
+            append_iso8601_utc(out, entry.timestamp);
+            break;
+        case TimestampFormat::EpochMicros:
+            append_cbor_int(out, std::chrono::duration_cast<std::chrono::microseconds>(
+                entry.timestamp.time_since_epoch()).count());
+            break;
+        case TimestampFormat::EpochNanos:
+            append_cbor_int(out, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                entry.timestamp.time_since_epoch()).count());
+            break;
+    }
+
+    if (!options.metadata_in_header) {
+        append_cbor_key(out, kVersion, options);
+        append_cbor_text(out, entry.version);
+    }
+}
+
+std::string format_cbor(const LogEntry& entry, const FormatOptions& options) {
+    std::string out;
+    out.reserve(384);
+    format_cbor(entry, out, options);
+    return out;
+}
+
+void format_cbor_header(const LogEntry& entry, std::string& out, const FormatOptions& options) {
+    append_cbor_head(out, CborMajor::Map, 1);
+    append_cbor_ascii(out, "log_header");
+    append_cbor_head(out, CborMajor::Map, 3);
+    append_cbor_key(out, kEnvironment, options);
+    append_cbor_text(out, entry.environment);
+    append_cbor_key(out, kService, options);
+    append_cbor_text(out, entry.service_name);
+    append_cbor_key(out, kVersion, options);
+    append_cbor_text(out, entry.version);
+}
+
+namespace {
+
+/**
+ * @brief Append a 4-byte big-endian length prefix plus the payload
+ *        written by @p write.
+ */
+template<typename Write>
+void append_length_delimited(std::string& out, Write&& write) {
+    std::size_t start = out.size();
+    out.append(4, '\0');
+    write();
+
+    auto length = static_cast<std::uint32_t>(out.size() - start - 4);
+    out[start] = static_cast<char>(length >> 24);
+    out[start + 1] = static_cast<char>(length >> 16);
+    out[start + 2] = static_cast<char>(length >> 8);
+    out[start + 3] = static_cast<char>(length);
+}
+
+}  // anonymous namespace
+
+void CborFormatter::format(const LogEntry& entry, std::string& out) const {
+    append_length_delimited(out, [&] { format_cbor(entry, out, options_); });
+}
+
+void CborFormatter::format_header(const LogEntry& entry, std::string& out) const {
+    if (options_.metadata_in_header) {
+        append_length_delimited(out, [&] { format_cbor_header(entry, out, options_); });
+    }
+}
+
+void format_text(const LogEntry& entry, std::string& out, const FormatOptions& options) {
+    static const PatternLayout default_layout(kDefaultTextPattern);
+    default_layout.format(entry, out, options);
+}
 
-    return oss.str();
+std::string format_text(const LogEntry& entry, const FormatOptions& options) {
+    std::string out;
+    out.reserve(256);
+    format_text(entry, out, options);
+    return out;
 }
 
 }  // namespace agora::log
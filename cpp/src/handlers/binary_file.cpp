@@ -0,0 +1,90 @@
+/**
+ * @file binary_file.cpp
+ * @brief Binary file handler implementation
+ */
+
+#include <agora/log/handlers/binary_file.hpp>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+namespace agora::log {
+
+BinaryFileHandler::BinaryFileHandler(const std::filesystem::path& file_path)
+    : file_path_(file_path) {
+    open_file();
+}
+
+BinaryFileHandler::~BinaryFileHandler() noexcept {
+    close_file();
+}
+
+void BinaryFileHandler::write(const LogEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!file_.is_open()) {
+        open_file();
+    }
+
+    buffer_.clear();
+    encoder_.encode(entry, buffer_);
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    check_stream();
+}
+
+void BinaryFileHandler::flush() noexcept {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_.is_open()) {
+            file_.flush();
+            if (!file_) {
+                close_file();  // The next write reopens with a new session
+            }
+        }
+    } catch (...) {
+        // Ignore errors during flush - noexcept guarantee
+    }
+}
+
+void BinaryFileHandler::open_file() {
+    // Create parent directories if they don't exist
+    if (file_path_.has_parent_path()) {
+        std::filesystem::create_directories(file_path_.parent_path());
+    }
+
+    file_.open(file_path_, std::ios::app | std::ios::binary);
+
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to open log file: " + file_path_.string());
+    }
+
+    // New session: dictionaries written before this open are not reused
+    buffer_.clear();
+    encoder_.begin_session(buffer_);
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    check_stream();
+}
+
+void BinaryFileHandler::check_stream() {
+    if (!file_) {
+        int error = errno != 0 ? errno : EIO;
+        // The encoder's dictionaries may now be ahead of the file: close it,
+        // so the next write reopens and starts a fresh session
+        close_file();
+        throw std::system_error(error, std::generic_category(),
+            "Failed to write log file: " + file_path_.string());
+    }
+}
+
+void BinaryFileHandler::close_file() noexcept {
+    try {
+        if (file_.is_open()) {
+            file_.flush();
+            file_.close();
+        }
+    } catch (...) {
+        // Ignore errors during close - noexcept guarantee
+    }
+}
+
+}  // namespace agora::log
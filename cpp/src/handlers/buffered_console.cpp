@@ -0,0 +1,161 @@
+/**
+ * @file buffered_console.cpp
+ * @brief Batched console handler implementation
+ */
+
+#include <agora/log/handlers/buffered_console.hpp>
+#include <agora/log/formatter.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+
+namespace agora::log {
+
+BufferedConsoleHandler::BufferedConsoleHandler(
+    std::shared_ptr<const Formatter> formatter,
+    std::size_t buffer_size,
+    std::size_t flush_interval_ms,
+    bool drop_when_full,
+    int stdout_fd,
+    int stderr_fd
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , buffer_size_(std::max<std::size_t>(buffer_size, 1))
+    , flush_interval_ms_(std::max<std::size_t>(flush_interval_ms, 1))
+    , drop_when_full_(drop_when_full)
+    , out_{stdout_fd, {}, {}}
+    , err_{stderr_fd, {}, {}} {
+
+    // Preallocate so appending never allocates in steady state
+    for (Stream* stream : {&out_, &err_}) {
+        stream->front.reserve(buffer_size_);
+        stream->back.reserve(buffer_size_);
+    }
+
+    writer_thread_ = std::thread(&BufferedConsoleHandler::writer_thread_func, this);
+}
+
+BufferedConsoleHandler::~BufferedConsoleHandler() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    space_cv_.notify_all();
+
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    // Final flush of any remaining records
+    write_buffers();
+}
+
+bool BufferedConsoleHandler::has_room(const Stream& stream, std::size_t size) const noexcept {
+    // A record larger than the buffer still fits into an empty one
+    return stream.front.empty() || stream.front.size() + size <= buffer_size_;
+}
+
+void BufferedConsoleHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (header_pending_) {
+        header_pending_ = false;
+        formatter_->format_header(entry, out_.front);
+    }
+
+    // Use stderr for ERROR and CRITICAL, stdout for others
+    Stream& stream = (entry.level >= Level::Error) ? err_ : out_;
+    if (!has_room(stream, record.size())) [[unlikely]] {
+        if (drop_when_full_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        flush_requested_ = true;
+        cv_.notify_one();
+        space_cv_.wait(lock, [&] { return has_room(stream, record.size()) || stop_; });
+    }
+
+    stream.front.append(record);
+    ++stream.front_records;
+    entries_written_.fetch_add(1, std::memory_order_relaxed);
+
+    // Start writing at half full, so callers keep the other half while the
+    // writer thread is busy
+    if (stream.front.size() >= buffer_size_ / 2 && !flush_requested_) {
+        flush_requested_ = true;
+        cv_.notify_one();
+    }
+}
+
+void BufferedConsoleHandler::flush() noexcept {
+    write_buffers();
+}
+
+void BufferedConsoleHandler::write_buffers() {
+    std::lock_guard<std::mutex> io_lock(io_mutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_requested_ = false;
+        // Back buffers are always empty here: they are only filled and
+        // drained under io_mutex_
+        for (Stream* stream : {&out_, &err_}) {
+            std::swap(stream->front, stream->back);
+            std::swap(stream->front_records, stream->back_records);
+        }
+    }
+    space_cv_.notify_all();
+
+    // Write outside of mutex_ so application threads keep appending
+    write_batch(out_);
+    write_batch(err_);
+}
+
+void BufferedConsoleHandler::write_batch(Stream& stream) noexcept {
+    const char* data = stream.back.data();
+    std::size_t size = stream.back.size();
+
+    while (size > 0) {
+        ssize_t n = ::write(stream.fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Someone else made the descriptor non-blocking; wait for the reader
+                pollfd pfd{stream.fd, POLLOUT, 0};
+                (void)::poll(&pfd, 1, -1);
+                continue;
+            }
+            // Nowhere left to report to; account for the lost records
+            dropped_.fetch_add(stream.back_records, std::memory_order_relaxed);
+            break;
+        }
+        write_calls_.fetch_add(1, std::memory_order_relaxed);
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+
+    stream.back.clear();
+    stream.back_records = 0;
+}
+
+void BufferedConsoleHandler::writer_thread_func() {
+    using namespace std::chrono;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        cv_.wait_for(lock, milliseconds(flush_interval_ms_), [this] {
+            return flush_requested_ || stop_;
+        });
+
+        // Write to the descriptors (the destructor drains whatever is left after stop)
+        lock.unlock();
+        write_buffers();
+        lock.lock();
+    }
+}
+
+}  // namespace agora::log
@@ -4,28 +4,47 @@
  */
 
 #include <agora/log/handlers/buffered_file.hpp>
+#include <agora/log/handlers/rotating_file.hpp>
 #include <agora/log/formatter.hpp>
-#include <stdexcept>
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <iostream>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace agora::log {
 
+namespace fs = std::filesystem;
+
 BufferedFileHandler::BufferedFileHandler(
-    const std::filesystem::path& file_path,
+    const fs::path& file_path,
     std::size_t buffer_size,
-    std::size_t flush_interval_ms
+    std::size_t flush_interval_ms,
+    std::shared_ptr<const Formatter> formatter,
+    std::size_t max_size_bytes,
+    std::size_t max_backup_count
 )
-    : file_path_(file_path)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , file_path_(file_path)
     , buffer_size_(buffer_size)
-    , flush_interval_ms_(flush_interval_ms) {
+    , flush_interval_ms_(std::max<std::size_t>(flush_interval_ms, 1))
+    , max_size_bytes_(max_size_bytes)
+    , max_backup_count_(max_backup_count) {
 
-    // Reserve space in buffers
-    front_buffer_.reserve(buffer_size / 100);  // Estimate ~100 bytes per entry
-    back_buffer_.reserve(buffer_size / 100);
+    // Preallocate both buffers so appending never allocates in steady state
+    front_buffer_.reserve(buffer_size_);
+    back_buffer_.reserve(buffer_size_);
 
     open_file();
 
+    struct stat st{};
+    if (::fstat(fd_, &st) == 0) {
+        file_size_ = static_cast<std::size_t>(st.st_size);
+    }
+
     // Start background flush thread
     flush_thread_ = std::thread(&BufferedFileHandler::flush_thread_func, this);
 }
@@ -42,32 +61,40 @@ BufferedFileHandler::~BufferedFileHandler() noexcept {
 
     // Final flush of any remaining entries
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!front_buffer_.empty()) {
-            swap_buffers();
-            flush_back_buffer();
-        }
-    } catch (...) {
-        // Ignore errors during destruction
+        write_buffers();
+    } catch (const std::exception& e) {
+        std::cerr << "BufferedFileHandler flush error: " << e.what() << std::endl;
     }
 
     close_file();
 }
 
-void BufferedFileHandler::write(const LogEntry& entry) {
-    std::string formatted = format_json(entry);
-    formatted += '\n';
-    std::size_t entry_size = formatted.size();
-
+void BufferedFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    // Rotate before this record if it would overflow the current file
+    if (max_size_bytes_ > 0 && !rotation_disabled_.load(std::memory_order_relaxed) &&
+        file_size_ + record.size() > max_size_bytes_) {
+        front_rotations_.push_back(front_buffer_.size());
+        file_size_ = 0;
+        header_pending_ = true;
+    }
+
+    // Stream header at the start of each file
+    if (header_pending_) {
+        header_pending_ = false;
+        std::size_t before = front_buffer_.size();
+        formatter_->format_header(entry, front_buffer_);
+        file_size_ += front_buffer_.size() - before;
+    }
+
     // Add to front buffer
-    front_buffer_.push_back(std::move(formatted));
-    front_buffer_bytes_ += entry_size;
+    front_buffer_.append(record);
+    file_size_ += record.size();
     entries_written_.fetch_add(1, std::memory_order_relaxed);
 
     // Check if we should trigger a flush
-    if (front_buffer_bytes_ >= buffer_size_) {
+    if (front_buffer_.size() >= buffer_size_ && !flush_requested_.load(std::memory_order_relaxed)) {
         flush_requested_.store(true);
         cv_.notify_one();
     }
@@ -75,100 +102,130 @@ void BufferedFileHandler::write(const LogEntry& entry) {
 
 void BufferedFileHandler::flush() noexcept {
     try {
-        // Request immediate flush
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (!front_buffer_.empty()) {
-                flush_requested_.store(true);
-                cv_.notify_one();
-            }
-        }
-
-        // Wait for flush to complete (with timeout)
-        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
-        while (flush_requested_.load() && std::chrono::steady_clock::now() < deadline) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        write_buffers();
+    } catch (const std::exception& e) {
+        std::cerr << "BufferedFileHandler flush error: " << e.what() << std::endl;
     } catch (...) {
-        // Ignore errors during flush
+        // Ignore errors during flush - noexcept guarantee
     }
 }
 
 void BufferedFileHandler::open_file() {
     // Create parent directories if they don't exist
     if (file_path_.has_parent_path()) {
-        std::filesystem::create_directories(file_path_.parent_path());
+        fs::create_directories(file_path_.parent_path());
     }
 
-    file_.open(file_path_, std::ios::app);
+    fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
 
-    if (!file_.is_open()) {
-        throw std::runtime_error("Failed to open log file: " + file_path_.string());
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open log file: " + file_path_.string());
     }
 }
 
 void BufferedFileHandler::close_file() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void BufferedFileHandler::rotate() {
     try {
-        if (file_.is_open()) {
-            file_.flush();
-            file_.close();
+        close_file();
+        rotate_backups(file_path_, max_backup_count_);
+        open_file();
+    } catch (const std::exception& e) {
+        // A failed rename or reopen (a plain system_error from open_file());
+        // log to stderr - logging should never crash the application
+        std::cerr << "Log file rotation failed: " << e.what() << std::endl;
+
+        // Keep appending to the original file; stop rotating if it cannot be reopened
+        try {
+            if (fd_ < 0) {
+                open_file();
+            }
+        } catch (...) {
+            std::cerr << "Failed to reopen log file after rotation failure. "
+                      << "Disabling file rotation." << std::endl;
+            rotation_disabled_.store(true);
         }
-    } catch (...) {
-        // Ignore errors during close
     }
 }
 
-void BufferedFileHandler::swap_buffers() {
-    // Swap front and back buffers
-    std::swap(front_buffer_, back_buffer_);
-    front_buffer_bytes_ = 0;
-    front_buffer_.clear();
-}
+void BufferedFileHandler::write_buffers() {
+    std::lock_guard<std::mutex> io_lock(io_mutex_);
 
-void BufferedFileHandler::flush_back_buffer() {
-    if (back_buffer_.empty() || !file_.is_open()) {
-        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_requested_.store(false);
+        if (front_buffer_.empty()) {
+            return;
+        }
+        // Back buffer is always empty here: it is only filled and drained
+        // under io_mutex_
+        std::swap(front_buffer_, back_buffer_);
+        std::swap(front_rotations_, back_rotations_);
     }
 
-    // Write all entries from back buffer to file
-    for (const auto& entry : back_buffer_) {
-        file_ << entry;
+    // Write outside of mutex_ so application threads keep appending
+    std::size_t offset = 0;
+    try {
+        for (std::size_t rotation : back_rotations_) {
+            write_all(back_buffer_.data() + offset, rotation - offset);
+            offset = rotation;
+            rotate();
+        }
+        write_all(back_buffer_.data() + offset, back_buffer_.size() - offset);
+    } catch (...) {
+        back_buffer_.clear();
+        back_rotations_.clear();
+        throw;
     }
-    file_.flush();
 
     back_buffer_.clear();
+    back_rotations_.clear();
+}
+
+void BufferedFileHandler::write_all(const char* data, std::size_t size) {
+    if (fd_ < 0) {
+        open_file();
+    }
+
+    while (size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                "Failed to write log file: " + file_path_.string());
+        }
+        write_calls_.fetch_add(1, std::memory_order_relaxed);
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
 }
 
 void BufferedFileHandler::flush_thread_func() {
     using namespace std::chrono;
 
     while (!stop_.load()) {
-        std::unique_lock<std::mutex> lock(mutex_);
-
-        // Wait for flush request or timeout
-        cv_.wait_for(lock, milliseconds(flush_interval_ms_), [this] {
-            return flush_requested_.load() || stop_.load();
-        });
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
 
-        if (stop_.load() && front_buffer_.empty()) {
-            break;
+            // Wait for flush request or timeout
+            cv_.wait_for(lock, milliseconds(flush_interval_ms_), [this] {
+                return flush_requested_.load() || stop_.load();
+            });
         }
 
-        // Check if there's data to flush
-        if (!front_buffer_.empty()) {
-            swap_buffers();
-            lock.unlock();
-
-            // Write to file (outside of lock)
-            try {
-                flush_back_buffer();
-            } catch (const std::exception& e) {
-                std::cerr << "BufferedFileHandler flush error: " << e.what() << std::endl;
-            }
-
-            flush_requested_.store(false);
-        } else {
-            flush_requested_.store(false);
+        // Write to file (the destructor drains whatever is left after stop)
+        try {
+            write_buffers();
+        } catch (const std::exception& e) {
+            std::cerr << "BufferedFileHandler flush error: " << e.what() << std::endl;
         }
     }
 }
@@ -5,25 +5,44 @@
 
 #include <agora/log/handlers/console.hpp>
 #include <agora/log/formatter.hpp>
+#include <agora/log/pattern.hpp>
 #include <iostream>
 
 namespace agora::log {
 
-ConsoleHandler::ConsoleHandler(bool json_format) noexcept
-    : json_format_(json_format) {
+ConsoleHandler::ConsoleHandler(
+    bool json_format,
+    FormatOptions options,
+    std::string_view text_pattern
+)
+    : ConsoleHandler(json_format
+        ? std::shared_ptr<const Formatter>(std::make_shared<JsonFormatter>(options))
+        : std::make_shared<PatternFormatter>(text_pattern, options)) {
 }
 
-void ConsoleHandler::write(const LogEntry& entry) {
-    std::string formatted = json_format_
-        ? format_json(entry)
-        : format_text(entry);
+ConsoleHandler::ConsoleHandler(std::shared_ptr<const Formatter> formatter) noexcept
+    : Handler(std::move(formatter))
+    , json_format_(dynamic_cast<const JsonFormatter*>(formatter_.get()) != nullptr) {
+}
+
+void ConsoleHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    std::call_once(header_once_, [&] {
+        if (!formatter_) {
+            return;
+        }
+        std::string header;
+        formatter_->format_header(entry, header);
+        if (!header.empty()) {
+            std::cout.write(header.data(), static_cast<std::streamsize>(header.size()));
+            std::cout.flush();
+        }
+    });
 
     // Use stderr for ERROR and CRITICAL, stdout for others
-    if (entry.level >= Level::Error) {
-        std::cerr << formatted << std::endl;
-    } else {
-        std::cout << formatted << std::endl;
-    }
+    auto& stream = (entry.level >= Level::Error) ? std::cerr : std::cout;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    stream.flush();
 }
 
 void ConsoleHandler::flush() noexcept {
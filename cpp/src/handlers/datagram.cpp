@@ -0,0 +1,231 @@
+/**
+ * @file datagram.cpp
+ * @brief Batched Unix datagram sender implementation
+ */
+
+#include <agora/log/handlers/datagram.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace {
+
+constexpr std::size_t kMaxBatch = 64;  // Datagrams per sendmmsg(2)
+
+}  // anonymous namespace
+
+DatagramHandler::DatagramHandler(
+    std::shared_ptr<const Formatter> formatter,
+    const std::filesystem::path& socket_path,
+    std::size_t buffer_size,
+    std::size_t flush_interval_ms
+)
+    : Handler(std::move(formatter))
+    , socket_path_(socket_path)
+    , buffer_size_(std::max<std::size_t>(buffer_size, 1))
+    , flush_interval_ms_(std::max<std::size_t>(flush_interval_ms, 1)) {
+
+    const std::string& path = socket_path_.native();
+    if (path.size() >= sizeof(address_.sun_path)) {
+        throw std::system_error(ENAMETOOLONG, std::generic_category(),
+            "Log socket path too long: " + path);
+    }
+    address_.sun_family = AF_UNIX;
+    std::memcpy(address_.sun_path, path.c_str(), path.size() + 1);
+    address_size_ = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to create log socket for " + path);
+    }
+
+    // The daemon may start later; sends reconnect
+    (void)connect_socket();
+
+    // Preallocate so queuing never allocates in steady state
+    front_.reserve(buffer_size_);
+    back_.reserve(buffer_size_);
+
+    sender_thread_ = std::thread(&DatagramHandler::sender_thread_func, this);
+}
+
+DatagramHandler::~DatagramHandler() noexcept {
+    stop();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void DatagramHandler::stop() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_.store(true);
+    }
+    cv_.notify_all();
+
+    if (sender_thread_.joinable()) {
+        sender_thread_.join();
+    }
+
+    // Final send of any remaining records
+    send_buffers();
+}
+
+void DatagramHandler::write_formatted(const LogEntry& /*entry*/, std::string_view record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Never block the caller: a full queue drops the record
+    if (!front_.empty() && front_.size() + record.size() > buffer_size_) [[unlikely]] {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    front_.append(record);
+    front_ends_.push_back(front_.size());
+
+    if ((front_ends_.size() >= kMaxBatch || front_.size() >= buffer_size_ / 2) && !flush_requested_) {
+        flush_requested_ = true;
+        cv_.notify_one();
+    }
+}
+
+void DatagramHandler::flush() noexcept {
+    send_buffers();
+}
+
+bool DatagramHandler::send_oversized(std::string_view /*datagram*/) noexcept {
+    return false;
+}
+
+bool DatagramHandler::connect_socket() noexcept {
+    return ::connect(fd_, reinterpret_cast<const sockaddr*>(&address_), address_size_) == 0;
+}
+
+void DatagramHandler::send_buffers() {
+    std::lock_guard<std::mutex> io_lock(io_mutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_requested_ = false;
+        if (front_ends_.empty()) {
+            return;
+        }
+        // Back buffer is always empty here: it is only filled and drained
+        // under io_mutex_
+        std::swap(front_, back_);
+        std::swap(front_ends_, back_ends_);
+    }
+
+    // Send outside of mutex_ so application threads keep queuing
+    send_batch();
+    back_.clear();
+    back_ends_.clear();
+}
+
+void DatagramHandler::send_batch() {
+    mmsghdr messages[kMaxBatch];
+    iovec vectors[kMaxBatch];
+
+    std::size_t count = back_ends_.size();
+    std::size_t next = 0;
+    bool reconnected = false;
+    int stalls = 0;
+    auto record = [&](std::size_t index) {
+        std::size_t begin = index == 0 ? 0 : back_ends_[index - 1];
+        return std::string_view(back_.data() + begin, back_ends_[index] - begin);
+    };
+
+    while (next < count) {
+        std::size_t batch = std::min(kMaxBatch, count - next);
+        for (std::size_t i = 0; i < batch; ++i) {
+            auto datagram = record(next + i);
+            vectors[i] = {const_cast<char*>(datagram.data()), datagram.size()};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent = ::sendmmsg(fd_, messages, static_cast<unsigned int>(batch), 0);
+        if (sent > 0) {
+            send_calls_.fetch_add(1, std::memory_order_relaxed);
+            entries_sent_.fetch_add(static_cast<std::size_t>(sent), std::memory_order_relaxed);
+            next += static_cast<std::size_t>(sent);
+            error_reported_ = false;
+            continue;
+        }
+
+        // The first datagram of the batch failed
+        int error = sent < 0 ? errno : EIO;
+        if (error == EINTR) {
+            continue;
+        }
+        if (error == EAGAIN || error == EWOULDBLOCK) {
+            // Daemon queue full: wait here (not in the callers); give up on
+            // the rest when stopping and the daemon does not drain
+            pollfd pfd{fd_, POLLOUT, 0};
+            int ready = ::poll(&pfd, 1, 100);
+            if (stop_.load() && (ready == 0 || ++stalls > 10)) {
+                dropped_.fetch_add(count - next, std::memory_order_relaxed);
+                report_error(error);
+                return;
+            }
+            continue;
+        }
+        if (error == ECONNREFUSED || error == ENOTCONN || error == EDESTADDRREQ) {
+            // Daemon restarted (or was not up yet): reconnect once per batch
+            if (!reconnected) {
+                reconnected = true;
+                if (connect_socket()) {
+                    continue;
+                }
+                error = errno;
+            }
+            dropped_.fetch_add(count - next, std::memory_order_relaxed);
+            report_error(error);
+            return;
+        }
+        if (error == EMSGSIZE && send_oversized(record(next))) {
+            entries_sent_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            report_error(error);
+        }
+        ++next;
+    }
+}
+
+void DatagramHandler::report_error(int error) noexcept {
+    if (error_reported_) {
+        return;
+    }
+    error_reported_ = true;
+    std::cerr << "Failed to send log record to " << socket_path_.string() << ": "
+              << std::strerror(error) << std::endl;
+}
+
+void DatagramHandler::sender_thread_func() {
+    using namespace std::chrono;
+
+    while (!stop_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, milliseconds(flush_interval_ms_), [this] {
+                return flush_requested_ || stop_.load();
+            });
+        }
+
+        // Send (stop() drains whatever is left)
+        send_buffers();
+    }
+}
+
+}  // namespace agora::log
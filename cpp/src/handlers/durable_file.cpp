@@ -0,0 +1,191 @@
+/**
+ * @file durable_file.cpp
+ * @brief Group-commit durable file handler implementation
+ */
+
+#include <agora/log/handlers/durable_file.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace fs = std::filesystem;
+
+DurableFileHandler::DurableFileHandler(
+    const fs::path& file_path,
+    std::shared_ptr<const Formatter> formatter,
+    std::chrono::microseconds max_batch_delay,
+    std::size_t max_batch_bytes
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , file_path_(file_path)
+    , max_batch_delay_(std::max(max_batch_delay, std::chrono::microseconds(0)))
+    , max_batch_bytes_(std::max<std::size_t>(max_batch_bytes, 1)) {
+
+    open_file();
+
+    committer_thread_ = std::thread(&DurableFileHandler::committer_thread_func, this);
+}
+
+DurableFileHandler::~DurableFileHandler() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    pending_cv_.notify_all();
+
+    // The committer commits everything pending before it exits
+    if (committer_thread_.joinable()) {
+        committer_thread_.join();
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void DurableFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (header_pending_) [[unlikely]] {
+            header_pending_ = false;
+            thread_local std::string header;
+            header.clear();
+            formatter_->format_header(entry, header);
+            pending_.append(header);
+        }
+
+        pending_.append(record);
+        ++appended_;
+        if (entry.commit) {
+            pending_commits_.push_back(entry.commit);
+        }
+    }
+    pending_cv_.notify_one();
+}
+
+void DurableFileHandler::flush() noexcept {
+    try {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::uint64_t target = appended_;
+        committed_cv_.wait(lock, [&] { return committed_ >= target; });
+    } catch (...) {
+        // Ignore errors during flush - noexcept guarantee
+    }
+}
+
+void DurableFileHandler::open_file() {
+    if (file_path_.has_parent_path()) {
+        fs::create_directories(file_path_.parent_path());
+    }
+    bool created = !fs::exists(file_path_);
+
+    fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open durable log file: " + file_path_.string());
+    }
+
+    // A new file is only durable once its directory entry is
+    if (created) {
+        fs::path directory = file_path_.has_parent_path() ? file_path_.parent_path() : fs::path(".");
+        int dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) {
+            ::fsync(dir_fd);
+            ::close(dir_fd);
+        }
+    }
+}
+
+int DurableFileHandler::commit_batch() noexcept {
+    int error = 0;
+
+    const char* data = batch_.data();
+    std::size_t size = batch_.size();
+    while (size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = errno;
+            break;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+
+    if (error == 0) {
+        while (::fdatasync(fd_) != 0) {
+            if (errno != EINTR) {
+                error = errno;
+                break;
+            }
+        }
+        sync_calls_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (error != 0) {
+        if (!error_reported_) {
+            error_reported_ = true;
+            std::cerr << "Failed to commit durable log records to " << file_path_.string() << ": "
+                      << std::strerror(error) << std::endl;
+        }
+    } else {
+        error_reported_ = false;
+    }
+    return error;
+}
+
+void DurableFileHandler::committer_thread_func() {
+    using namespace std::chrono;
+
+    std::uint64_t taken = 0;
+
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        pending_cv_.wait(lock, [&] { return appended_ > taken || stop_; });
+        if (appended_ == taken) {
+            return;  // Stopping with nothing pending
+        }
+
+        // Optionally let more writers join this batch
+        if (max_batch_delay_.count() > 0 && !stop_) {
+            auto deadline = steady_clock::now() + max_batch_delay_;
+            pending_cv_.wait_until(lock, deadline, [&] {
+                return stop_ || pending_.size() >= max_batch_bytes_;
+            });
+        }
+
+        // Take the batch; writers keep appending to the other buffer while
+        // this one is written and synced
+        batch_.swap(pending_);
+        batch_commits_.swap(pending_commits_);
+        std::uint64_t through = appended_;
+        lock.unlock();
+
+        int error = commit_batch();
+        if (error == 0) {
+            records_committed_.fetch_add(static_cast<std::size_t>(through - taken), std::memory_order_relaxed);
+        }
+        for (const auto& commit : batch_commits_) {
+            commit->complete(error);
+        }
+        batch_commits_.clear();
+        batch_.clear();
+        taken = through;
+
+        lock.lock();
+        committed_ = through;
+        lock.unlock();
+        committed_cv_.notify_all();
+    }
+}
+
+}  // namespace agora::log
@@ -5,56 +5,253 @@
 
 #include <agora/log/handlers/file.hpp>
 #include <agora/log/formatter.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
 #include <stdexcept>
+#include <system_error>
+#include <time.h>
 
 namespace agora::log {
 
-FileHandler::FileHandler(const std::filesystem::path& file_path)
-    : file_path_(file_path) {
+namespace {
+
+// Latency spikes are tens of milliseconds; the coarse clock (a few ms
+// resolution) is enough and costs a fraction of CLOCK_MONOTONIC
+std::chrono::nanoseconds coarse_now() noexcept {
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+}  // anonymous namespace
+
+FileHandler::FileHandler(
+    const std::filesystem::path& file_path,
+    std::shared_ptr<const Formatter> formatter,
+    SegmentOptions segment,
+    SpillOptions spill
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , file_path_(file_path)
+    , segment_options_(segment)
+    , spill_options_(spill)
+    , spill_(spill.spill_bytes) {
     open_file();
 }
 
 FileHandler::~FileHandler() noexcept {
+    // Last chance for records spilled during an outage
+    if (disk_stats_.degraded && !spill_.empty()) {
+        std::size_t written = 0;
+        try {
+            retry_disk(nullptr, written);
+        } catch (...) {
+        }
+        if (!spill_.empty()) {
+            std::cerr << "Log file " << file_path_.string() << " still failing at close; "
+                      << spill_.size() << " spilled records lost" << std::endl;
+        }
+    }
     close_file();
 }
 
-void FileHandler::write(const LogEntry& entry) {
-    std::string formatted = format_json(entry);
+void FileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_guarded(entry, record);
+}
 
+DiskStats FileHandler::disk_stats() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    DiskStats stats = disk_stats_;
+    stats.shed = spill_.shed();
+    stats.spill_bytes = spill_.bytes();
+    return stats;
+}
 
-    if (!file_.is_open()) {
-        open_file();
+std::size_t FileHandler::write_guarded(const LogEntry& entry, std::string_view record) {
+    std::size_t written = 0;
+
+    if (disk_stats_.degraded) [[unlikely]] {
+        // Until the backoff expires, the disk is not touched at all
+        if (coarse_now() < retry_at_ || !retry_disk(&entry, written)) {
+            spill(entry.level, record);
+            return written;
+        }
     }
 
-    file_ << formatted << '\n';
+    bool timed = spill_options_.slow_write.count() > 0;
+    std::chrono::nanoseconds start = timed ? coarse_now() : std::chrono::nanoseconds{0};
+    try {
+        if (!is_open()) {
+            open_file();
+        }
+        written += write_header(entry);
+        write_bytes(record);
+        check_stream();
+        written += record.size();
+    } catch (const std::exception& e) {
+        ++disk_stats_.write_errors;
+        close_file();
+        degrade(e.what());
+        spill(entry.level, record);
+        return written;
+    }
+
+    if (timed && coarse_now() - start > spill_options_.slow_write) [[unlikely]] {
+        ++disk_stats_.slow_writes;
+        degrade("write stalled");
+    }
+    return written;
+}
+
+void FileHandler::check_stream() {
+    if (!use_segment() && !file_) {
+        int error = errno != 0 ? errno : EIO;
+        throw std::system_error(error, std::generic_category(),
+            "Failed to write log file: " + file_path_.string());
+    }
+}
+
+void FileHandler::degrade(const char* reason) {
+    disk_stats_.degraded = true;
+    ++disk_stats_.degradations;
+    retry_delay_ = spill_options_.retry_initial;
+    retry_at_ = coarse_now() + retry_delay_;
+    std::cerr << "Log file " << file_path_.string() << " degraded (" << reason
+              << "); keeping records in memory" << std::endl;
+}
+
+void FileHandler::spill(Level level, std::string_view record) {
+    if (spill_.push(level, record)) {
+        ++disk_stats_.spilled;
+    }
+}
+
+bool FileHandler::retry_disk(const LogEntry* entry, std::size_t& written) {
+    ++disk_stats_.retries;
+    std::chrono::nanoseconds start = coarse_now();
+    std::uint64_t replayed = 0;
+
+    try {
+        if (!is_open()) {
+            open_file();
+        }
+        if (entry) {
+            written += write_header(*entry);
+        }
+        while (!spill_.empty()) {
+            std::string_view record = spill_.front();
+            write_bytes(record);
+            check_stream();
+            written += record.size();
+            spill_.pop_front();
+            ++replayed;
+        }
+        disk_stats_.replayed += replayed;
+    } catch (...) {
+        disk_stats_.replayed += replayed;
+        ++disk_stats_.write_errors;
+        close_file();
+        retry_delay_ = std::min(retry_delay_ * 2, spill_options_.retry_max);
+        retry_at_ = coarse_now() + retry_delay_;
+        return false;
+    }
+
+    // Still stalling: stay degraded, but what was replayed is written
+    if (spill_options_.slow_write.count() > 0 && coarse_now() - start > spill_options_.slow_write) {
+        ++disk_stats_.slow_writes;
+        retry_delay_ = std::min(retry_delay_ * 2, spill_options_.retry_max);
+        retry_at_ = coarse_now() + retry_delay_;
+        return false;
+    }
+
+    disk_stats_.degraded = false;
+    ++disk_stats_.recoveries;
+    std::uint64_t shed = 0;
+    for (auto count : spill_.shed()) {
+        shed += count;
+    }
+    std::cerr << "Log file " << file_path_.string() << " recovered; " << replayed
+              << " records replayed, " << shed << " shed so far" << std::endl;
+    return true;
 }
 
 void FileHandler::flush() noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (file_.is_open()) {
-            file_.flush();
-        }
+        flush_file();
     } catch (...) {
         // Ignore errors during flush - noexcept guarantee
     }
 }
 
+void FileHandler::flush_file() noexcept {
+    if (!is_open()) {
+        return;
+    }
+    try {
+        if (use_segment()) {
+            segment_.flush();
+        } else {
+            file_.flush();
+            check_stream();
+        }
+    } catch (const std::exception& e) {
+        // The buffered records are lost; later ones are spilled until a retry succeeds
+        ++disk_stats_.write_errors;
+        close_file();
+        if (!disk_stats_.degraded) {
+            degrade(e.what());
+        }
+    }
+}
+
 void FileHandler::open_file() {
+    header_pending_ = true;
+    std::filesystem::path path = live_path();
+
+    if (use_segment()) {
+        segment_.open(path, segment_options_);
+        return;
+    }
+
     // Create parent directories if they don't exist
-    if (file_path_.has_parent_path()) {
-        std::filesystem::create_directories(file_path_.parent_path());
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
     }
 
-    file_.open(file_path_, std::ios::app);
+    file_.open(path, std::ios::app | std::ios::binary);
 
     if (!file_.is_open()) {
-        throw std::runtime_error("Failed to open log file: " + file_path_.string());
+        throw std::runtime_error("Failed to open log file: " + path.string());
+    }
+}
+
+std::size_t FileHandler::write_header(const LogEntry& entry) {
+    if (!header_pending_) {
+        return 0;
+    }
+    header_pending_ = false;
+
+    thread_local std::string header;
+    header.clear();
+    formatter_->format_header(entry, header);
+    write_bytes(header);
+    return header.size();
+}
+
+void FileHandler::write_bytes(std::string_view bytes) {
+    if (use_segment()) {
+        segment_.write(bytes);
+    } else {
+        file_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
     }
 }
 
 void FileHandler::close_file() noexcept {
+    segment_.close();
+
     try {
         if (file_.is_open()) {
             file_.flush();
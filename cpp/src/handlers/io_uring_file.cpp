@@ -0,0 +1,761 @@
+/**
+ * @file io_uring_file.cpp
+ * @brief io_uring file handler implementation
+ *
+ * Talks to the kernel through the raw io_uring_setup/enter/register
+ * syscalls, so no liburing dependency is needed.
+ */
+
+#include <agora/log/handlers/io_uring_file.hpp>
+#include <agora/log/handlers/buffered_file.hpp>
+#include <agora/log/handlers/rotating_file.hpp>
+#include <agora/log/formatter.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define AGORA_LOG_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#define AGORA_LOG_HAS_IO_URING 0
+#endif
+
+namespace agora::log {
+
+namespace fs = std::filesystem;
+
+#if AGORA_LOG_HAS_IO_URING
+
+/**
+ * @brief Minimal io_uring instance: SQ/CQ rings and registered buffers.
+ *
+ * Used from the writer thread only.
+ */
+class IoUringFileHandler::Ring {
+public:
+    explicit Ring(unsigned entries) {
+        io_uring_params params{};
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_setup failed");
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+
+        auto* sq = static_cast<char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        local_tail_ = *sq_tail_;
+    }
+
+    ~Ring() noexcept {
+        release();
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    /** Register @p count buffers of @p size bytes starting at @p base. */
+    bool register_buffers(char* base, std::size_t size, std::size_t count) noexcept {
+        std::vector<iovec> iovecs(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            iovecs[i].iov_base = base + i * size;
+            iovecs[i].iov_len = size;
+        }
+        registered_ = ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS,
+                                iovecs.data(), static_cast<unsigned>(count)) == 0;
+        return registered_;
+    }
+
+    [[nodiscard]] bool registered() const noexcept { return registered_; }
+
+    /** Get number of free submission entries. */
+    [[nodiscard]] unsigned sq_space() const noexcept {
+        unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        return sq_entries_ - (local_tail_ - head);
+    }
+
+    /** Next free submission entry (zeroed), or nullptr if the SQ is full. */
+    io_uring_sqe* get_sqe() noexcept {
+        unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        if (local_tail_ - head >= sq_entries_) {
+            return nullptr;
+        }
+        unsigned index = local_tail_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        ++local_tail_;
+        return sqe;
+    }
+
+    /**
+     * @brief Submit prepared entries and optionally wait for completions.
+     *
+     * Returns 0 or a negative errno; EINTR is retried. Entries the kernel
+     * did not consume (short submission, EAGAIN, EBUSY) are offered again
+     * by the next call.
+     */
+    int enter(unsigned min_complete) noexcept {
+        std::atomic_ref<unsigned>(*sq_tail_).store(local_tail_, std::memory_order_release);
+        unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (;;) {
+            unsigned to_submit = local_tail_ - std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+            long ret = ::syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags, nullptr, 0);
+            if (ret >= 0) {
+                return 0;
+            }
+            if (errno != EINTR) {
+                return -errno;
+            }
+        }
+    }
+
+    /**
+     * @brief Take back the entries the kernel has not consumed, calling
+     *        fn(user_data) for each in submission order.
+     */
+    template<typename Fn>
+    void withdraw(Fn&& fn) {
+        unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        for (unsigned i = head; i != local_tail_; ++i) {
+            fn(sqes_[sq_array_[i & sq_mask_]].user_data);
+        }
+        local_tail_ = head;
+        std::atomic_ref<unsigned>(*sq_tail_).store(head, std::memory_order_release);
+    }
+
+    /** Invoke fn(user_data, result) for each available completion. */
+    template<typename Fn>
+    std::size_t for_each_completion(Fn&& fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        std::size_t count = 0;
+        for (; head != tail; ++head, ++count) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            fn(cqe.user_data, cqe.res);
+        }
+        std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+    bool registered_ = false;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sq_ring_size_ = 0;
+    std::size_t cq_ring_size_ = 0;
+    std::size_t sqes_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned local_tail_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    void release() noexcept {
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_) ::munmap(sq_ring_, sq_ring_size_);
+        ::close(fd_);
+    }
+
+    void* map(std::size_t size, off_t offset) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        if (p == MAP_FAILED) {
+            int error = errno;
+            release();
+            throw std::system_error(error, std::generic_category(), "io_uring mmap failed");
+        }
+        return p;
+    }
+};
+
+bool io_uring_available() noexcept {
+    static const bool available = [] {
+        io_uring_params params{};
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+        if (fd < 0) {
+            return false;
+        }
+        ::close(fd);
+        return true;
+    }();
+    return available;
+}
+
+#else
+
+class IoUringFileHandler::Ring {
+public:
+    explicit Ring(unsigned) {
+        throw std::system_error(std::make_error_code(std::errc::function_not_supported),
+                                "io_uring is not supported on this platform");
+    }
+    [[nodiscard]] bool registered() const noexcept { return false; }
+};
+
+bool io_uring_available() noexcept {
+    return false;
+}
+
+#endif
+
+#if AGORA_LOG_HAS_IO_URING
+
+namespace {
+
+constexpr std::size_t kBufferAlignment = 4096;
+
+std::uint64_t file_size_of(int fd) noexcept {
+    struct stat st{};
+    return ::fstat(fd, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+}
+
+}  // anonymous namespace
+
+IoUringFileHandler::IoUringFileHandler(
+    const fs::path& file_path,
+    std::size_t buffer_size,
+    std::size_t queue_depth,
+    std::size_t flush_interval_ms,
+    std::shared_ptr<const Formatter> formatter,
+    bool sync,
+    std::size_t max_size_bytes,
+    std::size_t max_backup_count
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , file_path_(file_path)
+    , buffer_size_(std::clamp<std::size_t>(buffer_size, kBufferAlignment, std::size_t{1} << 30))
+    , flush_interval_ms_(std::max<std::size_t>(flush_interval_ms, 1))
+    , sync_(sync)
+    , max_size_bytes_(max_size_bytes)
+    , max_backup_count_(max_backup_count) {
+
+    queue_depth = std::clamp<std::size_t>(queue_depth, 1, 64);
+
+    // Each buffer needs up to two operations (write + linked fsync)
+    ring_ = std::make_unique<Ring>(static_cast<unsigned>(queue_depth * 4));
+
+    std::size_t total = queue_depth * buffer_size_;
+    total = (total + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+    memory_ = {static_cast<char*>(std::aligned_alloc(kBufferAlignment, total)), std::free};
+    if (!memory_) {
+        throw std::bad_alloc();
+    }
+
+    // Fixed buffers skip per-write page pinning; fall back to plain writes
+    // when registration fails (e.g. RLIMIT_MEMLOCK on older kernels)
+    ring_->register_buffers(memory_.get(), buffer_size_, queue_depth);
+
+    slots_.resize(queue_depth);
+    for (std::size_t i = queue_depth; i > 0; --i) {
+        free_.push_back(static_cast<std::uint32_t>(i - 1));
+    }
+    ops_.resize(queue_depth * 4);
+    for (std::size_t i = ops_.size(); i > 0; --i) {
+        free_ops_.push_back(static_cast<std::uint32_t>(i - 1));
+    }
+
+    open_file();
+    file_offset_ = file_size_of(fd_);
+    file_size_ = static_cast<std::size_t>(file_offset_);
+
+    writer_thread_ = std::thread(&IoUringFileHandler::writer_thread_func, this);
+}
+
+IoUringFileHandler::~IoUringFileHandler() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+
+    // The writer drains every buffer before it exits
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    close_file();
+}
+
+bool IoUringFileHandler::registered_buffers() const noexcept {
+    return ring_->registered();
+}
+
+void IoUringFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    // append() may release mutex_ while waiting for a buffer; append_mutex_
+    // keeps other producers from interleaving with a partly copied record
+    std::lock_guard<std::mutex> append_lock(append_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Rotate before this record if it would overflow the current file
+    if (max_size_bytes_ > 0 && file_size_ + record.size() > max_size_bytes_) {
+        rotations_.push_back(appended_);
+        file_size_ = 0;
+        header_pending_ = true;
+    }
+
+    // Stream header at the start of each file
+    if (header_pending_) {
+        header_pending_ = false;
+        thread_local std::string header;
+        header.clear();
+        formatter_->format_header(entry, header);
+        append(header, lock);
+    }
+
+    append(record, lock);
+    entries_written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IoUringFileHandler::append(std::string_view data, std::unique_lock<std::mutex>& lock) {
+    file_size_ += data.size();
+    appended_ += data.size();
+
+    // Records may span buffers: buffers are written at consecutive offsets
+    while (!data.empty()) {
+        if (current_ < 0) {
+            if (free_.empty()) {
+                // Every buffer is in flight: wait for the writer
+                ++waiters_;
+                cv_.notify_one();
+                space_cv_.wait(lock, [this] { return !free_.empty(); });
+                --waiters_;
+            }
+            current_ = static_cast<int>(free_.back());
+            free_.pop_back();
+        }
+
+        Slot& slot = slots_[current_];
+        std::size_t n = std::min(buffer_size_ - slot.used, data.size());
+        std::memcpy(memory_.get() + current_ * buffer_size_ + slot.used, data.data(), n);
+        slot.used += n;
+        data.remove_prefix(n);
+
+        if (slot.used == buffer_size_) {
+            ready_.push_back(static_cast<std::uint32_t>(current_));
+            current_ = -1;
+            cv_.notify_one();
+        }
+    }
+}
+
+void IoUringFileHandler::flush() noexcept {
+    try {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::uint64_t target = appended_;
+        if (completed_ >= target) {
+            return;
+        }
+        flush_requested_ = true;
+        cv_.notify_one();
+        space_cv_.wait(lock, [&] { return completed_ >= target; });
+    } catch (...) {
+        // Ignore errors during flush - noexcept guarantee
+    }
+}
+
+void IoUringFileHandler::open_file() {
+    // Create parent directories if they don't exist
+    if (file_path_.has_parent_path()) {
+        fs::create_directories(file_path_.parent_path());
+    }
+
+    // No O_APPEND: every write carries its own offset so several can be in flight
+    fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open log file: " + file_path_.string());
+    }
+}
+
+void IoUringFileHandler::close_file() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void IoUringFileHandler::rotate() {
+    // Rename while the file is still open; on failure keep writing to it
+    try {
+        rotate_backups(file_path_, max_backup_count_);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Log file rotation failed: " << e.what() << std::endl;
+        return;
+    }
+
+    close_file();
+    try {
+        open_file();
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to reopen log file after rotation: " << e.what() << std::endl;
+    }
+    file_offset_ = 0;
+}
+
+void IoUringFileHandler::submit(std::uint32_t slot) {
+    Slot& s = slots_[slot];
+    std::uint64_t start = submitted_;
+    s.end = start + s.used;
+    submitted_ = s.end;
+
+    // Hold the buffer until all of its pieces are queued
+    ++s.pending;
+    in_flight_.push_back(slot);
+
+    std::size_t offset = 0;
+    while (!pending_rotations_.empty() && pending_rotations_.front() < s.end) {
+        auto cut = static_cast<std::size_t>(pending_rotations_.front() - start);
+        pending_rotations_.pop_front();
+        if (cut > offset) {
+            queue_write(slot, offset, cut - offset);
+            offset = cut;
+        }
+        // Everything before the rotation point must reach the old file
+        reap(Wait::All);
+        rotate();
+    }
+    if (s.used > offset) {
+        queue_write(slot, offset, s.used - offset);
+    }
+
+    --s.pending;
+}
+
+void IoUringFileHandler::queue_write(std::uint32_t slot, std::size_t offset, std::size_t length) {
+    if (fd_ < 0) {
+        // A rotation could not reopen the file: try again, as
+        // BufferedFileHandler does. Until then this data is lost
+        try {
+            open_file();
+            file_offset_ = file_size_of(fd_);
+        } catch (const std::exception& e) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "IoUringFileHandler write error: " << e.what() << std::endl;
+            return;
+        }
+    }
+
+    Op write_op{slot, static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(length), file_offset_, false};
+    Op fsync_op{slot, 0, 0, 0, true};
+
+    // A write and its fsync enter the ring together, or not at all
+    unsigned needed = sync_ ? 2 : 1;
+    while (!ring_failed_ && free_ops_.size() < needed) {
+        enter_ring(1);
+        process_completions();
+    }
+    if (!ring_failed_ && ring_->sq_space() < needed) {
+        enter_ring(0);
+        if (!ring_failed_ && ring_->sq_space() < needed) {
+            fail_ring(EAGAIN);
+        }
+    }
+
+    if (ring_failed_) {
+        ++slots_[slot].pending;  // Released by complete_sync()
+        complete_sync(write_op);
+        if (sync_) {
+            ++slots_[slot].pending;
+            complete_sync(fsync_op);
+        }
+        file_offset_ += length;
+        writes_submitted_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto prepare = [this](std::uint32_t slot_index, const Op& op) {
+        io_uring_sqe* sqe = ring_->get_sqe();  // Room checked above
+        std::uint32_t id = free_ops_.back();
+        free_ops_.pop_back();
+        ops_[id] = op;
+        sqe->fd = fd_;
+        sqe->user_data = id;
+        ++slots_[slot_index].pending;
+        ++ops_in_flight_;
+        ++queued_;
+        return sqe;
+    };
+
+    io_uring_sqe* sqe = prepare(slot, write_op);
+    sqe->opcode = ring_->registered() ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->off = file_offset_;
+    sqe->addr = reinterpret_cast<std::uint64_t>(memory_.get() + slot * buffer_size_ + offset);
+    sqe->len = static_cast<std::uint32_t>(length);
+    sqe->buf_index = static_cast<std::uint16_t>(slot);
+
+    if (sync_) {
+        sqe->flags |= IOSQE_IO_LINK;
+        io_uring_sqe* fsync_sqe = prepare(slot, fsync_op);
+        fsync_sqe->opcode = IORING_OP_FSYNC;
+        fsync_sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    }
+
+    file_offset_ += length;
+    writes_submitted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IoUringFileHandler::enter_ring(unsigned min_complete) {
+    if (ring_failed_) {
+        // Operations the kernel took still complete; poll for them
+        if (min_complete > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return;
+    }
+
+    int error = ring_->enter(min_complete);
+    queued_ = 0;
+    if (error == 0) {
+        return;
+    }
+    // Short of resources or a full CQ: fine again once completions are reaped
+    if ((error == -EAGAIN || error == -EBUSY) && process_completions() > 0) {
+        return;
+    }
+    fail_ring(-error);
+}
+
+void IoUringFileHandler::fail_ring(int error) {
+    ring_failed_ = true;
+    std::cerr << "IoUringFileHandler: io_uring failed (" << std::strerror(error)
+              << "); writing with pwrite" << std::endl;
+
+    // The kernel never saw these: write them here, in order
+    ring_->withdraw([this](std::uint64_t user_data) {
+        auto id = static_cast<std::uint32_t>(user_data);
+        Op op = ops_[id];
+        free_ops_.push_back(id);
+        --ops_in_flight_;
+        complete_sync(op);
+    });
+    queued_ = 0;
+}
+
+void IoUringFileHandler::complete_sync(const Op& op) {
+    if (op.fsync) {
+        complete(op, ::fdatasync(fd_) == 0 ? 0 : -errno);
+    } else {
+        complete(op, 0);  // Nothing written yet: complete() pwrites all of it
+    }
+}
+
+void IoUringFileHandler::complete(const Op& op, std::int32_t result) {
+    if (result < 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "IoUringFileHandler " << (op.fsync ? "fsync" : "write") << " error: "
+                  << std::strerror(-result) << std::endl;
+    } else if (!op.fsync && static_cast<std::uint32_t>(result) < op.length) {
+        // Short write: finish the rest synchronously
+        const char* data = memory_.get() + op.slot * buffer_size_ + op.offset + result;
+        std::size_t remaining = op.length - static_cast<std::uint32_t>(result);
+        auto offset = static_cast<off_t>(op.file_offset + static_cast<std::uint32_t>(result));
+        while (remaining > 0) {
+            ssize_t n = ::pwrite(fd_, data, remaining, offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            data += n;
+            offset += n;
+            remaining -= static_cast<std::size_t>(n);
+        }
+    }
+    --slots_[op.slot].pending;
+}
+
+std::size_t IoUringFileHandler::process_completions() {
+    return ring_->for_each_completion([this](std::uint64_t user_data, std::int32_t result) {
+        auto id = static_cast<std::uint32_t>(user_data);
+        Op op = ops_[id];
+        free_ops_.push_back(id);
+        --ops_in_flight_;
+        complete(op, result);
+    });
+}
+
+std::size_t IoUringFileHandler::release_buffers() {
+    std::size_t released = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Buffers complete in any order; release them in stream order
+        while (!in_flight_.empty() && slots_[in_flight_.front()].pending == 0) {
+            std::uint32_t slot = in_flight_.front();
+            in_flight_.pop_front();
+            completed_ = slots_[slot].end;
+            slots_[slot].used = 0;
+            free_.push_back(slot);
+            ++released;
+        }
+    }
+    if (released > 0) {
+        space_cv_.notify_all();
+    }
+    return released;
+}
+
+void IoUringFileHandler::reap(Wait wait) {
+    if (queued_ > 0) {
+        enter_ring(0);
+    }
+
+    for (;;) {
+        process_completions();
+        std::size_t released = release_buffers();
+        if (ops_in_flight_ == 0 || wait == Wait::None || (wait == Wait::Buffer && released > 0)) {
+            return;
+        }
+        enter_ring(1);
+    }
+}
+
+void IoUringFileHandler::writer_thread_func() {
+    using namespace std::chrono;
+
+    std::vector<std::uint32_t> batch;
+    for (;;) {
+        Wait wait = Wait::None;
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            bool woken = cv_.wait_for(lock, milliseconds(flush_interval_ms_), [this] {
+                return !ready_.empty() || flush_requested_ || stop_ || waiters_ > 0;
+            });
+
+            // Hand over the partial buffer on timeout, flush() and shutdown
+            if ((!woken || flush_requested_ || stop_) && current_ >= 0 && slots_[current_].used > 0) {
+                ready_.push_back(static_cast<std::uint32_t>(current_));
+                current_ = -1;
+            }
+
+            if (flush_requested_ || stop_) {
+                wait = Wait::All;
+            } else if (waiters_ > 0) {
+                wait = Wait::Buffer;
+            }
+            flush_requested_ = false;
+            stopping = stop_;
+
+            batch.assign(ready_.begin(), ready_.end());
+            ready_.clear();
+            pending_rotations_.insert(pending_rotations_.end(), rotations_.begin(), rotations_.end());
+            rotations_.clear();
+        }
+
+        try {
+            for (std::uint32_t slot : batch) {
+                submit(slot);
+            }
+            reap(wait);
+        } catch (const std::exception& e) {
+            std::cerr << "IoUringFileHandler writer error: " << e.what() << std::endl;
+        }
+
+        if (stopping) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.empty() && in_flight_.empty() && (current_ < 0 || slots_[current_].used == 0)) {
+                break;
+            }
+        }
+    }
+}
+
+#else
+
+IoUringFileHandler::IoUringFileHandler(
+    const fs::path& file_path,
+    std::size_t buffer_size,
+    std::size_t,
+    std::size_t flush_interval_ms,
+    std::shared_ptr<const Formatter> formatter,
+    bool sync,
+    std::size_t max_size_bytes,
+    std::size_t max_backup_count
+)
+    : Handler(std::move(formatter))
+    , file_path_(file_path)
+    , buffer_size_(buffer_size)
+    , flush_interval_ms_(flush_interval_ms)
+    , sync_(sync)
+    , max_size_bytes_(max_size_bytes)
+    , max_backup_count_(max_backup_count)
+    , ring_(std::make_unique<Ring>(0)) {}
+
+IoUringFileHandler::~IoUringFileHandler() noexcept = default;
+
+bool IoUringFileHandler::registered_buffers() const noexcept { return false; }
+void IoUringFileHandler::write_formatted(const LogEntry&, std::string_view) {}
+void IoUringFileHandler::flush() noexcept {}
+
+#endif
+
+std::shared_ptr<Handler> make_io_uring_file_handler(
+    const fs::path& file_path,
+    std::size_t buffer_size,
+    std::size_t queue_depth,
+    std::size_t flush_interval_ms,
+    std::shared_ptr<const Formatter> formatter,
+    bool sync,
+    std::size_t max_size_bytes,
+    std::size_t max_backup_count
+) {
+    if (io_uring_available()) {
+        try {
+            return std::make_shared<IoUringFileHandler>(
+                file_path, buffer_size, queue_depth, flush_interval_ms,
+                formatter, sync, max_size_bytes, max_backup_count);
+        } catch (const std::system_error&) {
+            // Ring setup failed (e.g. resource limits): use the plain handler
+        }
+    }
+    return std::make_shared<BufferedFileHandler>(
+        file_path, buffer_size, flush_interval_ms, std::move(formatter),
+        max_size_bytes, max_backup_count);
+}
+
+}  // namespace agora::log
@@ -0,0 +1,178 @@
+/**
+ * @file journald.cpp
+ * @brief journald native protocol handler implementation
+ */
+
+#include <agora/log/handlers/journald.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <variant>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace {
+
+void append_field(std::string& out, std::string_view key, std::string_view value) {
+    out.append(key);
+    if (value.find('\n') == std::string_view::npos) {
+        out.push_back('=');
+        out.append(value);
+    } else {
+        // Binary-safe form: length-prefixed value
+        out.push_back('\n');
+        std::uint64_t size = value.size();
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+        }
+        out.append(value);
+    }
+    out.push_back('\n');
+}
+
+template <typename T>
+void append_number_field(std::string& out, std::string_view key, T value) {
+    char digits[32];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    append_field(out, key, std::string_view(digits, static_cast<std::size_t>(end - digits)));
+}
+
+// Fields format() writes itself; a context key with one of these names
+// would add a second value (journald keeps both)
+constexpr std::string_view kOwnFields[] = {
+    "MESSAGE", "PRIORITY", "SYSLOG_IDENTIFIER", "ENVIRONMENT", "SERVICE_VERSION",
+    "LOGGER", "CODE_FILE", "CODE_LINE", "CODE_FUNC", "EXCEPTION_TYPE",
+    "EXCEPTION_MESSAGE", "DURATION_MS",
+};
+
+// journald field names: [A-Z0-9_], not starting with '_' or a digit, <= 64 chars.
+// Names that start with a digit or collide with kOwnFields get a CTX_ prefix
+void append_field_name(std::string& out, std::string_view key) {
+    std::size_t start = out.size();
+    for (char c : key) {
+        if (out.size() - start == 64) {
+            break;
+        }
+        if (c >= 'a' && c <= 'z') {
+            out.push_back(static_cast<char>(c - 'a' + 'A'));
+        } else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+            out.push_back(c);
+        } else if (out.size() > start) {
+            out.push_back('_');
+        }
+    }
+    std::string_view name(out.data() + start, out.size() - start);
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9') ||
+        std::find(std::begin(kOwnFields), std::end(kOwnFields), name) != std::end(kOwnFields)) {
+        out.insert(start, "CTX_");
+        out.resize(std::min(out.size(), start + 64));
+    }
+}
+
+}  // anonymous namespace
+
+void JournaldFormatter::format(const LogEntry& entry, std::string& out) const {
+    append_field(out, "MESSAGE", entry.message);
+    append_number_field(out, "PRIORITY", syslog_severity(entry.level));
+    if (!entry.service_name.empty()) {
+        append_field(out, "SYSLOG_IDENTIFIER", entry.service_name);
+    }
+    if (!entry.environment.empty()) {
+        append_field(out, "ENVIRONMENT", entry.environment);
+    }
+    if (!entry.version.empty()) {
+        append_field(out, "SERVICE_VERSION", entry.version);
+    }
+    append_field(out, "LOGGER", entry.logger_name);
+    append_field(out, "CODE_FILE", entry.location.file);
+    append_number_field(out, "CODE_LINE", entry.location.line);
+    append_field(out, "CODE_FUNC", entry.location.function);
+    if (entry.exception) {
+        append_field(out, "EXCEPTION_TYPE", entry.exception->type);
+        append_field(out, "EXCEPTION_MESSAGE", entry.exception->message);
+    }
+    if (entry.duration_ms) {
+        append_number_field(out, "DURATION_MS", *entry.duration_ms);
+    }
+
+    // Context as native fields, so journalctl can filter on them
+    thread_local std::string key;
+    for (const auto& [name, value] : entry.context) {
+        key.clear();
+        append_field_name(key, name);
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                append_field(out, key, v);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                append_field(out, key, v ? "true" : "false");
+            } else {
+                append_number_field(out, key, v);
+            }
+        }, value);
+    }
+}
+
+JournaldHandler::JournaldHandler(
+    const std::filesystem::path& socket_path,
+    std::size_t buffer_size,
+    std::size_t flush_interval_ms
+)
+    : DatagramHandler(std::make_shared<JournaldFormatter>(), socket_path, buffer_size, flush_interval_ms) {
+}
+
+JournaldHandler::~JournaldHandler() noexcept {
+    stop();  // The sender thread may still call send_oversized()
+}
+
+bool JournaldHandler::send_oversized(std::string_view datagram) noexcept {
+    int memfd = ::memfd_create("journal-data", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0) {
+        return false;
+    }
+
+    const char* data = datagram.data();
+    std::size_t size = datagram.size();
+    while (size > 0) {
+        ssize_t n = ::write(memfd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(memfd);
+            return false;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+
+    // journald only accepts sealed memfds: the payload cannot change under it
+    if (::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        ::close(memfd);
+        return false;
+    }
+
+    // An empty datagram carrying only the descriptor
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &memfd, sizeof(int));
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(fd_, &message, 0);
+    } while (sent < 0 && errno == EINTR);
+    ::close(memfd);
+    return sent >= 0;
+}
+
+}  // namespace agora::log
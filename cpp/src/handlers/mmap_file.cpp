@@ -0,0 +1,294 @@
+/**
+ * @file mmap_file.cpp
+ * @brief Memory-mapped append handler implementation
+ */
+
+#include <agora/log/handlers/mmap_file.hpp>
+#include <agora/log/handlers/rotating_file.hpp>
+#include <agora/log/formatter.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace fs = std::filesystem;
+
+MmapFileHandler::MmapFileHandler(
+    const fs::path& file_path,
+    std::size_t segment_size,
+    std::size_t max_backup_count,
+    std::shared_ptr<const Formatter> formatter
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , file_path_(file_path)
+    , segment_size_(std::max<std::size_t>(segment_size, 4096))
+    , max_backup_count_(max_backup_count) {
+
+    // Fail early on an unusable path; the first segment is mapped by the
+    // first record, which also supplies the header
+    if (file_path_.has_parent_path()) {
+        fs::create_directories(file_path_.parent_path());
+    }
+    int fd = ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open log file: " + file_path_.string());
+    }
+    ::close(fd);
+}
+
+MmapFileHandler::~MmapFileHandler() noexcept {
+    std::lock_guard<std::mutex> lock(roll_mutex_);
+    if (Segment* segment = current_.exchange(nullptr)) {
+        retire(segment);
+    }
+}
+
+MmapFileHandler::Segment* MmapFileHandler::pin(std::size_t& slot) noexcept {
+    for (;;) {
+        std::uint64_t epoch = epoch_.load();
+        slot = epoch & 1;
+        pins_[slot].fetch_add(1);
+        // Re-check after announcing ourselves: a roller that already bumped
+        // the epoch may not wait for this slot
+        if (epoch_.load() == epoch) {
+            break;
+        }
+        unpin(slot);
+    }
+    Segment* segment = current_.load();
+    if (!segment) {
+        unpin(slot);
+    }
+    return segment;
+}
+
+void MmapFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    for (;;) {
+        std::size_t slot = 0;
+        Segment* segment = pin(slot);
+        if (!segment) {
+            roll(0, entry, record.size());
+            continue;
+        }
+
+        std::uint64_t offset = segment->reserved.fetch_add(record.size(), std::memory_order_relaxed);
+        if (offset + record.size() <= segment->capacity) {
+            std::memcpy(segment->data + offset, record.data(), record.size());
+            unpin(slot);
+            entries_written_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Only one reservation straddles the end: it records where data stops
+        if (offset <= segment->capacity) {
+            segment->end.store(offset, std::memory_order_relaxed);
+        }
+        std::uint64_t sequence = segment->sequence;
+        unpin(slot);
+        roll(sequence, entry, record.size());
+    }
+}
+
+void MmapFileHandler::flush() noexcept {
+    std::size_t slot = 0;
+    Segment* segment = pin(slot);
+    if (!segment) {
+        return;
+    }
+    auto used = std::min<std::uint64_t>(segment->reserved.load(), segment->capacity);
+    if (used > 0) {
+        ::msync(segment->data, static_cast<std::size_t>(used), MS_SYNC);
+    }
+    unpin(slot);
+}
+
+void MmapFileHandler::roll(std::uint64_t full, const LogEntry& entry, std::size_t min_capacity) {
+    std::lock_guard<std::mutex> lock(roll_mutex_);
+    // Segments are only retired under roll_mutex_, so current is safe to read
+    Segment* current = current_.load();
+    if ((current ? current->sequence : 0) != full) {
+        return;  // Another producer already rolled
+    }
+
+    thread_local std::string header;
+    header.clear();
+    formatter_->format_header(entry, header);
+
+    // Let the copies into the full segment finish, so its size is final
+    // should the next segment have to continue the same file
+    if (current) {
+        quiesce();
+    }
+
+    // Map (and for a full segment, rotate to) the next file before
+    // publishing it, so it always starts with the header
+    Segment* next = map_segment(header.size() + min_capacity, current != nullptr, current);
+    next->sequence = next_sequence_++;
+    if (!current || !current->continued) {
+        // A segment continuing the full one's file is the same stream
+        std::uint64_t start = next->reserved.load(std::memory_order_relaxed);
+        std::memcpy(next->data + start, header.data(), header.size());
+        next->reserved.store(start + header.size(), std::memory_order_relaxed);
+    }
+
+    current_.store(next);
+    segments_mapped_.fetch_add(1, std::memory_order_relaxed);
+
+    if (current) {
+        // Producers that may still hold the old segment all pinned the old epoch
+        quiesce();
+        retire(current);
+    }
+}
+
+void MmapFileHandler::quiesce() noexcept {
+    std::size_t slot = epoch_.fetch_add(1) & 1;
+    while (pins_[slot].load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+MmapFileHandler::Segment* MmapFileHandler::map_segment(
+    std::size_t min_capacity, bool rotate_first, Segment* full) {
+    if (rotate_first && !rotation_failed_) {
+        // Map the next segment beside the live one and rotate only once it
+        // is ready: a segment that cannot be allocated (a full disk) leaves
+        // the backups alone, and the next record simply tries again
+        fs::path next_path(file_path_.string() + ".next");
+        int fd = ::open(next_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                "Failed to open log file: " + next_path.string());
+        }
+        Segment* next = nullptr;
+        try {
+            next = map_file(fd, next_path, 0, std::max(segment_size_, min_capacity));
+        } catch (...) {
+            std::error_code ec;
+            fs::remove(next_path, ec);
+            throw;
+        }
+
+        try {
+            rotate_backups(file_path_, max_backup_count_);
+            fs::rename(next_path, file_path_);
+            return next;
+        } catch (const fs::filesystem_error& e) {
+            // Keep logging in the live file, appending after its data
+            std::cerr << "Log file rotation failed: " << e.what() << std::endl;
+            std::cerr << "Disabling file rotation." << std::endl;
+            rotation_failed_ = true;
+            ::munmap(next->data, next->capacity);
+            ::close(next->fd);
+            delete next;
+            std::error_code ec;
+            fs::remove(next_path, ec);
+        }
+    }
+
+    int fd = ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(),
+            "Failed to open log file: " + file_path_.string());
+    }
+
+    struct stat st{};
+    std::uint64_t size = ::fstat(fd, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+    if (full) {
+        // Continue the full segment's file right after its data: cut its
+        // unused preallocated tail now, as retire() must not cut it later
+        // under the new mapping
+        size = used_bytes(*full);
+        (void)::ftruncate(fd, static_cast<off_t>(size));
+        full->continued = true;
+    }
+
+    // A file left by an earlier run becomes a backup, so a segment never
+    // continues after a torn record. Trailing NUL bytes are unwritten
+    // preallocated space, not data, and are cut off first
+    if (size > 0 && !rotate_first) {
+        std::vector<char> tail(64 * 1024);
+        while (size > 0) {
+            auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(size, tail.size()));
+            if (::pread(fd, tail.data(), chunk, static_cast<off_t>(size - chunk)) != static_cast<ssize_t>(chunk)) {
+                break;
+            }
+            std::size_t kept = chunk;
+            while (kept > 0 && tail[kept - 1] == '\0') {
+                --kept;
+            }
+            size -= chunk - kept;
+            if (kept > 0) {
+                break;
+            }
+        }
+        (void)::ftruncate(fd, static_cast<off_t>(size));
+        ::close(fd);
+        return map_segment(min_capacity, true);
+    }
+
+    // size stays non-zero only if rotation failed; then append after it
+    return map_file(fd, file_path_, size, static_cast<std::size_t>(size) + std::max(segment_size_, min_capacity));
+}
+
+MmapFileHandler::Segment* MmapFileHandler::map_file(
+    int fd, const fs::path& path, std::uint64_t size, std::size_t capacity) {
+    // Allocate real blocks so a full disk fails here rather than with
+    // SIGBUS on a later memcpy. Only a filesystem without fallocate gets
+    // a sparse file
+    int error = ::fallocate(fd, 0, 0, static_cast<off_t>(capacity)) == 0 ? 0 : errno;
+    if (error == EOPNOTSUPP || error == ENOSYS) {
+        error = ::ftruncate(fd, static_cast<off_t>(capacity)) == 0 ? 0 : errno;
+    }
+    if (error != 0) {
+        (void)::ftruncate(fd, static_cast<off_t>(size));  // Drop a partial allocation
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+            "Failed to size log segment: " + path.string());
+    }
+
+    void* data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        error = errno;
+        (void)::ftruncate(fd, static_cast<off_t>(size));
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+            "Failed to map log segment: " + path.string());
+    }
+
+    auto* segment = new Segment;
+    segment->fd = fd;
+    segment->data = static_cast<char*>(data);
+    segment->capacity = capacity;
+    segment->reserved.store(size, std::memory_order_relaxed);
+    return segment;
+}
+
+std::uint64_t MmapFileHandler::used_bytes(const Segment& segment) noexcept {
+    return std::min({
+        segment.reserved.load(std::memory_order_acquire),
+        segment.end.load(std::memory_order_relaxed),
+        static_cast<std::uint64_t>(segment.capacity)
+    });
+}
+
+void MmapFileHandler::retire(Segment* segment) noexcept {
+    ::munmap(segment->data, segment->capacity);
+    if (!segment->continued) {
+        (void)::ftruncate(segment->fd, static_cast<off_t>(used_bytes(*segment)));
+    }
+    ::close(segment->fd);
+    delete segment;
+}
+
+}  // namespace agora::log
@@ -0,0 +1,282 @@
+/**
+ * @file per_thread_file.cpp
+ * @brief Per-thread segment file handler implementation
+ */
+
+#include <agora/log/handlers/per_thread_file.hpp>
+#include <agora/log/thread_segment.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::atomic<std::uint64_t> g_next_handler_id{1};
+
+}  // anonymous namespace
+
+struct PerThreadFileHandler::Segment {
+    std::mutex mutex;  // Owner thread, plus flush() now and then
+    int fd = -1;
+    fs::path path;
+    std::string buffer;
+    std::int64_t last_timestamp_ns = std::numeric_limits<std::int64_t>::min();
+    std::size_t entries = 0;
+    bool header_pending = true;
+    bool error_reported = false;
+
+    /**
+     * Write the buffer out (caller holds mutex). The buffer is empty
+     * afterwards either way; returns 0 or the errno of a failed write.
+     */
+    int write_out() noexcept {
+        const char* data = buffer.data();
+        std::size_t size = buffer.size();
+        int error = 0;
+        while (size > 0 && fd >= 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                error = errno;
+                break;
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        buffer.clear();
+        return error;
+    }
+
+    /** write_out(), reporting a failure to stderr once per error streak. */
+    void write_out_reported() noexcept {
+        int error = write_out();
+        if (error != 0 && !error_reported) {
+            error_reported = true;
+            std::cerr << "Failed to write log segment " << path.string() << ": "
+                      << std::strerror(error) << std::endl;
+        } else if (error == 0) {
+            error_reported = false;
+        }
+    }
+};
+
+struct PerThreadFileHandler::Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Segment>> segments;
+    std::vector<Segment*> idle;  // Released by exited threads
+    std::size_t next_index = 0;
+    std::atomic<bool> closed{false};
+};
+
+struct PerThreadFileHandler::ThreadCache {
+    struct Slot {
+        std::uint64_t handler_id;
+        std::shared_ptr<Registry> registry;
+        Segment* segment;
+    };
+    std::vector<Slot> slots;
+
+    // Thread exit: write out and hand the segments back for reuse
+    ~ThreadCache() {
+        for (auto& slot : slots) {
+            std::lock_guard<std::mutex> lock(slot.registry->mutex);
+            if (slot.registry->closed.load()) {
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> segment_lock(slot.segment->mutex);
+                slot.segment->write_out_reported();
+            }
+            slot.registry->idle.push_back(slot.segment);
+        }
+    }
+};
+
+PerThreadFileHandler::PerThreadFileHandler(
+    const fs::path& base_path,
+    std::shared_ptr<const Formatter> formatter,
+    std::size_t buffer_size,
+    std::size_t flush_interval_ms
+)
+    : Handler(formatter ? std::move(formatter) : std::make_shared<JsonFormatter>())
+    , base_path_(base_path)
+    , buffer_size_(std::max<std::size_t>(buffer_size, 4096))
+    , flush_interval_ms_(flush_interval_ms)
+    , id_(g_next_handler_id.fetch_add(1))
+    , registry_(std::make_shared<Registry>()) {
+
+    if (base_path_.has_parent_path()) {
+        fs::create_directories(base_path_.parent_path());
+    }
+
+    // New segments are numbered after those of earlier runs
+    if (auto existing = find_thread_segments(base_path_); !existing.empty()) {
+        registry_->next_index = *thread_segment_index(base_path_, existing.back()) + 1;
+    }
+
+    if (flush_interval_ms_ > 0) {
+        flush_thread_ = std::thread(&PerThreadFileHandler::flush_thread_func, this);
+    }
+}
+
+PerThreadFileHandler::~PerThreadFileHandler() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        stop_ = true;
+    }
+    flush_cv_.notify_all();
+    if (flush_thread_.joinable()) {
+        flush_thread_.join();
+    }
+
+    // Thread caches may outlive the handler; they skip a closed registry
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+    registry_->closed.store(true);
+    for (auto& segment : registry_->segments) {
+        std::lock_guard<std::mutex> segment_lock(segment->mutex);
+        segment->write_out_reported();
+        if (segment->fd >= 0) {
+            ::close(segment->fd);
+            segment->fd = -1;
+        }
+    }
+}
+
+void PerThreadFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    Segment& segment = local_segment();
+    std::lock_guard<std::mutex> lock(segment.mutex);
+
+    std::int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        entry.timestamp.time_since_epoch()).count();
+    timestamp_ns = std::max(timestamp_ns, segment.last_timestamp_ns);
+    segment.last_timestamp_ns = timestamp_ns;
+
+    if (segment.header_pending) [[unlikely]] {
+        segment.header_pending = false;
+        thread_local std::string header;
+        header.clear();
+        formatter_->format_header(entry, header);
+        if (!header.empty()) {
+            append_thread_segment_frame(segment.buffer, timestamp_ns, kThreadSegmentHeaderFlag, header);
+        }
+    }
+
+    append_thread_segment_frame(segment.buffer, timestamp_ns, 0, record);
+    ++segment.entries;
+
+    if (segment.buffer.size() >= buffer_size_) {
+        if (int error = segment.write_out(); error != 0) {
+            throw std::system_error(error, std::generic_category(),
+                "Failed to write log segment: " + segment.path.string());
+        }
+    }
+}
+
+void PerThreadFileHandler::flush() noexcept {
+    try {
+        std::lock_guard<std::mutex> lock(registry_->mutex);
+        for (auto& segment : registry_->segments) {
+            std::lock_guard<std::mutex> segment_lock(segment->mutex);
+            if (!segment->buffer.empty()) {
+                segment->write_out_reported();
+            }
+        }
+    } catch (...) {
+        // Ignore errors during flush - noexcept guarantee
+    }
+}
+
+std::vector<fs::path> PerThreadFileHandler::segment_paths() const {
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+    std::vector<fs::path> paths;
+    paths.reserve(registry_->segments.size());
+    for (const auto& segment : registry_->segments) {
+        paths.push_back(segment->path);
+    }
+    return paths;
+}
+
+std::size_t PerThreadFileHandler::entries_written() const {
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+    std::size_t total = 0;
+    for (const auto& segment : registry_->segments) {
+        std::lock_guard<std::mutex> segment_lock(segment->mutex);
+        total += segment->entries;
+    }
+    return total;
+}
+
+PerThreadFileHandler::Segment& PerThreadFileHandler::local_segment() {
+    thread_local ThreadCache cache;
+
+    for (const auto& slot : cache.slots) {
+        if (slot.handler_id == id_) {
+            return *slot.segment;
+        }
+    }
+
+    // First record of this thread: drop slots of destroyed handlers first
+    std::erase_if(cache.slots, [](const ThreadCache::Slot& slot) {
+        return slot.registry->closed.load();
+    });
+    Segment* segment = acquire_segment();
+    cache.slots.push_back({id_, registry_, segment});
+    return *segment;
+}
+
+PerThreadFileHandler::Segment* PerThreadFileHandler::acquire_segment() {
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+
+    if (!registry_->idle.empty()) {
+        Segment* segment = registry_->idle.back();
+        registry_->idle.pop_back();
+        return segment;
+    }
+
+    // O_EXCL: never append to a segment of an earlier run or another process
+    for (;;) {
+        fs::path path = thread_segment_path(base_path_, registry_->next_index++);
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            if (errno == EEXIST) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                "Failed to create log segment: " + path.string());
+        }
+
+        auto segment = std::make_unique<Segment>();
+        segment->fd = fd;
+        segment->path = std::move(path);
+        segment->buffer.reserve(buffer_size_ + kThreadSegmentFrameSize);
+        append_thread_segment_preamble(segment->buffer);
+        registry_->segments.push_back(std::move(segment));
+        return registry_->segments.back().get();
+    }
+}
+
+void PerThreadFileHandler::flush_thread_func() {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    while (!stop_) {
+        flush_cv_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_), [this] { return stop_; });
+        if (!stop_) {
+            flush();
+        }
+    }
+}
+
+}  // namespace agora::log
@@ -5,112 +5,931 @@
 
 #include <agora/log/handlers/rotating_file.hpp>
 #include <agora/log/formatter.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <filesystem>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace agora::log {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+fs::path backup_path(const fs::path& file_path, std::size_t index) {
+    return fs::path(file_path.string() + "." + std::to_string(index));
+}
+
+// Zero-padded so segments list in order
+fs::path sequence_path(const fs::path& file_path, std::uint64_t sequence) {
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), ".%06llu", static_cast<unsigned long long>(sequence));
+    return fs::path(file_path.string() + digits);
+}
+
+// Backups may carry a compression suffix (see compression_suffix)
+constexpr std::string_view kBackupSuffixes[] = {"", ".gz", ".zst"};
+
+bool backup_exists(const std::string& path) {
+    for (auto suffix : kBackupSuffixes) {
+        if (fs::exists(path + std::string(suffix))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Backup {
+    std::string stamp;      // Period stamp; empty for numbered backups
+    std::size_t index = 0;  // .N: position (numbered) or split within a period
+    std::string_view suffix;  // Compression suffix; empty if uncompressed
+    fs::path path;
+};
+
+// Numbered (<name>.N) and timestamped (<name>.YYYY-MM-DD[THH][.N]) backups
+std::vector<Backup> list_backups(const fs::path& file_path) {
+    auto dir = file_path.has_parent_path() ? file_path.parent_path() : fs::path(".");
+    std::string prefix = file_path.filename().string() + ".";
+
+    std::vector<Backup> backups;
+    for (const auto& item : fs::directory_iterator(dir)) {
+        std::string name = item.path().filename().string();
+        if (!name.starts_with(prefix)) {
+            continue;
+        }
+        std::string_view rest = std::string_view(name).substr(prefix.size());
+        Backup backup;
+        for (auto suffix : kBackupSuffixes) {
+            if (!suffix.empty() && rest.ends_with(suffix)) {
+                rest.remove_suffix(suffix.size());
+                backup.suffix = suffix;
+                break;
+            }
+        }
+        backup.path = item.path();
+        auto index_end = rest.data() + rest.size();
+        if (!rest.empty() && rest.find_first_not_of("0123456789") == std::string_view::npos) {
+            std::from_chars(rest.data(), index_end, backup.index);
+        } else if (rest.size() >= 10 && rest[4] == '-' && rest[7] == '-') {
+            auto dot = rest.find('.');
+            if (dot != std::string_view::npos) {
+                std::from_chars(rest.data() + dot + 1, index_end, backup.index);
+            }
+            backup.stamp = std::string(rest.substr(0, dot));
+        } else {
+            continue;  // .next, .compressing, unrelated files
+        }
+        backups.push_back(std::move(backup));
+    }
+    return backups;
+}
+
+constexpr std::int64_t kNanosPerSecond = 1'000'000'000;
+
+// Backoff between attempts to repeat a failed rotation step
+constexpr std::chrono::milliseconds kRotationRetryInitial{1000};
+constexpr std::chrono::milliseconds kRotationRetryMax{60'000};
+
+std::int64_t to_nanos(std::chrono::system_clock::time_point time) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Last modification time of an existing log file, or now
+std::int64_t modified_nanos(const fs::path& path) noexcept {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) {
+        return to_nanos(std::chrono::system_clock::now());
+    }
+    return to_nanos(std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        std::chrono::file_clock::to_sys(time)));
+}
+
+// Linux threads have their own nice value
+void lower_thread_priority() noexcept {
+    (void)::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 19);
+}
+
+}  // anonymous namespace
+
+void rotate_backups(const fs::path& file_path, std::size_t max_backup_count) {
+    // Delete oldest backup if it exists
+    for (auto suffix : kBackupSuffixes) {
+        auto oldest = backup_path(file_path, max_backup_count).string() + std::string(suffix);
+        if (fs::exists(oldest)) {
+            fs::remove(oldest);
+        }
+    }
+
+    // Rotate existing backups
+    for (std::size_t i = max_backup_count; i > 1; --i) {
+        for (auto suffix : kBackupSuffixes) {
+            auto src = backup_path(file_path, i - 1).string() + std::string(suffix);
+            auto dst = backup_path(file_path, i).string() + std::string(suffix);
+
+            if (fs::exists(src)) {
+                fs::rename(src, dst);
+            }
+        }
+    }
+
+    // Move current file to .1
+    if (fs::exists(file_path)) {
+        fs::rename(file_path, backup_path(file_path, 1));
+    }
+}
+
 RotatingFileHandler::RotatingFileHandler(
     const fs::path& file_path,
     std::size_t max_size_bytes,
-    std::size_t max_backup_count
+    std::size_t max_backup_count,
+    std::shared_ptr<const Formatter> formatter,
+    SegmentOptions segment,
+    RotationInterval interval,
+    bool compress,
+    BackupNaming naming,
+    SpillOptions spill,
+    RetentionOptions retention
 )
-    : FileHandler(file_path)
+    : FileHandler(file_path, std::move(formatter), segment, spill)
     , max_size_bytes_(max_size_bytes)
-    , max_backup_count_(max_backup_count) {
+    , max_backup_count_(max_backup_count)
+    , interval_(interval)
+    , naming_(naming)
+    , next_path_(file_path.string() + ".next")
+    , live_path_(file_path)
+    , compression_(compress ? default_compression() : Compression::None)
+    , retention_(retention) {
+
+    switch (interval_) {
+        case RotationInterval::None: break;
+        case RotationInterval::Hourly: period_ns_ = 3600 * kNanosPerSecond; break;
+        case RotationInterval::Daily: period_ns_ = 86400 * kNanosPerSecond; break;
+    }
+
+    // The inventory is listed once here; sequence_ must be settled first
+    // so the live segments stay out of it
+    if (naming_ == BackupNaming::Sequence) {
+        start_sequence();
+    }
+    {
+        std::lock_guard<std::mutex> lock(backup_mutex_);
+        scan_backups();
+    }
+    if (naming_ == BackupNaming::Cascade) {
+        recover_next();
+    }
 
     // Get current file size if it exists
-    if (fs::exists(file_path_)) {
+    if (use_segment()) {
+        current_size_ = static_cast<std::size_t>(segment_.size());
+    } else if (fs::exists(file_path_)) {
         current_size_ = fs::file_size(file_path_);
     }
+
+    // An existing file belongs to the period it was last written in
+    if (period_ns_ > 0) {
+        start_period(current_size_ > 0
+            ? modified_nanos(file_path_)
+            : to_nanos(std::chrono::system_clock::now()));
+    }
+
+    // The first segment is prepared here; later ones right after each rotation
+    next_ready_ = open_next(next_file_, next_segment_);
+    if (!next_ready_) {
+        schedule_rotation_retry();
+    }
+    rotator_thread_ = std::thread(&RotatingFileHandler::rotator_thread_func, this);
+
+    try {
+        if (compression_ != Compression::None) {
+            queue_uncompressed_backups();
+            compressor_thread_ = std::thread(&RotatingFileHandler::compressor_thread_func, this);
+        }
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Failed to queue log backups for compression: " << e.what() << std::endl;
+    }
+    if (retention_enabled()) {
+        retention_thread_ = std::thread(&RotatingFileHandler::retention_thread_func, this);
+    }
 }
 
-void RotatingFileHandler::write(const LogEntry& entry) {
-    std::string formatted = format_json(entry);
-    std::size_t entry_size = formatted.size() + 1;  // +1 for newline
+RotatingFileHandler::~RotatingFileHandler() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    rotator_cv_.notify_one();
+    if (rotator_thread_.joinable()) {
+        rotator_thread_.join();
+    }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    // A compression in progress finishes; queued ones resume on next start
+    {
+        std::lock_guard<std::mutex> lock(backup_mutex_);
+        backup_stop_ = true;
+    }
+    compress_cv_.notify_one();
+    retention_cv_.notify_one();
+    if (compressor_thread_.joinable()) {
+        compressor_thread_.join();
+    }
+    if (retention_thread_.joinable()) {
+        retention_thread_.join();
+    }
 
-    // Check if rotation is needed
-    if (should_rotate(entry_size)) {
-        rotate();
+    // The rotator finished any pending rotation; drop the unused next segment
+    if (next_ready_) {
+        next_segment_.close();
+        next_file_.close();
+        std::error_code ec;
+        fs::remove(prepared_path(), ec);
     }
+}
 
-    // Write entry
-    if (!file_.is_open()) {
-        open_file();
+void RotatingFileHandler::write_formatted(const LogEntry& entry, std::string_view record) {
+    std::size_t entry_size = record.size();
+
+    std::int64_t timestamp = to_nanos(entry.timestamp);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Check if rotation is needed (next_boundary_ is INT64_MAX without an interval)
+    if (timestamp >= next_boundary_ || should_rotate(entry_size)) {
+        rotate(entry_size, timestamp, lock);
     }
 
-    file_ << formatted << '\n';
-    current_size_ += entry_size;
+    // Write entry (or keep it in memory while the disk is degraded)
+    current_size_ += write_guarded(entry, record);
+}
+
+void RotatingFileHandler::flush() noexcept {
+    try {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_cv_.wait(lock, [this] {
+            return !retire_pending_ && (next_ready_ || rotation_paused_.load() || rotation_disabled_.load());
+        });
+        flush_file();
+    } catch (...) {
+        // Ignore errors during flush - noexcept guarantee
+    }
 }
 
 bool RotatingFileHandler::should_rotate(std::size_t entry_size) const noexcept {
     // Don't rotate if rotation has been disabled due to previous errors
-    if (rotation_disabled_) {
+    if (rotation_disabled_.load(std::memory_order_relaxed)) {
         return false;
     }
-    return current_size_ + entry_size > max_size_bytes_;
+    return max_size_bytes_ > 0 && current_size_ + entry_size > max_size_bytes_;
+}
+
+void RotatingFileHandler::start_period(std::int64_t timestamp) noexcept {
+    period_start_ = timestamp - timestamp % period_ns_;
+    next_boundary_ = period_start_ + period_ns_;
 }
 
-void RotatingFileHandler::rotate() {
+void RotatingFileHandler::rotate(std::size_t entry_size, std::int64_t timestamp, std::unique_lock<std::mutex>& lock) {
+    if (rotation_paused_.load(std::memory_order_relaxed)) {
+        return;  // Keep writing the current file until the retry
+    }
+    if (!next_ready_) {
+        // Segments are filling faster than the rotator renames them
+        ready_cv_.wait(lock, [this] {
+            return next_ready_ || rotation_paused_.load() || rotation_disabled_.load() || stop_;
+        });
+        if (!next_ready_) {
+            if (rotation_disabled_.load()) {
+                next_boundary_ = INT64_MAX;  // Rotation failed; stop checking the clock
+            }
+            return;
+        }
+        if (timestamp < next_boundary_ && !should_rotate(entry_size)) {
+            return;  // Another writer already rotated
+        }
+    }
+
+    std::int64_t period = period_start_;
+    if (timestamp >= next_boundary_) {
+        start_period(timestamp);
+        if (current_size_ == 0) {
+            return;  // Nothing was written in the previous period
+        }
+    }
+
+    // Swap the prepared segment in; the full one goes back to the rotator
+    if (use_segment()) {
+        segment_.swap(next_segment_);
+        retired_segment_.swap(next_segment_);
+    } else {
+        file_.swap(next_file_);
+        retired_file_.swap(next_file_);
+    }
+    live_path_ = prepared_path();
+    next_ready_ = false;
+    retire_pending_ = true;
+    retired_period_ = period;
+    header_pending_ = true;
+    current_size_ = 0;
+    rotator_cv_.notify_one();
+}
+
+void RotatingFileHandler::recover_next() {
+    std::error_code ec;
+    if (!fs::exists(next_path_, ec)) {
+        return;
+    }
+    if (fs::file_size(next_path_, ec) == 0) {
+        fs::remove(next_path_, ec);  // Prepared but never used
+        return;
+    }
+
+    // A crash between swap and rename left the newest records in .next
     try {
-        // Close current file
         close_file();
+        std::int64_t period = period_ns_ > 0 ? modified_nanos(file_path_) : 0;
+        if (period_ns_ > 0) {
+            period -= period % period_ns_;
+        }
+        move_to_backup(period);
+        fs::rename(next_path_, file_path_);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Log file recovery failed: " << e.what() << std::endl;
+    }
+    open_file();
+}
 
-        // Delete oldest backup if it exists
-        auto oldest = get_backup_path(max_backup_count_);
-        if (fs::exists(oldest)) {
-            fs::remove(oldest);
+void RotatingFileHandler::move_to_backup(std::int64_t period) {
+    std::lock_guard<std::mutex> lock(backup_mutex_);
+
+    CompressJob job;
+    if (naming_ == BackupNaming::Sequence) {
+        // The prepared segment is already live; only the symlink moves,
+        // last, so a failure leaves nothing else to repeat
+        std::uint64_t sequence = sequence_.load() + 1;
+        sequence_.store(sequence);
+        job.path = sequence_path(file_path_, sequence - 1);
+        track_backup(job.path, 0, false);
+
+        // Rotation already happened; a leftover is pruned on next start
+        if (sequence > max_backup_count_ + 1) {
+            auto oldest = sequence_path(file_path_, sequence - max_backup_count_ - 1).string();
+            for (auto suffix : kBackupSuffixes) {
+                remove_backup(oldest + std::string(suffix));
+            }
         }
+    } else if (period_ns_ == 0) {
+        rotate_backups(file_path_, max_backup_count_);
+        job = {backup_path(file_path_, 1), ++cascades_, true};
+        shift_numbered_backups();
+        track_backup(job.path, 1, false);
+    } else {
+        job.path = stamped_path(period);
+        if (fs::exists(file_path_)) {
+            fs::rename(file_path_, job.path);
+            track_backup(job.path, 0, true);
+        }
+        prune_stamped_backups();
+    }
 
-        // Rotate existing backups
-        for (std::size_t i = max_backup_count_; i > 1; --i) {
-            auto src = get_backup_path(i - 1);
-            auto dst = get_backup_path(i);
+    if (compression_ != Compression::None && max_backup_count_ > 0) {
+        compress_queue_.push_back(std::move(job));
+        compress_cv_.notify_one();
+    }
+    update_backup_bytes();
+    if (retention_enabled()) {
+        retention_pending_ = true;
+        retention_cv_.notify_one();
+    }
+    if (naming_ == BackupNaming::Sequence) {
+        point_current(sequence_.load());
+    }
+}
 
-            if (fs::exists(src)) {
-                fs::rename(src, dst);
+void RotatingFileHandler::start_sequence() {
+    close_file();
+
+    // Continue after the newest segment; app.log may be a plain file from
+    // cascade naming (or one FileHandler just created), which joins the chain
+    std::uint64_t newest = 0;
+    auto backups = list_backups(file_path_);
+    for (const auto& backup : backups) {
+        if (backup.stamp.empty()) {
+            newest = std::max<std::uint64_t>(newest, backup.index);
+        }
+    }
+    if (fs::is_regular_file(fs::symlink_status(file_path_))) {
+        fs::rename(file_path_, sequence_path(file_path_, ++newest));
+    }
+    newest = std::max<std::uint64_t>(newest, 1);
+
+    // The newest segment is current even if a crash left the link behind
+    sequence_.store(newest);
+    point_current(newest);
+    live_path_ = sequence_path(file_path_, newest);
+    open_file();
+
+    for (const auto& backup : backups) {
+        if (backup.stamp.empty() && backup.index + max_backup_count_ < newest) {
+            fs::remove(backup.path);
+        }
+    }
+}
+
+void RotatingFileHandler::point_current(std::uint64_t sequence) {
+    // Build the new link beside the old one and rename it over: tailers
+    // always find app.log
+    fs::path link(file_path_.string() + ".link");
+    fs::remove(link);
+    fs::create_symlink(sequence_path(file_path_, sequence).filename(), link);
+    fs::rename(link, file_path_);
+}
+
+fs::path RotatingFileHandler::prepared_path() const {
+    return naming_ == BackupNaming::Sequence
+        ? sequence_path(file_path_, sequence_.load() + 1)
+        : next_path_;
+}
+
+void RotatingFileHandler::queue_uncompressed_backups() {
+    std::lock_guard<std::mutex> lock(backup_mutex_);
+    fs::remove(fs::path(file_path_.string() + ".compressing"));  // Left by a crash
+    for (const auto& backup : backups_) {
+        if (!backup.suffix.empty()) {
+            continue;
+        }
+        // Numbered: pretend the job was queued index - 1 cascades ago.
+        // Stamped backups and segments never move, so their path is enough
+        bool numbered = backup.index > 0;
+        std::uint64_t cascade = numbered ? cascades_ - (backup.index - 1) : 0;
+        compress_queue_.push_back({backup.path, cascade, numbered});
+    }
+}
+
+void RotatingFileHandler::scan_backups() {
+    std::vector<Backup> listed;
+    try {
+        listed = list_backups(file_path_);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Failed to scan log backups: " << e.what() << std::endl;
+        return;  // Keep the inventory we have
+    }
+
+    bool sequenced = naming_ == BackupNaming::Sequence;
+    std::deque<BackupFile> backups;
+    for (auto& backup : listed) {
+        bool stamped = !backup.stamp.empty();
+        if (sequenced && !stamped && backup.index >= sequence_.load()) {
+            continue;  // Current and prepared segments
+        }
+        std::error_code ec;
+        auto size = fs::file_size(backup.path, ec);
+        if (ec) {
+            continue;  // Gone since the listing
+        }
+        std::int64_t modified = modified_nanos(backup.path);
+        backups.push_back({
+            .path = std::move(backup.path),
+            .suffix = backup.suffix,
+            .index = stamped || sequenced ? 0 : backup.index,
+            .stamped = stamped,
+            .bytes = size,
+            .modified_ns = modified
+        });
+    }
+
+    // Oldest first; names break ties between files written in the same tick
+    std::sort(backups.begin(), backups.end(), [](const BackupFile& a, const BackupFile& b) {
+        if (a.modified_ns != b.modified_ns) {
+            return a.modified_ns < b.modified_ns;
+        }
+        if (a.index != b.index) {
+            return a.index > b.index;  // Cascade: .3 is older than .2
+        }
+        return a.path < b.path;  // Periods and segments sort by name
+    });
+    backups_ = std::move(backups);
+    update_backup_bytes();
+}
+
+void RotatingFileHandler::track_backup(fs::path path, std::size_t index, bool stamped) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        return;
+    }
+    std::erase_if(backups_, [&](const BackupFile& backup) { return backup.path == path; });
+    std::int64_t modified = modified_nanos(path);
+    backups_.push_back({std::move(path), {}, index, stamped, size, modified});
+}
+
+void RotatingFileHandler::shift_numbered_backups() {
+    // Mirror rotate_backups(): .max was deleted, .N moved to .N+1
+    std::erase_if(backups_, [this](const BackupFile& backup) {
+        return backup.index > 0 && backup.index == max_backup_count_;
+    });
+    for (auto& backup : backups_) {
+        if (backup.index > 0 && backup.index < max_backup_count_) {
+            ++backup.index;
+            backup.path = backup_path(file_path_, backup.index).string() + std::string(backup.suffix);
+        }
+    }
+}
+
+std::deque<RotatingFileHandler::BackupFile>::iterator
+RotatingFileHandler::delete_backup(std::deque<BackupFile>::iterator backup) {
+    // A failure drops it anyway; the next rescan finds it again
+    std::error_code ec;
+    fs::remove(backup->path, ec);
+    if (ec) {
+        std::cerr << "Failed to delete log backup " << backup->path.string() << ": " << ec.message() << std::endl;
+    }
+    return backups_.erase(backup);
+}
+
+void RotatingFileHandler::remove_backup(const fs::path& path) {
+    auto backup = std::find_if(backups_.begin(), backups_.end(),
+        [&](const BackupFile& tracked) { return tracked.path == path; });
+    if (backup != backups_.end()) {
+        delete_backup(backup);
+    } else {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+}
+
+void RotatingFileHandler::update_backup_bytes() {
+    std::uint64_t total = 0;
+    for (const auto& backup : backups_) {
+        total += backup.bytes;
+    }
+    backup_bytes_.store(total, std::memory_order_relaxed);
+}
+
+void RotatingFileHandler::compressor_thread_func() {
+    lower_thread_priority();
+
+    std::string suffix(compression_suffix(compression_));
+    fs::path temp(file_path_.string() + ".compressing");
+
+    std::unique_lock<std::mutex> lock(backup_mutex_);
+    for (;;) {
+        compress_cv_.wait(lock, [this] { return backup_stop_ || !compress_queue_.empty(); });
+        if (backup_stop_) {
+            break;
+        }
+        CompressJob job = std::move(compress_queue_.front());
+        compress_queue_.pop_front();
+
+        // Where the backup is now; empty if the cascade has deleted it
+        auto locate = [&]() -> fs::path {
+            if (!job.numbered) {
+                return job.path;
             }
+            std::uint64_t index = 1 + (cascades_ - job.cascade);
+            return index <= max_backup_count_ ? backup_path(file_path_, index) : fs::path();
+        };
+
+        // The open file survives renames, so compress without holding the lock
+        std::ifstream in;
+        if (auto source = locate(); !source.empty()) {
+            in.open(source, std::ios::binary);
+        }
+        if (!in) {
+            continue;
+        }
+        compressing_ = true;
+        lock.unlock();
+        auto result = compress_file(in, temp, compression_);
+        in.close();
+        lock.lock();
+        compressing_ = false;
+        if (compress_queue_.empty() && retention_enabled()) {
+            retention_pending_ = true;  // The size limit waited for compression
+            retention_cv_.notify_one();
         }
 
-        // Move current file to .1
-        if (fs::exists(file_path_)) {
-            fs::rename(file_path_, get_backup_path(1));
+        std::error_code ec;
+        auto source = locate();
+        if (!result || source.empty() || !fs::exists(source, ec)) {
+            if (!result) {
+                std::cerr << "Log backup compression failed: " << result.error().message << std::endl;
+            }
+            fs::remove(temp, ec);
+            continue;
         }
 
-        // Reset size counter
-        current_size_ = 0;
+        // Keep the age of the records, not of the compression
+        auto modified = fs::last_write_time(source, ec);
+        if (!ec) {
+            fs::last_write_time(temp, modified, ec);
+        }
+        fs::path compressed(source.string() + suffix);
+        fs::rename(temp, compressed, ec);
+        if (ec) {
+            continue;
+        }
+        fs::remove(source, ec);
+        backups_compressed_.fetch_add(1, std::memory_order_relaxed);
 
-        // Open new file
-        open_file();
+        auto size = fs::file_size(compressed, ec);
+        for (auto& backup : backups_) {
+            if (backup.path == source) {
+                backup.path = std::move(compressed);
+                backup.suffix = compression_suffix(compression_);
+                backup.bytes = ec ? 0 : size;
+                break;
+            }
+        }
+        update_backup_bytes();
+    }
+}
+
+bool RotatingFileHandler::retention_enabled() const noexcept {
+    return retention_.max_total_bytes > 0 || retention_.max_age.count() > 0;
+}
+
+void RotatingFileHandler::enforce_retention() {
+    std::size_t expired = 0;
+
+    if (retention_.max_age.count() > 0) {
+        std::int64_t cutoff = to_nanos(std::chrono::system_clock::now()) -
+            std::chrono::duration_cast<std::chrono::nanoseconds>(retention_.max_age).count();
+        for (auto backup = backups_.begin(); backup != backups_.end();) {
+            if (backup->modified_ns < cutoff) {
+                backup = delete_backup(backup);
+                ++expired;
+            } else {
+                ++backup;
+            }
+        }
+    }
+
+    // Backups about to be compressed would count at their full size
+    bool compression_pending = !compress_queue_.empty() || compressing_;
+    if (retention_.max_total_bytes > 0 && !compression_pending) {
+        std::uint64_t total = 0;
+        for (const auto& backup : backups_) {
+            total += backup.bytes;
+        }
+        while (total > retention_.max_total_bytes && !backups_.empty()) {
+            total -= backups_.front().bytes;
+            delete_backup(backups_.begin());
+            ++expired;
+        }
+    }
+
+    if (expired > 0) {
+        backups_expired_.fetch_add(expired, std::memory_order_relaxed);
+        update_backup_bytes();
+    }
+}
+
+void RotatingFileHandler::retention_thread_func() {
+    lower_thread_priority();
 
+    using namespace std::chrono;
+    auto next_scan = steady_clock::now() + retention_.rescan_interval;
+
+    std::unique_lock<std::mutex> lock(backup_mutex_);
+    for (;;) {
+        enforce_retention();
+
+        // Sleep until the oldest backup expires, the next rescan or the
+        // next change to the inventory
+        nanoseconds wait = hours(24);
+        if (retention_.rescan_interval.count() > 0) {
+            wait = std::min<nanoseconds>(wait, next_scan - steady_clock::now());
+        }
+        if (retention_.max_age.count() > 0 && !backups_.empty()) {
+            auto oldest = std::min_element(backups_.begin(), backups_.end(),
+                [](const BackupFile& a, const BackupFile& b) { return a.modified_ns < b.modified_ns; });
+            wait = std::min(wait, nanoseconds(oldest->modified_ns - to_nanos(system_clock::now())) +
+                duration_cast<nanoseconds>(retention_.max_age));
+        }
+        retention_cv_.wait_for(lock, std::max<nanoseconds>(wait, milliseconds(10)),
+            [this] { return backup_stop_ || retention_pending_; });
+        if (backup_stop_) {
+            break;
+        }
+        retention_pending_ = false;
+
+        if (retention_.rescan_interval.count() > 0 && steady_clock::now() >= next_scan) {
+            scan_backups();
+            next_scan = steady_clock::now() + retention_.rescan_interval;
+        }
+    }
+}
+
+fs::path RotatingFileHandler::stamped_path(std::int64_t period) const {
+    std::time_t seconds = static_cast<std::time_t>(period / kNanosPerSecond);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp),
+        interval_ == RotationInterval::Hourly ? "%Y-%m-%dT%H" : "%Y-%m-%d", &tm);
+
+    // Size rotation within a period (or a restart) adds .1, .2, ...
+    std::string base = file_path_.string() + "." + stamp;
+    fs::path candidate = base;
+    for (std::size_t index = 1; backup_exists(candidate.string()); ++index) {
+        candidate = base + "." + std::to_string(index);
+    }
+    return candidate;
+}
+
+void RotatingFileHandler::prune_stamped_backups() {
+    auto stamped = static_cast<std::size_t>(std::count_if(backups_.begin(), backups_.end(),
+        [](const BackupFile& backup) { return backup.stamped; }));
+    for (auto backup = backups_.begin(); stamped > max_backup_count_ && backup != backups_.end();) {
+        if (backup->stamped) {
+            backup = delete_backup(backup);
+            --stamped;
+        } else {
+            ++backup;
+        }
+    }
+}
+
+bool RotatingFileHandler::open_next(std::ofstream& file, SegmentFile& segment) noexcept {
+    try {
+        fs::path path = prepared_path();
+        if (use_segment()) {
+            segment.open(path, segment_options_);
+        } else {
+            file.open(path, std::ios::app | std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open log file: " + path.string());
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to prepare next log segment: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool RotatingFileHandler::link_live_file() noexcept {
+    try {
+        if (naming_ == BackupNaming::Sequence) {
+            point_current(sequence_.load());
+        } else {
+            fs::rename(next_path_, file_path_);
+            live_path_ = file_path_;
+        }
+        return true;
     } catch (const fs::filesystem_error& e) {
-        // Log to stderr - logging should never crash the application
         std::cerr << "Log file rotation failed: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        // Try to reopen the original file to continue logging
-        try {
-            open_file();
-            // If we get here, we can at least continue logging to the file
-            // even if rotation failed
-        } catch (...) {
-            // If reopening fails too, disable rotation to prevent repeated failures
-            // but file writes will still be attempted in write()
-            std::cerr << "Failed to reopen log file after rotation failure. "
-                      << "Disabling file rotation." << std::endl;
-            rotation_disabled_ = true;
+void RotatingFileHandler::take_back_live_file() noexcept {
+    // The full file is still app.log: append what went to .next since the
+    // swap and continue there, so tailers of app.log miss nothing
+    close_file();
+    try {
+        {
+            std::ifstream in(next_path_, std::ios::binary);
+            std::ofstream out(file_path_, std::ios::app | std::ios::binary);
+            if (in.peek() != std::ifstream::traits_type::eof()) {
+                out << in.rdbuf();
+            }
+            out.close();
+            if (!out) {
+                throw std::runtime_error("Failed to append " + next_path_.string() + " to " + file_path_.string());
+            }
         }
+        fs::remove(next_path_);
+    } catch (const std::exception& e) {
+        // Left in .next, which the next preparation appends to
+        std::cerr << "Failed to move records back from " << next_path_.string() << ": " << e.what() << std::endl;
     }
-}
 
-fs::path RotatingFileHandler::get_backup_path(std::size_t index) const noexcept {
+    live_path_ = file_path_;
     try {
-        return fs::path(file_path_.string() + "." + std::to_string(index));
-    } catch (...) {
-        return file_path_;  // Fallback if string operations fail
+        open_file();
+        header_pending_ = false;  // The file has its header
+        current_size_ = use_segment() ? static_cast<std::size_t>(segment_.size()) : fs::file_size(file_path_);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to reopen log file after rotation failure: " << e.what() << std::endl;
+        std::cerr << "Disabling file rotation." << std::endl;
+        rotation_disabled_.store(true);
+    }
+}
+
+void RotatingFileHandler::schedule_rotation_retry() noexcept {
+    rotation_backoff_ = rotation_backoff_.count() == 0
+        ? kRotationRetryInitial
+        : std::min(rotation_backoff_ * 2, kRotationRetryMax);
+    rotation_retry_at_ = std::chrono::steady_clock::now() + rotation_backoff_;
+    rotation_paused_.store(true);
+    std::cerr << "Retrying log rotation in " << rotation_backoff_.count() << " ms" << std::endl;
+}
+
+void RotatingFileHandler::rotator_thread_func() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        if (retire_pending_) {
+            std::ofstream full_file;
+            SegmentFile full_segment;
+            full_file.swap(retired_file_);
+            full_segment.swap(retired_segment_);
+            std::int64_t period = retired_period_;
+            lock.unlock();
+
+            full_segment.close();
+            try {
+                full_file.close();
+            } catch (...) {
+                // Ignore errors during close - logging continues in the new file
+            }
+
+            bool moved = true;
+            try {
+                move_to_backup(period);
+            } catch (const fs::filesystem_error& e) {
+                // Log to stderr - logging should never crash the application
+                std::cerr << "Log file rotation failed: " << e.what() << std::endl;
+                moved = false;
+            }
+
+            lock.lock();
+            retire_pending_ = false;
+            bool rotated = moved && (naming_ == BackupNaming::Sequence || link_live_file());
+            if (!rotated) {
+                // Sequence: the segment is live, only the symlink is behind.
+                // Cascade: redo the rename if app.log already moved,
+                // otherwise write app.log again
+                std::error_code ec;
+                if (naming_ == BackupNaming::Sequence || !fs::exists(file_path_, ec)) {
+                    link_pending_ = true;
+                } else {
+                    take_back_live_file();
+                }
+                schedule_rotation_retry();
+            } else {
+                rotations_.fetch_add(1, std::memory_order_relaxed);
+                rotation_backoff_ = {};
+            }
+            ready_cv_.notify_all();
+            continue;
+        }
+
+        bool due = !rotation_disabled_.load() && std::chrono::steady_clock::now() >= rotation_retry_at_;
+        if (link_pending_ && due && !stop_) {
+            if (link_live_file()) {
+                link_pending_ = false;
+                rotations_.fetch_add(1, std::memory_order_relaxed);
+                rotation_backoff_ = {};
+            } else {
+                schedule_rotation_retry();
+            }
+            ready_cv_.notify_all();
+            continue;
+        }
+
+        if (!next_ready_ && due && !stop_) {
+            lock.unlock();
+
+            // Open (and preallocate) the next segment off the write path
+            std::ofstream file;
+            SegmentFile segment;
+            bool prepared = open_next(file, segment);
+
+            lock.lock();
+            if (prepared) {
+                next_file_.swap(file);
+                next_segment_.swap(segment);
+                next_ready_ = true;
+            } else {
+                schedule_rotation_retry();
+            }
+            ready_cv_.notify_all();
+            continue;
+        }
+
+        if (rotation_paused_.load() && due && next_ready_ && !link_pending_) {
+            rotation_paused_.store(false);  // Writers rotate again
+            continue;
+        }
+
+        if (stop_) {
+            break;
+        }
+        if (rotation_paused_.load() && !rotation_disabled_.load()) {
+            rotator_cv_.wait_until(lock, rotation_retry_at_);
+        } else {
+            rotator_cv_.wait(lock);
+        }
     }
 }
 
@@ -0,0 +1,195 @@
+/**
+ * @file segment_file.cpp
+ * @brief Preallocated segment writer implementation
+ */
+
+#include <agora/log/handlers/segment_file.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace {
+
+constexpr std::uint64_t round_down(std::uint64_t value) noexcept {
+    return value / SegmentFile::kBlockSize * SegmentFile::kBlockSize;
+}
+
+constexpr std::uint64_t round_up(std::uint64_t value) noexcept {
+    return round_down(value + SegmentFile::kBlockSize - 1);
+}
+
+}  // anonymous namespace
+
+void SegmentFile::open(const std::filesystem::path& path, const SegmentOptions& options) {
+    close();
+
+    // Create parent directories if they don't exist
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    const int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+    direct_ = false;
+    if (options.direct_io) {
+        fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        if (fd_ >= 0) {
+            direct_ = true;
+        } else if (errno != EINVAL) {
+            throw std::system_error(errno, std::generic_category(),
+                "Failed to open log file: " + path.string());
+        }
+    }
+    if (fd_ < 0) {
+        // Plain open, also the fallback for filesystems without O_DIRECT (tmpfs)
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                "Failed to open log file: " + path.string());
+        }
+    }
+
+    if (!buffer_) {
+        buffer_ = {static_cast<char*>(std::aligned_alloc(kBlockSize, kBufferSize)), std::free};
+        if (!buffer_) {
+            ::close(fd_);
+            fd_ = -1;
+            throw std::bad_alloc();
+        }
+    }
+
+    struct stat st{};
+    std::uint64_t size = ::fstat(fd_, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+
+    // Drop NUL padding left by a crash during direct_io
+    if (direct_ && size > 0 && size % kBlockSize == 0 &&
+        ::pread(fd_, buffer_.get(), kBlockSize, static_cast<off_t>(size - kBlockSize)) ==
+            static_cast<ssize_t>(kBlockSize)) {
+        std::size_t used = kBlockSize;
+        while (used > 0 && buffer_.get()[used - 1] == '\0') {
+            --used;
+        }
+        size -= kBlockSize - used;
+    }
+
+    // With O_DIRECT every write starts on a block boundary: stage the
+    // existing partial tail block so it is rewritten with the next data
+    base_ = direct_ ? round_down(size) : size;
+    buffered_ = static_cast<std::size_t>(size - base_);
+    synced_ = buffered_;
+    if (buffered_ > 0 &&
+        ::pread(fd_, buffer_.get(), kBlockSize, static_cast<off_t>(base_)) < static_cast<ssize_t>(buffered_)) {
+        int error = errno;
+        close();
+        throw std::system_error(error, std::generic_category(),
+            "Failed to read log file tail: " + path.string());
+    }
+
+    // Best effort: the segment still works if preallocation is unsupported
+    preallocated_ = options.preallocate_bytes > size &&
+        ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(options.preallocate_bytes)) == 0;
+}
+
+void SegmentFile::write(std::string_view data) {
+    while (!data.empty()) {
+        std::size_t n = std::min(kBufferSize - buffered_, data.size());
+        std::memcpy(buffer_.get() + buffered_, data.data(), n);
+        buffered_ += n;
+        data.remove_prefix(n);
+
+        if (buffered_ == kBufferSize) {
+            write_at(buffer_.get(), kBufferSize, base_);
+            base_ += kBufferSize;
+            buffered_ = 0;
+            synced_ = 0;
+        }
+    }
+}
+
+void SegmentFile::flush() {
+    if (fd_ < 0 || buffered_ == synced_) {
+        return;
+    }
+
+    if (!direct_) {
+        write_at(buffer_.get(), buffered_, base_);
+        base_ += buffered_;
+        buffered_ = 0;
+        synced_ = 0;
+        return;
+    }
+
+    // Zero-pad to a whole block; keep the partial tail staged for the next write
+    std::size_t padded = static_cast<std::size_t>(round_up(buffered_));
+    std::memset(buffer_.get() + buffered_, 0, padded - buffered_);
+    write_at(buffer_.get(), padded, base_);
+
+    std::size_t full = static_cast<std::size_t>(round_down(buffered_));
+    if (full > 0) {
+        std::memmove(buffer_.get(), buffer_.get() + full, buffered_ - full);
+        base_ += full;
+        buffered_ -= full;
+    }
+    synced_ = buffered_;
+}
+
+void SegmentFile::swap(SegmentFile& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(direct_, other.direct_);
+    std::swap(preallocated_, other.preallocated_);
+    buffer_.swap(other.buffer_);
+    std::swap(buffered_, other.buffered_);
+    std::swap(synced_, other.synced_);
+    std::swap(base_, other.base_);
+}
+
+void SegmentFile::close() noexcept {
+    if (fd_ < 0) {
+        return;
+    }
+
+    try {
+        flush();
+    } catch (...) {
+        // Ignore errors during close - noexcept guarantee
+    }
+
+    // Drop block padding, unused preallocated space and anything a failed
+    // write left behind. Cut at the last byte known to be written, not at
+    // size(): staged bytes that never reached the disk would become NULs
+    std::uint64_t written = base_ + synced_;
+    if (direct_ || preallocated_ || written < size()) {
+        (void)::ftruncate(fd_, static_cast<off_t>(written));
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+    base_ = 0;
+    buffered_ = 0;
+    synced_ = 0;
+}
+
+void SegmentFile::write_at(const char* data, std::size_t size, std::uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Failed to write log segment");
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+        offset += static_cast<std::uint64_t>(n);
+    }
+}
+
+}  // namespace agora::log
@@ -0,0 +1,121 @@
+/**
+ * @file syslog.cpp
+ * @brief RFC 5424 syslog handler implementation
+ */
+
+#include <agora/log/handlers/syslog.hpp>
+#include <agora/log/timestamp.hpp>
+#include <charconv>
+#include <variant>
+#include <unistd.h>
+
+namespace agora::log {
+
+namespace {
+
+constexpr std::size_t kMaxName = 32;  // SD-NAME and MSGID limit
+
+// HOSTNAME, APP-NAME, MSGID and SD-NAMEs are printable ASCII without spaces
+// (SD-NAMEs also without '=', ']' and '"'); "-" when empty
+void append_name(std::string& out, std::string_view name, std::size_t max_size, bool sd_name = false) {
+    if (name.empty()) {
+        out.push_back('-');
+        return;
+    }
+    for (char c : name.substr(0, max_size)) {
+        bool allowed = c > ' ' && c < 127 && !(sd_name && (c == '=' || c == ']' || c == '"'));
+        out.push_back(allowed ? c : '_');
+    }
+}
+
+// PARAM-VALUE: escape '"', '\' and ']'
+void append_param(std::string& out, std::string_view name, std::string_view value) {
+    out.push_back(' ');
+    append_name(out, name, kMaxName, true);
+    out.append("=\"");
+    for (char c : value) {
+        if (c == '"' || c == '\\' || c == ']') {
+            out.push_back('\\');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+template <typename T>
+void append_number_param(std::string& out, std::string_view name, T value) {
+    char digits[32];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    append_param(out, name, std::string_view(digits, static_cast<std::size_t>(end - digits)));
+}
+
+}  // anonymous namespace
+
+Rfc5424Formatter::Rfc5424Formatter(int facility)
+    : facility_(facility)
+    , procid_(std::to_string(::getpid())) {
+    char host[256] = {};
+    if (::gethostname(host, sizeof(host) - 1) == 0) {
+        hostname_ = host;
+    }
+}
+
+void Rfc5424Formatter::format(const LogEntry& entry, std::string& out) const {
+    out.push_back('<');
+    out.append(std::to_string(facility_ * 8 + syslog_severity(entry.level)));
+    out.append(">1 ");
+    append_iso8601_utc(out, entry.timestamp);
+    out.push_back(' ');
+    append_name(out, hostname_, 255);
+    out.push_back(' ');
+    append_name(out, entry.service_name, 48);
+    out.push_back(' ');
+    out.append(procid_);
+    out.push_back(' ');
+    append_name(out, entry.logger_name, kMaxName);
+    out.push_back(' ');
+
+    out.append("[src@32473");
+    append_param(out, "file", entry.location.file);
+    append_number_param(out, "line", entry.location.line);
+    append_param(out, "function", entry.location.function);
+    out.push_back(']');
+
+    if (!entry.context.empty() || entry.exception || entry.duration_ms) {
+        out.append("[ctx@32473");
+        for (const auto& [name, value] : entry.context) {
+            std::visit([&](const auto& v) {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, std::string>) {
+                    append_param(out, name, v);
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    append_param(out, name, v ? "true" : "false");
+                } else {
+                    append_number_param(out, name, v);
+                }
+            }, value);
+        }
+        if (entry.exception) {
+            append_param(out, "exception_type", entry.exception->type);
+            append_param(out, "exception_message", entry.exception->message);
+        }
+        if (entry.duration_ms) {
+            append_number_param(out, "duration_ms", *entry.duration_ms);
+        }
+        out.push_back(']');
+    }
+
+    out.push_back(' ');
+    out.append(entry.message);
+}
+
+SyslogHandler::SyslogHandler(
+    const std::filesystem::path& socket_path,
+    int facility,
+    std::size_t buffer_size,
+    std::size_t flush_interval_ms
+)
+    : DatagramHandler(std::make_shared<Rfc5424Formatter>(facility), socket_path, buffer_size, flush_interval_ms) {
+}
+
+}  // namespace agora::log
@@ -0,0 +1,313 @@
+/**
+ * @file json_writer.cpp
+ * @brief JSON serialization primitives implementation
+ */
+
+#include <agora/log/json_writer.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace agora::log {
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+/**
+ * @brief Escape sequence for a byte below 0x20, '"' or '\\'.
+ */
+void append_escaped_byte(std::string& out, unsigned char c) {
+    switch (c) {
+        case '"':  out.append("\\\""); return;
+        case '\\': out.append("\\\\"); return;
+        case '\b': out.append("\\b"); return;
+        case '\f': out.append("\\f"); return;
+        case '\n': out.append("\\n"); return;
+        case '\r': out.append("\\r"); return;
+        case '\t': out.append("\\t"); return;
+        default: {
+            const char esc[6] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF]};
+            out.append(esc, sizeof(esc));
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Length of the valid UTF-8 sequence starting at p, or 0 if invalid.
+ *
+ * Follows the Unicode well-formed byte sequence table (no overlongs,
+ * surrogates or code points above U+10FFFF).
+ */
+std::size_t utf8_sequence_length(const unsigned char* p, std::size_t avail) noexcept {
+    const unsigned char c = p[0];
+    auto cont = [&](std::size_t i, unsigned char lo = 0x80, unsigned char hi = 0xBF) {
+        return i < avail && p[i] >= lo && p[i] <= hi;
+    };
+
+    if (c >= 0xC2 && c <= 0xDF) {
+        return cont(1) ? 2 : 0;
+    }
+    if (c == 0xE0) {
+        return cont(1, 0xA0) && cont(2) ? 3 : 0;
+    }
+    if ((c >= 0xE1 && c <= 0xEC) || c == 0xEE || c == 0xEF) {
+        return cont(1) && cont(2) ? 3 : 0;
+    }
+    if (c == 0xED) {
+        return cont(1, 0x80, 0x9F) && cont(2) ? 3 : 0;
+    }
+    if (c == 0xF0) {
+        return cont(1, 0x90) && cont(2) && cont(3) ? 4 : 0;
+    }
+    if (c >= 0xF1 && c <= 0xF3) {
+        return cont(1) && cont(2) && cont(3) ? 4 : 0;
+    }
+    if (c == 0xF4) {
+        return cont(1, 0x80, 0x8F) && cont(2) && cont(3) ? 4 : 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Number of leading bytes that can be copied without escaping.
+ *
+ * A byte needs attention if it is a control character, '"', '\\' or
+ * non-ASCII (which must be UTF-8 validated). With SSE2 this checks 16
+ * bytes per iteration: a signed compare against 0x20 catches both
+ * control characters and bytes >= 0x80.
+ */
+std::size_t plain_prefix_length(const char* data, std::size_t size) noexcept {
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i special = _mm_or_si128(
+            _mm_cmplt_epi8(chunk, space),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))
+        );
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\') {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Number of leading ASCII bytes (16 per iteration with SSE2).
+ */
+std::size_t ascii_prefix_length(const char* data, std::size_t size) noexcept {
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(chunk);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+
+    while (i < size && static_cast<unsigned char>(data[i]) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+template<typename T>
+void append_integer(std::string& out, T value) {
+    char buf[24];
+    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, ptr);
+}
+
+}  // anonymous namespace
+
+void append_json_string(std::string& out, std::string_view value) {
+    out.push_back('"');
+
+    const char* data = value.data();
+    std::size_t size = value.size();
+    std::size_t pos = 0;
+
+    while (pos < size) {
+        std::size_t run = plain_prefix_length(data + pos, size - pos);
+        out.append(data + pos, run);
+        pos += run;
+        if (pos >= size) {
+            break;
+        }
+
+        auto c = static_cast<unsigned char>(data[pos]);
+        if (c < 0x80) {
+            append_escaped_byte(out, c);
+            ++pos;
+            continue;
+        }
+
+        std::size_t len = utf8_sequence_length(
+            reinterpret_cast<const unsigned char*>(data + pos), size - pos
+        );
+        if (len == 0) {
+            out.append("\xEF\xBF\xBD");  // U+FFFD REPLACEMENT CHARACTER
+            ++pos;
+        } else {
+            out.append(data + pos, len);
+            pos += len;
+        }
+    }
+
+    out.push_back('"');
+}
+
+bool is_valid_utf8(std::string_view value) noexcept {
+    const char* data = value.data();
+    std::size_t size = value.size();
+    std::size_t pos = 0;
+
+    while (true) {
+        pos += ascii_prefix_length(data + pos, size - pos);
+        if (pos >= size) {
+            return true;
+        }
+        std::size_t len = utf8_sequence_length(
+            reinterpret_cast<const unsigned char*>(data + pos), size - pos
+        );
+        if (len == 0) {
+            return false;
+        }
+        pos += len;
+    }
+}
+
+void append_utf8_sanitized(std::string& out, std::string_view value) {
+    const char* data = value.data();
+    std::size_t size = value.size();
+    std::size_t pos = 0;
+
+    while (pos < size) {
+        std::size_t run = ascii_prefix_length(data + pos, size - pos);
+        out.append(data + pos, run);
+        pos += run;
+        if (pos >= size) {
+            break;
+        }
+
+        std::size_t len = utf8_sequence_length(
+            reinterpret_cast<const unsigned char*>(data + pos), size - pos
+        );
+        if (len == 0) {
+            out.append("\xEF\xBF\xBD");  // U+FFFD REPLACEMENT CHARACTER
+            ++pos;
+        } else {
+            out.append(data + pos, len);
+            pos += len;
+        }
+    }
+}
+
+void append_json_int(std::string& out, std::int64_t value) {
+    append_integer(out, value);
+}
+
+void append_json_uint(std::string& out, std::uint64_t value) {
+    append_integer(out, value);
+}
+
+void append_json_double(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out.append("null");
+        return;
+    }
+
+    if (std::signbit(value)) {
+        out.push_back('-');
+        value = -value;
+    }
+
+    if (value == 0.0) {
+        out.append("0.0");
+        return;
+    }
+
+    // Shortest round-trip digits in scientific form: d[.ddd]e±XX
+    char sci[32];
+    auto [sci_end, ec] = std::to_chars(sci, sci + sizeof(sci), value, std::chars_format::scientific);
+
+    char digits[24];
+    int k = 0;
+    const char* p = sci;
+    for (; p < sci_end && *p != 'e'; ++p) {
+        if (*p != '.') {
+            digits[k++] = *p;
+        }
+    }
+    int exp10 = 0;
+    std::from_chars(p + 1 + (p[1] == '+' ? 1 : 0), sci_end, exp10);
+
+    // Same layout as nlohmann::json (dtoa_impl::format_buffer) with
+    // min_exp = -4 and max_exp = digits10 (15)
+    constexpr int kMinExp = -4;
+    constexpr int kMaxExp = 15;
+    const int n = exp10 + 1;  // position of the decimal point
+
+    if (k <= n && n <= kMaxExp) {
+        out.append(digits, static_cast<std::size_t>(k));
+        out.append(static_cast<std::size_t>(n - k), '0');
+        out.append(".0");
+        return;
+    }
+
+    if (0 < n && n <= kMaxExp) {
+        out.append(digits, static_cast<std::size_t>(n));
+        out.push_back('.');
+        out.append(digits + n, static_cast<std::size_t>(k - n));
+        return;
+    }
+
+    if (kMinExp < n && n <= 0) {
+        out.append("0.");
+        out.append(static_cast<std::size_t>(-n), '0');
+        out.append(digits, static_cast<std::size_t>(k));
+        return;
+    }
+
+    out.push_back(digits[0]);
+    if (k > 1) {
+        out.push_back('.');
+        out.append(digits + 1, static_cast<std::size_t>(k - 1));
+    }
+    out.push_back('e');
+
+    int e = n - 1;
+    out.push_back(e < 0 ? '-' : '+');
+    if (e < 0) {
+        e = -e;
+    }
+    if (e < 10) {
+        out.push_back('0');
+    }
+    append_integer(out, e);
+}
+
+}  // namespace agora::log
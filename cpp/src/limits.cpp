@@ -0,0 +1,169 @@
+/**
+ * @file limits.cpp
+ * @brief Record size cap implementation
+ */
+
+#include <agora/log/limits.hpp>
+#include <agora/log/json_writer.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace agora::log {
+
+namespace {
+
+/// Room kept for "...[truncated N bytes]" (at most 41 bytes)
+constexpr std::size_t kMarkerReserve = 48;
+
+/// Bytes of content kept when truncating to @p max_bytes, marker included
+constexpr std::size_t content_budget(std::size_t max_bytes) noexcept {
+    return max_bytes > kMarkerReserve ? max_bytes - kMarkerReserve : 0;
+}
+
+/// Per-record allowance for field names, timestamp, level and punctuation
+constexpr std::size_t kRecordOverhead = 192;
+
+/// Per-context-entry allowance for quoting, separators and numeric values
+constexpr std::size_t kContextEntryOverhead = 32;
+
+void append_marker(std::string& out, std::size_t dropped) {
+    out.append("...[truncated ");
+    append_json_uint(out, dropped);
+    out.append(" bytes]");
+}
+
+bool truncate_in_place(std::string& value, std::size_t max_bytes) {
+    if (value.size() <= max_bytes) {
+        return false;
+    }
+    std::size_t keep = utf8_prefix(value, content_budget(max_bytes)).size();
+    std::size_t dropped = value.size() - keep;
+    value.resize(keep);
+    append_marker(value, dropped);
+    return true;
+}
+
+/**
+ * @brief Shrink the largest strings so their total fits @p budget
+ *        (caller has checked that it does not fit as is).
+ *
+ * Water-filling: fields smaller than the common cut length keep their
+ * full size and donate the slack to the larger ones.
+ */
+void fit_strings(std::vector<std::string*>& fields, std::size_t budget) {
+    std::sort(fields.begin(), fields.end(), [](const auto* a, const auto* b) {
+        return a->size() < b->size();
+    });
+
+    std::size_t remaining = budget;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        std::size_t share = remaining / (fields.size() - i);
+        if (fields[i]->size() > share) {
+            for (std::size_t j = i; j < fields.size(); ++j) {
+                truncate_in_place(*fields[j], share);
+            }
+            return;
+        }
+        remaining -= fields[i]->size();
+    }
+}
+
+}  // anonymous namespace
+
+std::string_view utf8_prefix(std::string_view value, std::size_t max_bytes) noexcept {
+    if (value.size() <= max_bytes) {
+        return value;
+    }
+    // Back off over continuation bytes (10xxxxxx) to a sequence boundary
+    std::size_t end = max_bytes;
+    while (end > 0 && (static_cast<unsigned char>(value[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    return value.substr(0, end);
+}
+
+bool assign_truncated(std::string& out, std::string_view value, std::size_t max_bytes) {
+    if (max_bytes == 0 || value.size() <= max_bytes) {
+        out.assign(value);
+        return false;
+    }
+    auto kept = utf8_prefix(value, content_budget(max_bytes));
+    out.reserve(kept.size() + kMarkerReserve);
+    out.assign(kept);
+    append_marker(out, value.size() - kept.size());
+    return true;
+}
+
+bool apply_limits(LogEntry& entry, const RecordLimits& limits) {
+    bool truncated = false;
+
+    if (limits.max_field_bytes != 0) {
+        truncated |= truncate_in_place(entry.message, limits.max_field_bytes);
+        for (auto& [key, value] : entry.context) {
+            if (auto* str = std::get_if<std::string>(&value)) {
+                truncated |= truncate_in_place(*str, limits.max_field_bytes);
+            }
+        }
+        if (entry.exception) {
+            truncated |= truncate_in_place(entry.exception->message, limits.max_field_bytes);
+        }
+    }
+
+    if (limits.max_record_bytes == 0) {
+        return truncated;
+    }
+
+    // Fixed cost: everything that is not shortened
+    std::size_t fixed = kRecordOverhead
+        + entry.logger_name.size()
+        + entry.location.file.size()
+        + entry.location.function.size()
+        + entry.service_name.size()
+        + entry.environment.size()
+        + entry.version.size()
+        + (entry.exception ? entry.exception->type.size() : 0);
+    std::size_t variable = entry.message.size()
+        + (entry.exception ? entry.exception->message.size() : 0);
+    for (const auto& [key, value] : entry.context) {
+        fixed += key.size() + kContextEntryOverhead;
+        if (const auto* str = std::get_if<std::string>(&value)) {
+            variable += str->size();
+        }
+    }
+
+    if (fixed + variable <= limits.max_record_bytes) [[likely]] {
+        return truncated;
+    }
+
+    // Keys alone over budget: drop context entries until the rest fits
+    if (fixed > limits.max_record_bytes && !entry.context.empty()) {
+        std::int64_t dropped = 0;
+        for (auto it = entry.context.begin();
+             it != entry.context.end() && fixed > limits.max_record_bytes;) {
+            fixed -= it->first.size() + kContextEntryOverhead;
+            it = entry.context.erase(it);
+            ++dropped;
+        }
+        constexpr std::string_view kDroppedKey = "_dropped_keys";
+        entry.context[std::string(kDroppedKey)] = dropped;
+        fixed += kDroppedKey.size() + kContextEntryOverhead;
+    }
+
+    std::vector<std::string*> fields;
+    fields.reserve(entry.context.size() + 2);
+    fields.push_back(&entry.message);
+    for (auto& [key, value] : entry.context) {
+        if (auto* str = std::get_if<std::string>(&value)) {
+            fields.push_back(str);
+        }
+    }
+    if (entry.exception) {
+        fields.push_back(&entry.exception->message);
+    }
+
+    std::size_t budget = limits.max_record_bytes > fixed ? limits.max_record_bytes - fixed : 0;
+    fit_strings(fields, budget);
+    return true;
+}
+
+}  // namespace agora::log
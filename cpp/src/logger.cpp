@@ -4,11 +4,31 @@
  */
 
 #include <agora/log/logger.hpp>
+#include <agora/log/commit.hpp>
 #include <agora/log/config.hpp>
 #include <agora/log/entry.hpp>
 #include <agora/log/handlers/handler.hpp>
 #include <agora/log/handlers/console.hpp>
+#include <agora/log/handlers/buffered_console.hpp>
 #include <agora/log/handlers/rotating_file.hpp>
+#include <agora/log/handlers/buffered_file.hpp>
+#include <agora/log/handlers/io_uring_file.hpp>
+#include <agora/log/handlers/mmap_file.hpp>
+#include <agora/log/handlers/per_thread_file.hpp>
+#include <agora/log/handlers/binary_file.hpp>
+#include <agora/log/handlers/durable_file.hpp>
+#include <agora/log/handlers/journald.hpp>
+#include <agora/log/handlers/syslog.hpp>
+#include <agora/log/formatter.hpp>
+#include <agora/log/pattern.hpp>
+#include <agora/log/limits.hpp>
+#include <agora/log/routing.hpp>
+#include <agora/log/sink_executor.hpp>
+#include <agora/log/spill.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
 #include <mutex>
 #include <unordered_map>
 #include <memory>
@@ -16,14 +36,248 @@
 
 namespace agora::log {
 
+/**
+ * @brief Handlers a logger writes to, one list per level.
+ *
+ * Each list holds only the handlers whose threshold admits that level, so
+ * dispatch never formats a record a handler would discard, and an empty
+ * list lets the logger return before building the entry. With a sink
+ * executor, the same handlers are addressed by their executor index.
+ */
+struct RoutedHandlers {
+    std::array<std::vector<std::shared_ptr<Handler>>, 5> by_level;
+    std::array<std::vector<std::size_t>, 5> sinks_by_level;
+    std::array<std::size_t, 5> durable_by_level{};  // Durable handlers per level
+    std::shared_ptr<SinkExecutor> executor;
+
+    static constexpr std::size_t index(Level level) noexcept {
+        return static_cast<std::size_t>(std::clamp(static_cast<int>(level) / 10 - 1, 0, 4));
+    }
+
+    [[nodiscard]] const std::vector<std::shared_ptr<Handler>>& at(Level level) const noexcept {
+        return by_level[index(level)];
+    }
+};
+
 // Global state
 namespace {
+    /**
+     * @brief A handler created by initialize() with its routing name and
+     *        threshold. Standard handlers receive loggers no route selects.
+     */
+    struct Sink {
+        std::string name;
+        std::shared_ptr<Handler> handler;
+        Level level = Level::Debug;
+        bool standard = true;
+    };
+
     std::mutex g_mutex;
     std::shared_ptr<const Config> g_config;
     std::unordered_map<std::string, Logger> g_loggers;
-    std::vector<std::shared_ptr<Handler>> g_handlers;
+    std::vector<Sink> g_sinks;
+    std::shared_ptr<SinkExecutor> g_executor;  // Runs g_sinks (same order) when set
+    std::atomic<std::uint64_t> g_truncated_records{0};
+}
+
+namespace {
+
+/**
+ * @brief Record formatted once for the current entry, keyed by formatter.
+ */
+struct FormattedRecord {
+    const Formatter* formatter = nullptr;
+    std::string bytes;
+};
+
+/**
+ * @brief Per-thread arena of record buffers reused across entries.
+ *
+ * `depth` guards against re-entrant logging from inside a handler, which
+ * would otherwise overwrite buffers still referenced by the outer call.
+ */
+struct DispatchArena {
+    std::vector<FormattedRecord> records;
+    int depth = 0;
+};
+
+thread_local DispatchArena t_arena;
+
+}  // anonymous namespace
+
+void dispatch(const std::vector<std::shared_ptr<Handler>>& handlers, const LogEntry& entry) {
+    DispatchArena nested;
+    DispatchArena& arena = (t_arena.depth == 0) ? t_arena : nested;
+    ++t_arena.depth;
+    std::size_t used = 0;
+
+    for (const auto& handler : handlers) {
+        try {
+            const Formatter* formatter = handler->formatter();
+            if (!formatter) {
+                handler->write(entry);
+                continue;
+            }
+
+            std::size_t slot = 0;
+            while (slot < used && arena.records[slot].formatter != formatter) {
+                ++slot;
+            }
+            if (slot == used) {
+                if (used == arena.records.size()) {
+                    arena.records.emplace_back();
+                }
+                auto& record = arena.records[slot];
+                record.formatter = nullptr;
+                record.bytes.clear();
+                formatter->format(entry, record.bytes);
+                record.formatter = formatter;
+                ++used;
+            }
+
+            handler->write_formatted(entry, arena.records[slot].bytes);
+        } catch (...) {
+            // Ignore handler errors to prevent logging from crashing the application,
+            // but do not leave a commit token waiting for this handler
+            if (entry.commit && handler->durable()) {
+                entry.commit->complete(EIO);
+            }
+        }
+    }
+
+    --t_arena.depth;
+}
+
+namespace {
+
+/**
+ * @brief Per-level handler lists for a logger, from the best matching
+ *        route and the handler thresholds.
+ */
+std::shared_ptr<const RoutedHandlers> resolve_handlers(std::string_view name, const Config& config) {
+    const Route* route = find_route(config.routes, name);
+    Level min_level = (route && route->level) ? *route->level : config.level;
+
+    auto selected = [&](const Sink& sink) {
+        if (!route || (route->handlers.empty() && route->file.empty())) {
+            return sink.standard;
+        }
+        if (!route->file.empty() && sink.name == route->file.string()) {
+            return true;
+        }
+        return std::find(route->handlers.begin(), route->handlers.end(), sink.name) != route->handlers.end();
+    };
+
+    auto resolved = std::make_shared<RoutedHandlers>();
+    resolved->executor = g_executor;
+    for (std::size_t i = 0; i < g_sinks.size(); ++i) {
+        const Sink& sink = g_sinks[i];
+        if (!selected(sink)) {
+            continue;
+        }
+        Level threshold = std::max(min_level, sink.level);
+        for (Level level : {Level::Debug, Level::Info, Level::Warning, Level::Error, Level::Critical}) {
+            if (level >= threshold) {
+                resolved->by_level[RoutedHandlers::index(level)].push_back(sink.handler);
+                resolved->sinks_by_level[RoutedHandlers::index(level)].push_back(i);
+                if (sink.handler->durable()) {
+                    ++resolved->durable_by_level[RoutedHandlers::index(level)];
+                }
+            }
+        }
+    }
+    return resolved;
 }
 
+/**
+ * @brief Hand an entry to the handlers accepting @p level: queued on the
+ *        sink executor when there is one, otherwise written inline.
+ */
+void deliver(const RoutedHandlers& routed, Level level, LogEntry&& entry) {
+    if (routed.executor) {
+        routed.executor->submit(routed.sinks_by_level[RoutedHandlers::index(level)], std::move(entry));
+    } else {
+        dispatch(routed.at(level), entry);
+    }
+}
+
+/**
+ * @brief Create the file handler selected by the file settings of @p config.
+ */
+std::shared_ptr<Handler> make_file_handler(
+    const Config& config,
+    const std::filesystem::path& path,
+    std::shared_ptr<const Formatter> formatter
+) {
+    std::size_t max_size_bytes = config.max_file_size_mb * 1024 * 1024;
+
+    if (config.file_per_thread) {
+        return std::make_shared<PerThreadFileHandler>(
+            path,
+            std::move(formatter),
+            config.file_buffer_size,
+            config.file_flush_interval_ms
+        );
+    }
+    if (config.file_mmap) {
+        // Segments need a fixed size, so "never rotate" maps 64 MB segments
+        return std::make_shared<MmapFileHandler>(
+            path,
+            max_size_bytes > 0 ? max_size_bytes : 64 * 1024 * 1024,
+            config.max_backup_count,
+            std::move(formatter)
+        );
+    }
+    if (config.file_io_uring) {
+        return make_io_uring_file_handler(
+            path,
+            config.file_buffer_size,
+            config.file_io_uring_queue_depth,
+            config.file_flush_interval_ms,
+            std::move(formatter),
+            false,
+            max_size_bytes,
+            config.max_backup_count
+        );
+    }
+    if (config.file_buffered) {
+        return std::make_shared<BufferedFileHandler>(
+            path,
+            config.file_buffer_size,
+            config.file_flush_interval_ms,
+            std::move(formatter),
+            max_size_bytes,
+            config.max_backup_count
+        );
+    }
+    return std::make_shared<RotatingFileHandler>(
+        path,
+        max_size_bytes,
+        config.max_backup_count,
+        std::move(formatter),
+        SegmentOptions{
+            .preallocate_bytes = config.file_preallocate ? max_size_bytes : 0,
+            .direct_io = config.file_direct_io
+        },
+        config.file_rotation_interval,
+        config.file_compress,
+        config.file_backup_naming,
+        SpillOptions{
+            .spill_bytes = config.file_spill_bytes,
+            .slow_write = std::chrono::milliseconds(config.file_slow_write_ms),
+            .retry_initial = std::chrono::milliseconds(config.file_retry_initial_ms),
+            .retry_max = std::chrono::milliseconds(config.file_retry_max_ms)
+        },
+        RetentionOptions{
+            .max_total_bytes = static_cast<std::uint64_t>(config.file_retention_max_mb * 1024 * 1024),
+            .max_age = std::chrono::seconds(config.file_retention_max_age_s),
+            .rescan_interval = std::chrono::seconds(config.file_retention_rescan_s)
+        }
+    );
+}
+
+}  // anonymous namespace
+
 // Logger implementation
 
 Logger::Logger(
@@ -34,7 +288,19 @@ Logger::Logger(
     : name_(std::move(name))
     , config_(std::move(config))
     , context_(std::move(context))
-    , handlers_(g_handlers) {
+    , handlers_(resolve_handlers(name_, *config_)) {
+}
+
+Logger::Logger(
+    std::string name,
+    std::shared_ptr<const Config> config,
+    Context context,
+    std::shared_ptr<const RoutedHandlers> handlers
+)
+    : name_(std::move(name))
+    , config_(std::move(config))
+    , context_(std::move(context))
+    , handlers_(std::move(handlers)) {
 }
 
 void Logger::info(
@@ -78,12 +344,20 @@ void Logger::error(
     log(Level::Error, message, loc, std::move(ctx), &ex);
 }
 
-void Logger::critical(
+CommitToken Logger::critical(
+    std::string_view message,
+    Context ctx,
+    SourceLocation loc
+) const {
+    return log(Level::Critical, message, loc, std::move(ctx), nullptr, true);
+}
+
+CommitToken Logger::audit(
     std::string_view message,
     Context ctx,
     SourceLocation loc
 ) const {
-    log(Level::Critical, message, loc, std::move(ctx));
+    return log(Level::Info, message, loc, std::move(ctx), nullptr, true);
 }
 
 Logger Logger::with_context(Context additional_context) const {
@@ -93,7 +367,8 @@ Logger Logger::with_context(Context additional_context) const {
         merged[key] = std::move(value);
     }
 
-    return Logger(name_, config_, std::move(merged));
+    // Same name, same routing: share the resolved handlers
+    return Logger(name_, config_, std::move(merged), handlers_);
 }
 
 Timer Logger::timer(
@@ -110,17 +385,20 @@ Timer Logger::timer(
     return Timer(*this, std::move(operation), std::move(merged), loc);
 }
 
-void Logger::log(
+CommitToken Logger::log(
     Level level,
     std::string_view message,
     const SourceLocation& loc,
     Context ctx,
-    const std::exception* ex
+    const std::exception* ex,
+    bool commit
 ) const {
-    // Filter by level - use [[unlikely]] since most logs pass the filter
+    // Filter by level (global, route and handler thresholds, resolved at
+    // logger creation) - use [[unlikely]] since most logs pass the filter
     // when the configured level is appropriate
-    if (level < config_->level) [[unlikely]] {
-        return;
+    const auto& handlers = handlers_->at(level);
+    if (handlers.empty()) [[unlikely]] {
+        return {};
     }
 
     // Merge context: default + logger + call
@@ -136,7 +414,8 @@ void Logger::log(
     LogEntry entry;
     entry.timestamp = std::chrono::system_clock::now();
     entry.level = level;
-    entry.message = std::string(message);
+    // Oversized messages are cut while copying, never copied in full
+    bool truncated = assign_truncated(entry.message, message, config_->limits.max_field_bytes);
     entry.logger_name = name_;
     entry.location = loc;
     entry.context = std::move(merged);
@@ -160,14 +439,22 @@ void Logger::log(
         entry.exception = ex_info;
     }
 
-    // Write to all handlers
-    for (const auto& handler : handlers_) {
-        try {
-            handler->write(entry);
-        } catch (...) {
-            // Ignore handler errors to prevent logging from crashing the application
+    if (apply_limits(entry, config_->limits) || truncated) [[unlikely]] {
+        g_truncated_records.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Each durable handler receiving the record completes the token once
+    CommitToken token;
+    if (commit) {
+        if (std::size_t durable = handlers_->durable_by_level[RoutedHandlers::index(level)]; durable > 0) {
+            entry.commit = std::make_shared<CommitState>(durable);
+            token = CommitToken(entry.commit);
         }
     }
+
+    // Format once per distinct formatter and fan out to the accepting handlers
+    deliver(*handlers_, level, std::move(entry));
+    return token;
 }
 
 // Timer implementation
@@ -238,14 +525,12 @@ Timer::~Timer() {
         entry.environment = logger_->config_->environment;
         entry.version = logger_->config_->version;
 
-        // Write to handlers
-        for (const auto& handler : logger_->handlers_) {
-            try {
-                handler->write(entry);
-            } catch (...) {
-                // Ignore errors
-            }
+        if (apply_limits(entry, logger_->config_->limits)) [[unlikely]] {
+            g_truncated_records.fetch_add(1, std::memory_order_relaxed);
         }
+
+        // Write to handlers
+        deliver(*logger_->handlers_, Level::Info, std::move(entry));
     }
 }
 
@@ -263,26 +548,106 @@ std::expected<void, Error> initialize(const Config& config) {
         // Store config
         g_config = std::make_shared<Config>(config);
 
-        // Clear existing handlers
-        g_handlers.clear();
+        // Clear existing handlers; cached loggers hold the old routing
+        if (g_executor) {
+            g_executor->stop();
+            g_executor.reset();
+        }
+        g_sinks.clear();
+        g_loggers.clear();
+
+        auto format_options = make_format_options(config.output_profile, config.timestamp_format);
+
+        // One JSON formatter shared by console and file, so an entry is
+        // serialized once even when both outputs are enabled
+        auto json_formatter = std::make_shared<JsonFormatter>(format_options);
 
         // Create console handler if enabled
         if (config.console_enabled) {
-            g_handlers.push_back(
-                std::make_shared<ConsoleHandler>(config.console_json)
-            );
+            auto console_formatter = config.console_json
+                ? std::shared_ptr<const Formatter>(json_formatter)
+                : std::make_shared<PatternFormatter>(config.console_pattern, format_options);
+            std::shared_ptr<Handler> console;
+            if (config.console_buffered) {
+                console = std::make_shared<BufferedConsoleHandler>(
+                    std::move(console_formatter),
+                    256 * 1024,
+                    100,
+                    config.console_drop_when_full
+                );
+            } else {
+                console = std::make_shared<ConsoleHandler>(std::move(console_formatter));
+            }
+            g_sinks.push_back({"console", std::move(console), config.console_level});
         }
 
+        auto file_formatter = config.file_format == FileFormat::Cbor
+            ? std::make_shared<CborFormatter>(format_options)
+            : std::shared_ptr<const Formatter>(json_formatter);
+
         // Create file handler if enabled
         if (config.file_enabled) {
-            std::size_t max_size_bytes = config.max_file_size_mb * 1024 * 1024;
-
-            g_handlers.push_back(
-                std::make_shared<RotatingFileHandler>(
-                    config.file_path,
-                    max_size_bytes,
-                    config.max_backup_count
-                )
+            g_sinks.push_back({
+                "file", make_file_handler(config, config.file_path, file_formatter), config.file_level
+            });
+        }
+
+        // Create binary file handler if enabled
+        if (config.binary_file_enabled) {
+            g_sinks.push_back({"binary", std::make_shared<BinaryFileHandler>(config.binary_file_path)});
+        }
+
+        // Local journald / syslog daemons
+        if (config.journald_enabled) {
+            g_sinks.push_back({"journald", std::make_shared<JournaldHandler>(config.journald_socket)});
+        }
+        if (config.syslog_enabled) {
+            g_sinks.push_back({
+                "syslog", std::make_shared<SyslogHandler>(config.syslog_socket, config.syslog_facility)
+            });
+        }
+
+        // Durable (group-commit) file; only loggers routed to it write there
+        if (config.durable_file_enabled) {
+            g_sinks.push_back({
+                "durable",
+                std::make_shared<DurableFileHandler>(
+                    config.durable_file_path,
+                    json_formatter,
+                    std::chrono::microseconds(config.durable_max_batch_delay_us)
+                ),
+                config.file_level,
+                false
+            });
+        }
+
+        // Dedicated files of routing rules, one handler per distinct path
+        for (const auto& route : config.routes) {
+            if (route.file.empty()) {
+                continue;
+            }
+            auto name = route.file.string();
+            bool exists = std::any_of(g_sinks.begin(), g_sinks.end(), [&](const Sink& sink) {
+                return sink.name == name;
+            });
+            if (!exists) {
+                g_sinks.push_back({
+                    name, make_file_handler(config, route.file, file_formatter), config.file_level, false
+                });
+            }
+        }
+
+        // Parallel fan-out with one queue per handler
+        if (config.sink_workers > 0 && !g_sinks.empty()) {
+            std::vector<std::pair<std::string, std::shared_ptr<Handler>>> sinks;
+            for (const auto& sink : g_sinks) {
+                sinks.emplace_back(sink.name, sink.handler);
+            }
+            g_executor = std::make_shared<SinkExecutor>(
+                std::move(sinks),
+                config.sink_workers,
+                config.sink_queue_capacity,
+                config.sink_drop_when_full
             );
         }
 
@@ -295,10 +660,13 @@ std::expected<void, Error> initialize(const Config& config) {
 void flush() {
     std::lock_guard<std::mutex> lock(g_mutex);
 
-    // Flush all handlers without clearing state
-    for (const auto& handler : g_handlers) {
+    // Write queued records, then flush all handlers without clearing state
+    if (g_executor) {
+        g_executor->drain();
+    }
+    for (const auto& sink : g_sinks) {
         try {
-            handler->flush();
+            sink.handler->flush();
         } catch (...) {
             // Ignore errors during flush
         }
@@ -308,17 +676,21 @@ void flush() {
 void shutdown() {
     std::lock_guard<std::mutex> lock(g_mutex);
 
-    // Flush all handlers
-    for (const auto& handler : g_handlers) {
+    // Write queued records and stop the pool, then flush all handlers
+    if (g_executor) {
+        g_executor->stop();
+    }
+    for (const auto& sink : g_sinks) {
         try {
-            handler->flush();
+            sink.handler->flush();
         } catch (...) {
             // Ignore errors during shutdown
         }
     }
 
     // Clear state
-    g_handlers.clear();
+    g_executor.reset();
+    g_sinks.clear();
     g_loggers.clear();
     g_config.reset();
 }
@@ -348,4 +720,24 @@ Logger get_logger(std::string_view name) {
     return inserted_it->second;
 }
 
+std::uint64_t truncated_records() noexcept {
+    return g_truncated_records.load(std::memory_order_relaxed);
+}
+
+std::vector<SinkStats> sink_stats() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_executor ? g_executor->stats() : std::vector<SinkStats>{};
+}
+
+std::vector<std::pair<std::string, DiskStats>> disk_stats() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::vector<std::pair<std::string, DiskStats>> result;
+    for (const auto& sink : g_sinks) {
+        if (auto* file = dynamic_cast<FileHandler*>(sink.handler.get())) {
+            result.emplace_back(sink.name, file->disk_stats());
+        }
+    }
+    return result;
+}
+
 }  // namespace agora::log
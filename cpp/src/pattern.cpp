@@ -0,0 +1,190 @@
+/**
+ * @file pattern.cpp
+ * @brief Compiled pattern layout implementation
+ */
+
+#include <agora/log/pattern.hpp>
+#include <agora/log/json_writer.hpp>
+#include <agora/log/timestamp.hpp>
+#include <charconv>
+#include <optional>
+
+namespace agora::log {
+
+namespace {
+
+/**
+ * @brief Append a double like `std::ostream << value` with default flags
+ * (general notation, precision 6), without touching the locale.
+ */
+void append_text_double(std::string& out, double value) {
+    char buf[32];
+    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+    out.append(buf, ptr);
+}
+
+void append_text_value(std::string& out, const ContextValue& value) {
+    std::visit([&out](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            out.append(v);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            append_json_bool(out, v);
+        } else if constexpr (std::is_same_v<T, std::int64_t>) {
+            append_json_int(out, v);
+        } else {
+            append_text_double(out, v);
+        }
+    }, value);
+}
+
+void append_text_timestamp(
+    std::string& out,
+    std::chrono::system_clock::time_point tp,
+    const FormatOptions& options,
+    bool local
+) {
+    if (options.timestamp_format != TimestampFormat::Iso8601) {
+        append_timestamp(out, tp, options.timestamp_format);
+    } else if (local) {
+        append_local_datetime(out, tp);
+    } else {
+        append_iso8601_utc(out, tp);
+    }
+}
+
+}  // anonymous namespace
+
+PatternLayout::PatternLayout(std::string_view pattern)
+    : pattern_(pattern) {
+
+    auto push_literal = [this](std::string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        // Merge adjacent literals into a single step
+        if (!steps_.empty() && steps_.back().op == Op::Literal &&
+            steps_.back().offset + steps_.back().length == literals_.size()) {
+            steps_.back().length += static_cast<std::uint32_t>(text.size());
+        } else {
+            steps_.push_back(Step{
+                Op::Literal,
+                static_cast<std::uint32_t>(literals_.size()),
+                static_cast<std::uint32_t>(text.size())
+            });
+        }
+        literals_.append(text);
+    };
+
+    std::size_t pos = 0;
+    while (pos < pattern.size()) {
+        auto pct = pattern.find('%', pos);
+        if (pct == std::string_view::npos || pct + 1 >= pattern.size()) {
+            push_literal(pattern.substr(pos));
+            break;
+        }
+        push_literal(pattern.substr(pos, pct - pos));
+
+        char spec = pattern[pct + 1];
+        std::optional<Op> op;
+        switch (spec) {
+            case 'T': op = Op::Timestamp; break;
+            case 't': op = Op::LocalTime; break;
+            case 'l': op = Op::Level; break;
+            case 'n': op = Op::LoggerName; break;
+            case 'S': op = Op::Service; break;
+            case 'e': op = Op::Environment; break;
+            case 'v': op = Op::Version; break;
+            case 's': op = Op::File; break;
+            case '#': op = Op::Line; break;
+            case 'f': op = Op::Function; break;
+            case 'm': op = Op::Message; break;
+            case 'C': op = Op::Context; break;
+            case 'D': op = Op::Duration; break;
+            case 'E': op = Op::Exception; break;
+            case '%': push_literal("%"); break;
+            default: push_literal(pattern.substr(pct, 2)); break;
+        }
+        if (op) {
+            steps_.push_back(Step{*op});
+        }
+        pos = pct + 2;
+    }
+}
+
+void PatternLayout::format(const LogEntry& entry, std::string& out, const FormatOptions& options) const {
+    for (const auto& step : steps_) {
+        switch (step.op) {
+            case Op::Literal:
+                out.append(literals_, step.offset, step.length);
+                break;
+            case Op::Timestamp:
+                append_text_timestamp(out, entry.timestamp, options, false);
+                break;
+            case Op::LocalTime:
+                append_text_timestamp(out, entry.timestamp, options, true);
+                break;
+            case Op::Level:
+                out.append(to_string(entry.level));
+                break;
+            case Op::LoggerName:
+                out.append(entry.logger_name);
+                break;
+            case Op::Service:
+                out.append(entry.service_name);
+                break;
+            case Op::Environment:
+                out.append(entry.environment);
+                break;
+            case Op::Version:
+                out.append(entry.version);
+                break;
+            case Op::File:
+                out.append(entry.location.file);
+                break;
+            case Op::Line:
+                append_json_uint(out, entry.location.line);
+                break;
+            case Op::Function:
+                out.append(options.trim_function
+                    ? entry.location.unqualified_function()
+                    : entry.location.function);
+                break;
+            case Op::Message:
+                out.append(entry.message);
+                break;
+            case Op::Context:
+                if (!entry.context.empty()) {
+                    out.append(" (");
+                    bool first = true;
+                    for (const auto& [key, value] : entry.context) {
+                        if (!first) out.append(", ");
+                        first = false;
+                        out.append(key);
+                        out.push_back('=');
+                        append_text_value(out, value);
+                    }
+                    out.push_back(')');
+                }
+                break;
+            case Op::Duration:
+                if (entry.duration_ms) {
+                    out.append(" [");
+                    append_text_double(out, *entry.duration_ms);
+                    out.append("ms]");
+                }
+                break;
+            case Op::Exception:
+                if (entry.exception) {
+                    out.append(" [");
+                    out.append(entry.exception->type);
+                    out.append(": ");
+                    out.append(entry.exception->message);
+                    out.push_back(']');
+                }
+                break;
+        }
+    }
+}
+
+}  // namespace agora::log
@@ -0,0 +1,87 @@
+/**
+ * @file routing.cpp
+ * @brief Routing rule matching and parsing
+ */
+
+#include <agora/log/routing.hpp>
+
+namespace agora::log {
+
+namespace {
+
+constexpr Level kInvalidLevel = static_cast<Level>(0);
+
+std::string_view trim(std::string_view str) noexcept {
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+// Call fn for each non-empty, trimmed item separated by `separator`
+template <typename Fn>
+void split(std::string_view str, char separator, Fn&& fn) {
+    while (!str.empty()) {
+        auto end = str.find(separator);
+        auto item = trim(str.substr(0, end));
+        if (!item.empty()) {
+            fn(item);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        str.remove_prefix(end + 1);
+    }
+}
+
+}  // anonymous namespace
+
+const Route* find_route(const std::vector<Route>& routes, std::string_view logger_name) noexcept {
+    const Route* best = nullptr;
+    for (const auto& route : routes) {
+        if (matches_prefix(route.prefix, logger_name) &&
+            (!best || route.prefix.size() > best->prefix.size())) {
+            best = &route;
+        }
+    }
+    return best;
+}
+
+std::vector<Route> parse_routes(std::string_view spec) {
+    std::vector<Route> routes;
+
+    split(spec, ';', [&](std::string_view rule) {
+        Route route;
+        auto colon = rule.find(':');
+        route.prefix = std::string(trim(rule.substr(0, colon)));
+        if (colon != std::string_view::npos) {
+            split(rule.substr(colon + 1), ',', [&](std::string_view option) {
+                auto equals = option.find('=');
+                if (equals == std::string_view::npos) {
+                    return;
+                }
+                auto key = trim(option.substr(0, equals));
+                auto value = trim(option.substr(equals + 1));
+                if (key == "level") {
+                    if (Level level = from_string(value, kInvalidLevel); level != kInvalidLevel) {
+                        route.level = level;
+                    }
+                } else if (key == "handlers") {
+                    split(value, '+', [&](std::string_view name) {
+                        route.handlers.emplace_back(name);
+                    });
+                } else if (key == "file") {
+                    route.file = value;
+                }
+            });
+        }
+        routes.push_back(std::move(route));
+    });
+
+    return routes;
+}
+
+}  // namespace agora::log
@@ -0,0 +1,248 @@
+/**
+ * @file sink_executor.cpp
+ * @brief Parallel sink fan-out implementation
+ */
+
+#include <agora/log/sink_executor.hpp>
+#include <agora/log/commit.hpp>
+#include <algorithm>
+#include <cerrno>
+
+namespace agora::log {
+
+namespace {
+
+constexpr std::int32_t kSkip = -2;  // Formatting failed: nothing to write
+
+}  // anonymous namespace
+
+SinkExecutor::SinkExecutor(
+    std::vector<std::pair<std::string, std::shared_ptr<Handler>>> sinks,
+    std::size_t workers,
+    std::size_t queue_capacity,
+    bool drop_when_full
+)
+    : queue_capacity_(std::max<std::size_t>(queue_capacity, 1))
+    , drop_when_full_(drop_when_full) {
+
+    sinks_.reserve(sinks.size());
+    for (auto& [name, handler] : sinks) {
+        auto sink = std::make_unique<Sink>();
+        sink->stats.name = std::move(name);
+        sink->handler = std::move(handler);
+        sinks_.push_back(std::move(sink));
+    }
+
+    // More threads than sinks would only wait: a sink has one worker at a time
+    std::size_t count = std::min(std::max<std::size_t>(workers, 1), sinks_.size());
+    workers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers_.emplace_back(&SinkExecutor::worker_thread_func, this);
+    }
+}
+
+SinkExecutor::~SinkExecutor() noexcept {
+    stop();
+}
+
+void SinkExecutor::submit(std::span<const std::size_t> sinks, LogEntry entry) {
+    auto record = std::make_shared<Record>();
+    record->entry = std::move(entry);
+
+    // Format once per distinct formatter, before any worker can see the record
+    thread_local std::vector<std::int32_t> slots;
+    slots.clear();
+    for (std::size_t index : sinks) {
+        const Formatter* formatter = sinks_[index]->handler->formatter();
+        if (!formatter) {
+            slots.push_back(-1);
+            continue;
+        }
+        auto it = std::find_if(record->formatted.begin(), record->formatted.end(),
+            [&](const auto& formatted) { return formatted.first == formatter; });
+        if (it == record->formatted.end()) {
+            std::string bytes;
+            try {
+                formatter->format(record->entry, bytes);
+            } catch (...) {
+                // Ignore formatter errors, as the synchronous path does
+                slots.push_back(kSkip);
+                continue;
+            }
+            record->formatted.emplace_back(formatter, std::move(bytes));
+            it = record->formatted.end() - 1;
+        }
+        slots.push_back(static_cast<std::int32_t>(it - record->formatted.begin()));
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < sinks.size(); ++i) {
+        Sink& sink = *sinks_[sinks[i]];
+        if (slots[i] == kSkip) {
+            fail_commit(sink, *record, EIO);
+            continue;
+        }
+        Item item{record, slots[i], now};
+
+        std::unique_lock<std::mutex> lock(sink.mutex);
+        if (sink.queue.size() >= queue_capacity_ && !stopped_.load()) {
+            if (drop_when_full_) {
+                ++sink.stats.dropped;
+                fail_commit(sink, *record, ENOBUFS);
+                continue;
+            }
+            sink.space_cv.wait(lock, [&] {
+                return sink.queue.size() < queue_capacity_ || stopped_.load();
+            });
+        }
+
+        // Checked under the sink mutex: stop() passes every sink mutex after
+        // setting stopped_, so records queued here are still drained
+        if (stopped_.load()) [[unlikely]] {
+            // Records queued before stop() go first: let the worker finish them
+            sink.drained_cv.wait(lock, [&] {
+                return sink.queue.empty() && sink.in_flight == 0;
+            });
+            lock.unlock();
+            write(sink, item);
+            lock.lock();
+            ++sink.stats.written;
+            continue;
+        }
+
+        sink.queue.push_back(std::move(item));
+        sink.stats.max_queued = std::max(sink.stats.max_queued, sink.queue.size() + sink.in_flight);
+        if (!sink.scheduled) {
+            sink.scheduled = true;
+            schedule(sinks[i]);
+        }
+    }
+}
+
+void SinkExecutor::drain() noexcept {
+    for (auto& sink : sinks_) {
+        std::unique_lock<std::mutex> lock(sink->mutex);
+        sink->drained_cv.wait(lock, [&] {
+            return sink->queue.empty() && sink->in_flight == 0;
+        });
+    }
+}
+
+void SinkExecutor::stop() noexcept {
+    if (stopped_.exchange(true)) {
+        return;
+    }
+
+    // Barrier: a submit() that saw stopped_ == false has scheduled its
+    // records once it releases the sink mutex
+    for (auto& sink : sinks_) {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        sink->space_cv.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        stopping_ = true;
+    }
+    pool_cv_.notify_all();
+
+    // Workers exit once no sink has queued records
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+std::vector<SinkStats> SinkExecutor::stats() const {
+    std::vector<SinkStats> result;
+    result.reserve(sinks_.size());
+    for (const auto& sink : sinks_) {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        result.push_back(sink->stats);
+        result.back().queued = sink->queue.size() + sink->in_flight;
+    }
+    return result;
+}
+
+void SinkExecutor::write(Sink& sink, const Item& item) noexcept {
+    try {
+        const auto& entry = item.record->entry;
+        if (item.slot < 0) {
+            sink.handler->write(entry);
+        } else {
+            sink.handler->write_formatted(entry, item.record->formatted[static_cast<std::size_t>(item.slot)].second);
+        }
+    } catch (...) {
+        // Ignore handler errors to prevent logging from crashing the application
+        fail_commit(sink, *item.record, EIO);
+    }
+}
+
+void SinkExecutor::fail_commit(Sink& sink, const Record& record, int error) noexcept {
+    // The handler will never complete the token for this record
+    if (record.entry.commit && sink.handler->durable()) {
+        record.entry.commit->complete(error);
+    }
+}
+
+void SinkExecutor::schedule(std::size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        ready_.push_back(index);
+    }
+    pool_cv_.notify_one();
+}
+
+void SinkExecutor::worker_thread_func() {
+    using namespace std::chrono;
+
+    std::vector<Item> batch;
+
+    for (;;) {
+        std::size_t index;
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            pool_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+            if (ready_.empty()) {
+                return;
+            }
+            index = ready_.front();
+            ready_.pop_front();
+        }
+
+        // This worker owns the sink until it clears `scheduled` or requeues it
+        Sink& sink = *sinks_[index];
+        {
+            std::lock_guard<std::mutex> lock(sink.mutex);
+            batch.swap(sink.queue);
+            sink.in_flight = batch.size();
+        }
+        sink.space_cv.notify_all();
+
+        nanoseconds last_lag{0};
+        nanoseconds max_lag{0};
+        for (const auto& item : batch) {
+            write(sink, item);
+            last_lag = duration_cast<nanoseconds>(steady_clock::now() - item.submitted);
+            max_lag = std::max(max_lag, last_lag);
+        }
+        std::size_t written = batch.size();
+        batch.clear();  // Releases the records, keeps the capacity
+
+        std::lock_guard<std::mutex> lock(sink.mutex);
+        sink.in_flight = 0;
+        sink.stats.written += written;
+        sink.stats.last_lag = last_lag;
+        sink.stats.max_lag = std::max(sink.stats.max_lag, max_lag);
+        if (!sink.queue.empty()) {
+            // More arrived meanwhile: back of the line, so other sinks get a turn
+            schedule(index);
+        } else {
+            sink.scheduled = false;
+            sink.drained_cv.notify_all();
+        }
+    }
+}
+
+}  // namespace agora::log
@@ -0,0 +1,60 @@
+/**
+ * @file spill.cpp
+ * @brief Spill buffer implementation
+ */
+
+#include <agora/log/spill.hpp>
+
+namespace agora::log {
+
+bool SpillBuffer::push(Level level, std::string_view record) {
+    std::size_t own = index(level);
+
+    while (bytes_ + record.size() > capacity_) {
+        std::size_t lowest = own;
+        for (std::size_t i = 0; i < own; ++i) {
+            if (!levels_[i].empty()) {
+                lowest = i;
+                break;
+            }
+        }
+        if (lowest == own) {
+            ++shed_[own];  // Nothing less important left to displace
+            return false;
+        }
+        auto& victims = levels_[lowest];
+        bytes_ -= victims.front().record.size();
+        victims.pop_front();
+        --count_;
+        ++shed_[lowest];
+    }
+
+    levels_[own].push_back(Item{next_sequence_++, std::string(record)});
+    bytes_ += record.size();
+    ++count_;
+    return true;
+}
+
+std::size_t SpillBuffer::oldest_level() const noexcept {
+    std::size_t oldest = levels_.size();
+    for (std::size_t i = 0; i < levels_.size(); ++i) {
+        if (!levels_[i].empty() &&
+            (oldest == levels_.size() || levels_[i].front().sequence < levels_[oldest].front().sequence)) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+std::string_view SpillBuffer::front() const noexcept {
+    return levels_[oldest_level()].front().record;
+}
+
+void SpillBuffer::pop_front() noexcept {
+    auto& level = levels_[oldest_level()];
+    bytes_ -= level.front().record.size();
+    level.pop_front();
+    --count_;
+}
+
+}  // namespace agora::log
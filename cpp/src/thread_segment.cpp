@@ -0,0 +1,241 @@
+/**
+ * @file thread_segment.cpp
+ * @brief Per-thread segment reader and merge implementation
+ */
+
+#include <agora/log/thread_segment.hpp>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+namespace agora::log {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::string_view kMagic = "AGTS";
+
+// Upper bound on a single record, guards against corrupt size fields
+constexpr std::uint32_t kMaxRecordSize = 256u * 1024 * 1024;
+
+void put_le(std::string& out, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+std::uint64_t get_le(const char* data, std::size_t bytes) noexcept {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= std::uint64_t{static_cast<unsigned char>(data[i])} << (8 * i);
+    }
+    return value;
+}
+
+}  // anonymous namespace
+
+void append_thread_segment_preamble(std::string& out) {
+    out.append(kMagic);
+    out.push_back(static_cast<char>(kThreadSegmentVersion));
+    out.append(3, '\0');
+}
+
+void append_thread_segment_frame(std::string& out, std::int64_t timestamp_ns, std::uint32_t flags, std::string_view record) {
+    put_le(out, static_cast<std::uint64_t>(timestamp_ns), 8);
+    put_le(out, record.size(), 4);
+    put_le(out, flags, 4);
+    out.append(record);
+}
+
+fs::path thread_segment_path(const fs::path& base_path, std::size_t index) {
+    fs::path path = base_path;
+    path += ".t" + std::to_string(index);
+    return path;
+}
+
+std::optional<std::size_t> thread_segment_index(const fs::path& base_path, const fs::path& path) {
+    std::string prefix = base_path.filename().string() + ".t";
+    std::string name = path.filename().string();
+    if (name.size() <= prefix.size() || !name.starts_with(prefix)) {
+        return std::nullopt;
+    }
+    std::size_t index = 0;
+    const char* first = name.data() + prefix.size();
+    const char* last = name.data() + name.size();
+    auto [end, ec] = std::from_chars(first, last, index);
+    if (ec != std::errc{} || end != last) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+std::vector<fs::path> find_thread_segments(const fs::path& base_path) {
+    fs::path directory = base_path.has_parent_path() ? base_path.parent_path() : fs::path(".");
+
+    std::vector<std::pair<std::size_t, fs::path>> found;
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(directory, ec)) {
+        if (auto index = thread_segment_index(base_path, item.path()); index && item.is_regular_file(ec)) {
+            found.emplace_back(*index, item.path());
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<fs::path> segments;
+    segments.reserve(found.size());
+    for (auto& [index, path] : found) {
+        segments.push_back(std::move(path));
+    }
+    return segments;
+}
+
+// ThreadSegmentReader implementation
+
+std::expected<bool, Error> ThreadSegmentReader::next(SegmentFrame& frame) {
+    if (!started_) {
+        started_ = true;
+        char preamble[kThreadSegmentPreambleSize];
+        in_.read(preamble, sizeof(preamble));
+        if (in_.gcount() == 0) {
+            return false;  // Created, nothing written yet
+        }
+        if (in_.gcount() != sizeof(preamble) || std::string_view(preamble, kMagic.size()) != kMagic) {
+            return std::unexpected(Error{"not a thread segment (bad magic)"});
+        }
+        if (static_cast<std::uint8_t>(preamble[kMagic.size()]) != kThreadSegmentVersion) {
+            return std::unexpected(Error{"unsupported thread segment version"});
+        }
+    }
+
+    char head[kThreadSegmentFrameSize];
+    in_.read(head, sizeof(head));
+    if (in_.gcount() == 0) {
+        return false;
+    }
+    if (in_.gcount() != sizeof(head)) {
+        truncated_ = true;
+        return false;
+    }
+
+    auto size = static_cast<std::uint32_t>(get_le(head + 8, 4));
+    if (size > kMaxRecordSize) {
+        return std::unexpected(Error{"corrupt thread segment frame (size " + std::to_string(size) + ")"});
+    }
+    frame.timestamp_ns = static_cast<std::int64_t>(get_le(head, 8));
+    frame.header = (get_le(head + 12, 4) & kThreadSegmentHeaderFlag) != 0;
+    frame.record.resize(size);
+    in_.read(frame.record.data(), size);
+    if (static_cast<std::size_t>(in_.gcount()) != size) {
+        truncated_ = true;
+        return false;
+    }
+    return true;
+}
+
+// SegmentMerger implementation
+
+struct SegmentMerger::Input {
+    std::ifstream file;
+    ThreadSegmentReader reader{file};
+    SegmentFrame frame;
+};
+
+SegmentMerger::SegmentMerger(std::span<const fs::path> segments)
+    : paths_(segments.begin(), segments.end()) {
+}
+
+SegmentMerger::~SegmentMerger() noexcept = default;
+
+bool SegmentMerger::later(std::size_t a, std::size_t b) const noexcept {
+    std::int64_t ta = inputs_[a]->frame.timestamp_ns;
+    std::int64_t tb = inputs_[b]->frame.timestamp_ns;
+    return ta != tb ? ta > tb : a > b;
+}
+
+std::expected<bool, Error> SegmentMerger::advance(std::size_t index) {
+    Input& input = *inputs_[index];
+    auto result = input.reader.next(input.frame);
+    if (!result) {
+        return std::unexpected(Error{paths_[index].string() + ": " + result.error().message});
+    }
+    if (!*result) {
+        if (input.reader.truncated()) {
+            truncated_.push_back(paths_[index]);
+        }
+        input.file.close();
+        return false;
+    }
+    heap_.push_back(index);
+    std::push_heap(heap_.begin(), heap_.end(), [this](std::size_t a, std::size_t b) { return later(a, b); });
+    return true;
+}
+
+std::expected<bool, Error> SegmentMerger::next(SegmentFrame& frame) {
+    if (!started_) {
+        started_ = true;
+        inputs_.reserve(paths_.size());
+        heap_.reserve(paths_.size());
+        for (std::size_t i = 0; i < paths_.size(); ++i) {
+            auto input = std::make_unique<Input>();
+            input->file.open(paths_[i], std::ios::binary);
+            if (!input->file) {
+                return std::unexpected(Error{"cannot open " + paths_[i].string()});
+            }
+            inputs_.push_back(std::move(input));
+            if (auto result = advance(i); !result) {
+                return std::unexpected(result.error());
+            }
+        }
+    }
+
+    if (heap_.empty()) {
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), [this](std::size_t a, std::size_t b) { return later(a, b); });
+    std::size_t index = heap_.back();
+    heap_.pop_back();
+
+    // Hand out the pending frame, then refill that input's slot
+    std::swap(frame, inputs_[index]->frame);
+    if (auto result = advance(index); !result) {
+        return std::unexpected(result.error());
+    }
+    return true;
+}
+
+std::expected<MergeResult, Error> merge_thread_segments(std::span<const fs::path> segments, std::ostream& out) {
+    SegmentMerger merger(segments);
+    SegmentFrame frame;
+    MergeResult result;
+    bool header_written = false;
+
+    for (;;) {
+        auto more = merger.next(frame);
+        if (!more) {
+            return std::unexpected(more.error());
+        }
+        if (!*more) {
+            break;
+        }
+        if (frame.header) {
+            if (header_written) {
+                continue;
+            }
+            header_written = true;
+        } else {
+            ++result.records;
+        }
+        out.write(frame.record.data(), static_cast<std::streamsize>(frame.record.size()));
+    }
+
+    out.flush();
+    if (!out) {
+        return std::unexpected(Error{"write failed"});
+    }
+    result.truncated = merger.truncated();
+    return result;
+}
+
+}  // namespace agora::log
@@ -0,0 +1,124 @@
+/**
+ * @file timestamp.cpp
+ * @brief Cached timestamp rendering implementation
+ */
+
+#include <agora/log/timestamp.hpp>
+#include <agora/log/json_writer.hpp>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+
+namespace agora::log {
+
+namespace {
+
+using namespace std::chrono;
+
+/**
+ * @brief Per-thread cache of the rendered "YYYY-MM-DD?HH:MM:SS" prefix.
+ */
+struct SecondCache {
+    std::int64_t second = std::numeric_limits<std::int64_t>::min();
+    char text[19];
+};
+
+void put2(char* p, int value) noexcept {
+    p[0] = static_cast<char>('0' + value / 10);
+    p[1] = static_cast<char>('0' + value % 10);
+}
+
+void render_prefix(char* p, const std::tm& tm, char separator) noexcept {
+    int year = tm.tm_year + 1900;
+    p[0] = static_cast<char>('0' + (year / 1000) % 10);
+    p[1] = static_cast<char>('0' + (year / 100) % 10);
+    put2(p + 2, year % 100);
+    p[4] = '-';
+    put2(p + 5, tm.tm_mon + 1);
+    p[7] = '-';
+    put2(p + 8, tm.tm_mday);
+    p[10] = separator;
+    put2(p + 11, tm.tm_hour);
+    p[13] = ':';
+    put2(p + 14, tm.tm_min);
+    p[16] = ':';
+    put2(p + 17, tm.tm_sec);
+}
+
+/**
+ * @brief Split a time point into whole seconds and sub-second microseconds.
+ */
+std::int64_t split(system_clock::time_point tp, int& micros) noexcept {
+    auto secs = floor<seconds>(tp);
+    micros = static_cast<int>(duration_cast<microseconds>(tp - secs).count());
+    return secs.time_since_epoch().count();
+}
+
+void append_micros(std::string& out, int micros) {
+    char buf[7];
+    buf[0] = '.';
+    for (int i = 6; i >= 1; --i) {
+        buf[i] = static_cast<char>('0' + micros % 10);
+        micros /= 10;
+    }
+    out.append(buf, sizeof(buf));
+}
+
+}  // anonymous namespace
+
+void append_iso8601_utc(std::string& out, system_clock::time_point tp) {
+    thread_local SecondCache cache;
+
+    int micros = 0;
+    std::int64_t second = split(tp, micros);
+
+    if (second != cache.second) [[unlikely]] {
+        std::tm tm{};
+        auto time_t_val = static_cast<std::time_t>(second);
+        gmtime_r(&time_t_val, &tm);
+        render_prefix(cache.text, tm, 'T');
+        cache.second = second;
+    }
+
+    out.append(cache.text, sizeof(cache.text));
+    append_micros(out, micros);
+    out.push_back('Z');
+}
+
+void append_local_datetime(std::string& out, system_clock::time_point tp) {
+    thread_local SecondCache cache;
+
+    int micros = 0;
+    std::int64_t second = split(tp, micros);
+
+    if (second != cache.second) [[unlikely]] {
+        std::tm tm{};
+        auto time_t_val = static_cast<std::time_t>(second);
+        localtime_r(&time_t_val, &tm);
+        render_prefix(cache.text, tm, ' ');
+        cache.second = second;
+    }
+
+    out.append(cache.text, sizeof(cache.text));
+    append_micros(out, micros);
+}
+
+void append_timestamp(
+    std::string& out,
+    system_clock::time_point tp,
+    TimestampFormat format
+) {
+    switch (format) {
+        case TimestampFormat::Iso8601:
+            append_iso8601_utc(out, tp);
+            return;
+        case TimestampFormat::EpochMicros:
+            append_json_int(out, duration_cast<microseconds>(tp.time_since_epoch()).count());
+            return;
+        case TimestampFormat::EpochNanos:
+            append_json_int(out, duration_cast<nanoseconds>(tp.time_since_epoch()).count());
+            return;
+    }
+}
+
+}  // namespace agora::log
@@ -0,0 +1,231 @@
+/**
+ * @file test_binary.cpp
+ * @brief Binary log format tests
+ *
+ * Tests cover:
+ * - Encode/decode round trip reproduces format_json output exactly
+ * - Dictionary and call-site reuse across entries
+ * - Multiple sessions appended to one file
+ * - Truncated and corrupt input is reported, not crashed on
+ * - BinaryFileHandler via Config
+ * - BinaryFileHandler recovery after a failed write
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <agora/log/logger.hpp>
+#include <agora/log/config.hpp>
+#include <agora/log/binary.hpp>
+#include <agora/log/formatter.hpp>
+#include <agora/log/handlers/binary_file.hpp>
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <sys/resource.h>
+
+using namespace agora::log;
+namespace fs = std::filesystem;
+
+namespace {
+
+LogEntry make_entry(int i) {
+    LogEntry entry;
+    entry.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::nanoseconds(1'705'322'096'789'123'456 + i * 1'500'000)
+    );
+    entry.level = (i % 2) ? Level::Warning : Level::Info;
+    entry.message = "Order " + std::to_string(i) + " placed \"quoted\"";
+    entry.logger_name = "agora.orders";
+    entry.location = SourceLocation{"orders.cpp", static_cast<std::uint32_t>(40 + i % 3), "void place_order()"};
+    entry.service_name = "order-service";
+    entry.environment = "production";
+    entry.version = "1.2.3";
+    entry.context = {
+        {"order_id", std::int64_t{-1000 + i}},
+        {"symbol", std::string("AAPL")},
+        {"price", 187.42 + i},
+        {"short", i % 2 == 0}
+    };
+    if (i == 3) {
+        entry.exception = ExceptionInfo{"std::runtime_error", "broker down"};
+    }
+    if (i == 4) {
+        entry.duration_ms = 12.5;
+    }
+    return entry;
+}
+
+std::vector<std::string> decode_all_json(const std::string& bytes) {
+    std::istringstream in(bytes);
+    BinaryDecoder decoder(in);
+    std::vector<std::string> lines;
+    LogEntry entry;
+    while (true) {
+        auto result = decoder.next(entry);
+        REQUIRE(result.has_value());
+        if (!*result) break;
+        lines.push_back(format_json(entry));
+    }
+    return lines;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Binary round trip matches format_json", "[binary]") {
+    BinaryEncoder encoder;
+    std::string bytes;
+    std::vector<std::string> expected;
+
+    for (int i = 0; i < 10; ++i) {
+        auto entry = make_entry(i);
+        encoder.encode(entry, bytes);
+        expected.push_back(format_json(entry));
+    }
+
+    REQUIRE(decode_all_json(bytes) == expected);
+}
+
+TEST_CASE("Binary round trip preserves timestamps going backwards", "[binary]") {
+    BinaryEncoder encoder;
+    std::string bytes;
+    auto a = make_entry(5);
+    auto b = make_entry(0);  // earlier timestamp: negative delta
+    encoder.encode(a, bytes);
+    encoder.encode(b, bytes);
+
+    auto lines = decode_all_json(bytes);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[1] == format_json(b));
+}
+
+TEST_CASE("Binary records are much smaller than JSON", "[binary]") {
+    BinaryEncoder encoder;
+    std::string bytes;
+    std::size_t json_bytes = 0;
+
+    for (int i = 0; i < 1000; ++i) {
+        auto entry = make_entry(i);
+        encoder.encode(entry, bytes);
+        json_bytes += format_json(entry).size() + 1;
+    }
+
+    // Dictionaries amortize away; only message and context values remain
+    REQUIRE(bytes.size() * 3 < json_bytes);
+}
+
+TEST_CASE("Binary decoder handles appended sessions", "[binary]") {
+    std::string bytes;
+    {
+        BinaryEncoder first;
+        first.encode(make_entry(1), bytes);
+    }
+    {
+        BinaryEncoder second;  // New process appending to the same file
+        second.encode(make_entry(2), bytes);
+    }
+
+    auto lines = decode_all_json(bytes);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0] == format_json(make_entry(1)));
+    REQUIRE(lines[1] == format_json(make_entry(2)));
+}
+
+TEST_CASE("Binary decoder reports truncated input", "[binary]") {
+    BinaryEncoder encoder;
+    std::string bytes;
+    encoder.encode(make_entry(1), bytes);
+    encoder.encode(make_entry(2), bytes);
+    bytes.resize(bytes.size() - 5);
+
+    std::istringstream in(bytes);
+    BinaryDecoder decoder(in);
+    LogEntry entry;
+
+    auto first = decoder.next(entry);
+    REQUIRE(first.has_value());
+    REQUIRE(*first);
+
+    auto second = decoder.next(entry);
+    REQUIRE_FALSE(second.has_value());
+}
+
+TEST_CASE("Binary decoder rejects non-binary input", "[binary]") {
+    std::istringstream in("{\"message\":\"json\"}\n");
+    BinaryDecoder decoder(in);
+    LogEntry entry;
+    REQUIRE_FALSE(decoder.next(entry).has_value());
+}
+
+TEST_CASE("Binary file handler via Config", "[binary][handler]") {
+    auto dir = fs::temp_directory_path() / "agora_binary_tests";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    auto config = Config{};
+    config.service_name = "test";
+    config.console_enabled = false;
+    config.file_path = dir / "app.log";
+    config.binary_file_enabled = true;
+    config.binary_file_path = dir / "app.binlog";
+
+    REQUIRE(initialize(config).has_value());
+    auto logger = get_logger("test.binary");
+    logger.info("first", {{"k", std::int64_t{1}}});
+    logger.warning("second");
+    shutdown();
+
+    // JSON written by the file handler and decoded binary must agree
+    std::ifstream json_file(config.file_path);
+    std::vector<std::string> json_lines;
+    for (std::string line; std::getline(json_file, line);) {
+        json_lines.push_back(line);
+    }
+
+    std::ifstream bin_file(config.binary_file_path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(bin_file)), std::istreambuf_iterator<char>());
+
+    REQUIRE(decode_all_json(bytes) == json_lines);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Binary file handler starts a new session after a failed write", "[binary][handler]") {
+    auto dir = fs::temp_directory_path() / "agora_binary_tests";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto path = dir / "failed.binlog";
+
+    {
+        BinaryFileHandler handler(path);
+        handler.write(make_entry(0));
+        handler.flush();
+
+        // The disk is full: the write fails (EFBIG, SIGXFSZ ignored)
+        auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous{};
+        ::getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = fs::file_size(path);
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        LogEntry large = make_entry(1);
+        large.message = std::string(64 * 1024, 'x');
+        REQUIRE_THROWS_AS(handler.write(large), std::system_error);
+        ::setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, previous_handler);
+
+        // Later records reach the file again, decodable with fresh dictionaries
+        handler.write(make_entry(2));
+        handler.write(make_entry(3));
+    }
+
+    std::ifstream bin_file(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(bin_file)), std::istreambuf_iterator<char>());
+    REQUIRE(decode_all_json(bytes) == std::vector<std::string>{
+        format_json(make_entry(0)), format_json(make_entry(2)), format_json(make_entry(3))});
+
+    fs::remove_all(dir);
+}
@@ -6,6 +6,8 @@
  * - Config from environment variables
  * - Default values
  * - Level parsing
+ * - Timestamp format
+ * - Handler levels and routing rules
  */
 
 #include <catch2/catch_test_macros.hpp>
@@ -147,3 +149,165 @@ TEST_CASE("Max backup count configuration", "[config][backups]") {
 
     unsetenv("AGORA_LOG_MAX_BACKUP_COUNT");
 }
+
+TEST_CASE("Timestamp format configuration", "[config][timestamp]") {
+    SECTION("Default is ISO 8601") {
+        unsetenv("AGORA_LOG_TIMESTAMP_FORMAT");
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->timestamp_format == TimestampFormat::Iso8601);
+    }
+
+    SECTION("Epoch nanoseconds") {
+        setenv("AGORA_LOG_TIMESTAMP_FORMAT", "epoch_ns", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->timestamp_format == TimestampFormat::EpochNanos);
+        unsetenv("AGORA_LOG_TIMESTAMP_FORMAT");
+    }
+}
+
+TEST_CASE("File format configuration", "[config][cbor]") {
+    SECTION("Default is JSON") {
+        unsetenv("AGORA_LOG_FILE_FORMAT");
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_format == FileFormat::Json);
+    }
+
+    SECTION("CBOR") {
+        setenv("AGORA_LOG_FILE_FORMAT", "cbor", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_format == FileFormat::Cbor);
+        unsetenv("AGORA_LOG_FILE_FORMAT");
+    }
+}
+
+TEST_CASE("Rotation interval configuration", "[config][rotation]") {
+    SECTION("Default is size only") {
+        unsetenv("AGORA_LOG_FILE_ROTATION_INTERVAL");
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_rotation_interval == RotationInterval::None);
+    }
+
+    SECTION("Hourly") {
+        setenv("AGORA_LOG_FILE_ROTATION_INTERVAL", "hourly", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_rotation_interval == RotationInterval::Hourly);
+        unsetenv("AGORA_LOG_FILE_ROTATION_INTERVAL");
+    }
+
+    SECTION("Sequence naming") {
+        REQUIRE(Config::from_env("test")->file_backup_naming == BackupNaming::Cascade);
+        setenv("AGORA_LOG_FILE_BACKUP_NAMING", "sequence", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_backup_naming == BackupNaming::Sequence);
+        unsetenv("AGORA_LOG_FILE_BACKUP_NAMING");
+    }
+}
+
+TEST_CASE("Output profile configuration", "[config][profile]") {
+    SECTION("Default is full") {
+        unsetenv("AGORA_LOG_OUTPUT_PROFILE");
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->output_profile == OutputProfile::Full);
+    }
+
+    SECTION("Compact") {
+        setenv("AGORA_LOG_OUTPUT_PROFILE", "compact", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->output_profile == OutputProfile::Compact);
+        unsetenv("AGORA_LOG_OUTPUT_PROFILE");
+    }
+}
+
+TEST_CASE("Buffered console configuration", "[config][buffered]") {
+    unsetenv("AGORA_LOG_CONSOLE_BUFFERED");
+    REQUIRE_FALSE(Config::from_env("test")->console_buffered);
+
+    setenv("AGORA_LOG_CONSOLE_BUFFERED", "true", 1);
+    setenv("AGORA_LOG_CONSOLE_DROP_WHEN_FULL", "true", 1);
+    auto result = Config::from_env("test");
+    REQUIRE(result.has_value());
+    REQUIRE(result->console_buffered);
+    REQUIRE(result->console_drop_when_full);
+    unsetenv("AGORA_LOG_CONSOLE_BUFFERED");
+    unsetenv("AGORA_LOG_CONSOLE_DROP_WHEN_FULL");
+}
+
+TEST_CASE("Buffered file configuration", "[config][buffered]") {
+    SECTION("Default is unbuffered") {
+        unsetenv("AGORA_LOG_FILE_BUFFERED");
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE_FALSE(result->file_buffered);
+    }
+
+    SECTION("Enabled with buffer size") {
+        setenv("AGORA_LOG_FILE_BUFFERED", "true", 1);
+        setenv("AGORA_LOG_FILE_BUFFER_SIZE", "1048576", 1);
+        auto result = Config::from_env("test");
+        REQUIRE(result.has_value());
+        REQUIRE(result->file_buffered);
+        REQUIRE(result->file_buffer_size == 1024 * 1024);
+        unsetenv("AGORA_LOG_FILE_BUFFERED");
+        unsetenv("AGORA_LOG_FILE_BUFFER_SIZE");
+    }
+}
+
+TEST_CASE("Disk degradation configuration", "[config][spill]") {
+    setenv("AGORA_LOG_FILE_SPILL_BYTES", "65536", 1);
+    setenv("AGORA_LOG_FILE_SLOW_WRITE_MS", "0", 1);
+    setenv("AGORA_LOG_FILE_RETRY_MAX_MS", "5000", 1);
+    auto result = Config::from_env("test");
+    REQUIRE(result.has_value());
+    REQUIRE(result->file_spill_bytes == 65536);
+    REQUIRE(result->file_slow_write_ms == 0);
+    REQUIRE(result->file_retry_initial_ms == 100);
+    REQUIRE(result->file_retry_max_ms == 5000);
+    unsetenv("AGORA_LOG_FILE_SPILL_BYTES");
+    unsetenv("AGORA_LOG_FILE_SLOW_WRITE_MS");
+    unsetenv("AGORA_LOG_FILE_RETRY_MAX_MS");
+}
+
+TEST_CASE("Backup retention configuration", "[config][retention]") {
+    setenv("AGORA_LOG_FILE_RETENTION_MAX_MB", "512", 1);
+    setenv("AGORA_LOG_FILE_RETENTION_MAX_AGE_S", "604800", 1);
+    auto result = Config::from_env("test");
+    REQUIRE(result.has_value());
+    REQUIRE(result->file_retention_max_mb == 512.0);
+    REQUIRE(result->file_retention_max_age_s == 604800);
+    REQUIRE(result->file_retention_rescan_s == 300);
+    unsetenv("AGORA_LOG_FILE_RETENTION_MAX_MB");
+    unsetenv("AGORA_LOG_FILE_RETENTION_MAX_AGE_S");
+}
+
+TEST_CASE("Routing configuration", "[config][routing]") {
+    setenv("AGORA_LOG_CONSOLE_LEVEL", "WARNING", 1);
+    setenv("AGORA_LOG_ROUTES",
+        "agora.audit:file=/var/log/agora/audit.log; agora.marketdata:level=INFO;"
+        "agora.risk:level=DEBUG,handlers=console+file;agora.bad:level=LOUD", 1);
+
+    auto config = *Config::from_env("test-service");
+    REQUIRE(config.console_level == Level::Warning);
+    REQUIRE(config.file_level == Level::Debug);
+    REQUIRE(config.routes.size() == 4);
+    REQUIRE(config.routes[0].prefix == "agora.audit");
+    REQUIRE(config.routes[0].file == "/var/log/agora/audit.log");
+    REQUIRE(config.routes[1].level == Level::Info);
+    REQUIRE(config.routes[2].handlers == std::vector<std::string>{"console", "file"});
+    REQUIRE_FALSE(config.routes[3].level.has_value());
+
+    REQUIRE(find_route(config.routes, "agora.audit.trades") == &config.routes[0]);
+    REQUIRE(find_route(config.routes, "agora.auditor") == nullptr);
+    REQUIRE(find_route(config.routes, "agora.marketdata") == &config.routes[1]);
+
+    unsetenv("AGORA_LOG_CONSOLE_LEVEL");
+    unsetenv("AGORA_LOG_ROUTES");
+}
@@ -8,17 +8,31 @@
  * - Context serialization
  * - Exception formatting
  * - Duration formatting
+ * - Golden equivalence of the streaming writer with the nlohmann::json DOM output
+ * - Cached timestamp rendering and epoch timestamp formats
+ * - Compiled pattern layouts for text output
  */
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <agora/log/logger.hpp>
 #include <agora/log/config.hpp>
+#include <agora/log/entry.hpp>
+#include <agora/log/formatter.hpp>
+#include <agora/log/batch.hpp>
+#include <agora/log/json_writer.hpp>
+#include <agora/log/cbor_writer.hpp>
+#include <agora/log/pattern.hpp>
+#include <agora/log/timestamp.hpp>
 
 #include <filesystem>
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 #include <nlohmann/json.hpp>
 
 using namespace agora::log;
@@ -256,3 +270,645 @@ TEST_CASE("JSON formatter - special characters escaping", "[formatter][escaping]
 
     fixture.TearDown();
 }
+
+// ============================================================================
+// Golden tests: streaming JSON writer vs. nlohmann::json DOM
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Reference implementation: the original DOM-based format_json.
+ */
+std::string reference_format_json(const LogEntry& entry) {
+    auto time_t_val = std::chrono::system_clock::to_time_t(entry.timestamp);
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        entry.timestamp.time_since_epoch()
+    ) % 1'000'000;
+    std::tm tm{};
+    gmtime_r(&time_t_val, &tm);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    oss << '.' << std::setfill('0') << std::setw(6) << microseconds.count() << 'Z';
+
+    json j;
+    j["timestamp"] = oss.str();
+    j["level"] = to_string(entry.level);
+    j["message"] = entry.message;
+    j["service"] = entry.service_name;
+    j["environment"] = entry.environment;
+    j["version"] = entry.version;
+    j["logger_name"] = entry.logger_name;
+    j["file"] = entry.location.file;
+    j["line"] = entry.location.line;
+    j["function"] = entry.location.function;
+    if (!entry.context.empty()) {
+        json context_obj;
+        for (const auto& [key, value] : entry.context) {
+            context_obj[key] = std::visit([](const auto& v) -> json { return v; }, value);
+        }
+        j["context"] = context_obj;
+    }
+    if (entry.exception) {
+        j["exception"] = {
+            {"type", entry.exception->type},
+            {"message", entry.exception->message}
+        };
+    }
+    if (entry.duration_ms) {
+        j["duration_ms"] = *entry.duration_ms;
+    }
+    return j.dump();
+}
+
+LogEntry make_golden_entry() {
+    LogEntry entry;
+    entry.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::microseconds(1'705'322'096'789'123)
+    );
+    entry.level = Level::Info;
+    entry.message = "Order placed";
+    entry.logger_name = "agora.orders";
+    entry.location = SourceLocation{"orders.cpp", 42, "void place_order(const Order&)"};
+    entry.service_name = "order-service";
+    entry.environment = "production";
+    entry.version = "1.2.3";
+    return entry;
+}
+
+std::string dump_double(double value) {
+    std::string out;
+    append_json_double(out, value);
+    return out;
+}
+
+std::string dump_string(std::string_view value) {
+    std::string out;
+    append_json_string(out, value);
+    return out;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("JSON golden - minimal entry", "[formatter][golden]") {
+    auto entry = make_golden_entry();
+    REQUIRE(format_json(entry) == reference_format_json(entry));
+}
+
+TEST_CASE("JSON golden - all optional fields", "[formatter][golden]") {
+    auto entry = make_golden_entry();
+    entry.level = Level::Error;
+    entry.context = {
+        {"zeta", std::string("last")},
+        {"alpha", std::int64_t{-9'223'372'036'854'775'807 - 1}},
+        {"price", 101.25},
+        {"filled", false},
+        {"qty", std::int64_t{1'000'000}},
+        {"Upper", std::string("sorted before lowercase")},
+        {"", std::string("empty key")}
+    };
+    entry.exception = ExceptionInfo{"std::runtime_error", "broker \"X\" unavailable\n"};
+    entry.duration_ms = 12.345;
+
+    REQUIRE(format_json(entry) == reference_format_json(entry));
+}
+
+TEST_CASE("JSON golden - every level", "[formatter][golden]") {
+    auto entry = make_golden_entry();
+    for (auto level : {Level::Debug, Level::Info, Level::Warning, Level::Error, Level::Critical}) {
+        entry.level = level;
+        REQUIRE(format_json(entry) == reference_format_json(entry));
+    }
+}
+
+TEST_CASE("JSON golden - append overload reuses buffer", "[formatter][golden]") {
+    auto entry = make_golden_entry();
+    std::string buffer = "prefix:";
+    format_json(entry, buffer);
+    REQUIRE(buffer == "prefix:" + reference_format_json(entry));
+}
+
+TEST_CASE("JSON golden - string escaping of all ASCII bytes", "[formatter][golden]") {
+    for (int c = 0; c < 0x80; ++c) {
+        std::string s = "a";
+        s.push_back(static_cast<char>(c));
+        s += "b";
+        INFO("byte " << c);
+        REQUIRE(dump_string(s) == json(s).dump());
+    }
+}
+
+TEST_CASE("JSON golden - long strings cross SIMD block boundaries", "[formatter][golden]") {
+    std::string s;
+    for (int i = 0; i < 200; ++i) {
+        s += (i % 17 == 0) ? '"' : (i % 23 == 0) ? '\\' : (i % 31 == 0) ? '\n' : 'x';
+        if (i % 41 == 0) {
+            s += "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";  // é € 😀
+        }
+    }
+    REQUIRE(dump_string(s) == json(s).dump());
+
+    auto entry = make_golden_entry();
+    entry.message = s;
+    entry.context = {{"payload", s}};
+    REQUIRE(format_json(entry) == reference_format_json(entry));
+}
+
+TEST_CASE("JSON golden - UTF-8 passthrough", "[formatter][golden]") {
+    for (std::string s : {
+        "caf\xC3\xA9",
+        "\xE4\xB8\xAD\xE6\x96\x87",
+        "\xF0\x9F\x9A\x80 launch",
+        "\x7F delete",
+        "\xEF\xBB\xBF bom"
+    }) {
+        REQUIRE(dump_string(s) == json(s).dump());
+    }
+}
+
+TEST_CASE("JSON writer - invalid UTF-8 is replaced", "[formatter][golden]") {
+    // nlohmann::json throws here (and the entry was dropped); the writer
+    // substitutes U+FFFD so the line is still emitted.
+    REQUIRE(dump_string("a\xFF" "b") == "\"a\xEF\xBF\xBD" "b\"");
+    REQUIRE(dump_string("\xC3") == "\"\xEF\xBF\xBD\"");
+    REQUIRE(dump_string("\xED\xA0\x80") == "\"\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD\"");  // surrogate
+}
+
+TEST_CASE("JSON golden - doubles", "[formatter][golden]") {
+    for (double d : {
+        0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 3.14, 101.25, 12.345, 1e15, 1e16, 123456789012345.0,
+        1234567890123456.0, 1e-4, 1e-5, 0.00012345, 0.0012345, 1.5e-7, 1e20, 1e100, 1e-100,
+        1.7976931348623157e308, std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::epsilon(),
+        1.0 / 3.0, 2.0 / 3.0, 100.0, 4.35, 0.3, 9007199254740993.0
+    }) {
+        INFO("value " << d);
+        REQUIRE(dump_double(d) == json(d).dump());
+    }
+
+    REQUIRE(dump_double(std::numeric_limits<double>::quiet_NaN()) == "null");
+    REQUIRE(dump_double(std::numeric_limits<double>::infinity()) == "null");
+}
+
+TEST_CASE("JSON golden - integers", "[formatter][golden]") {
+    for (std::int64_t v : {
+        std::int64_t{0}, std::int64_t{-1}, std::int64_t{42},
+        std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()
+    }) {
+        std::string out;
+        append_json_int(out, v);
+        REQUIRE(out == json(v).dump());
+    }
+}
+
+// ============================================================================
+// Timestamp rendering
+// ============================================================================
+
+namespace {
+
+std::string reference_strftime(std::chrono::system_clock::time_point tp, bool utc, const char* fmt) {
+    auto secs = std::chrono::floor<std::chrono::seconds>(tp);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(tp - secs).count();
+    auto time_t_val = std::chrono::system_clock::to_time_t(secs);
+    std::tm tm{};
+    if (utc) {
+        gmtime_r(&time_t_val, &tm);
+    } else {
+        localtime_r(&time_t_val, &tm);
+    }
+    std::ostringstream oss;
+    oss << std::put_time(&tm, fmt) << '.' << std::setfill('0') << std::setw(6) << micros;
+    return oss.str();
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Timestamp - cached ISO 8601 matches strftime", "[formatter][timestamp]") {
+    using namespace std::chrono;
+    auto base = system_clock::time_point(microseconds(1'705'322'096'000'000));
+
+    // Walk across several second, minute, day and year boundaries
+    for (auto offset : {
+        microseconds(0), microseconds(1), microseconds(999'999), microseconds(1'000'000),
+        microseconds(59'999'999), microseconds(86'400'000'000), microseconds(1),
+        microseconds(30'000'000'000'000), microseconds(0)
+    }) {
+        auto tp = base + offset;
+        std::string out;
+        append_iso8601_utc(out, tp);
+        REQUIRE(out == reference_strftime(tp, true, "%Y-%m-%dT%H:%M:%S") + "Z");
+    }
+}
+
+TEST_CASE("Timestamp - cached local time matches localtime_r", "[formatter][timestamp]") {
+    using namespace std::chrono;
+    auto base = system_clock::time_point(microseconds(1'705'322'096'123'456));
+
+    for (auto offset : {seconds(0), seconds(0), seconds(1), seconds(3600), seconds(86400 * 180)}) {
+        auto tp = base + offset;
+        std::string out;
+        append_local_datetime(out, tp);
+        REQUIRE(out == reference_strftime(tp, false, "%Y-%m-%d %H:%M:%S"));
+    }
+}
+
+TEST_CASE("Timestamp - pre-epoch sub-second digits", "[formatter][timestamp]") {
+    using namespace std::chrono;
+    auto tp = system_clock::time_point(microseconds(-1));
+    std::string out;
+    append_iso8601_utc(out, tp);
+    REQUIRE(out == "1969-12-31T23:59:59.999999Z");
+}
+
+TEST_CASE("Timestamp - epoch integer formats", "[formatter][timestamp]") {
+    using namespace std::chrono;
+    auto tp = system_clock::time_point(duration_cast<system_clock::duration>(
+        nanoseconds(1'705'322'096'789'123'456)
+    ));
+
+    std::string out;
+    append_timestamp(out, tp, TimestampFormat::EpochMicros);
+    REQUIRE(out == "1705322096789123");
+
+    out.clear();
+    append_timestamp(out, tp, TimestampFormat::EpochNanos);
+    REQUIRE(out == std::to_string(duration_cast<nanoseconds>(tp.time_since_epoch()).count()));
+
+    auto entry = make_golden_entry();
+    entry.timestamp = tp;
+    auto parsed = json::parse(format_json(entry, FormatOptions{TimestampFormat::EpochMicros}));
+    REQUIRE(parsed["timestamp"].is_number_integer());
+    REQUIRE(parsed["timestamp"] == 1'705'322'096'789'123);
+}
+
+TEST_CASE("Timestamp format parsing", "[formatter][timestamp]") {
+    REQUIRE(from_string("iso8601", TimestampFormat::EpochNanos) == TimestampFormat::Iso8601);
+    REQUIRE(from_string("epoch_us", TimestampFormat::Iso8601) == TimestampFormat::EpochMicros);
+    REQUIRE(from_string("epoch_ns", TimestampFormat::Iso8601) == TimestampFormat::EpochNanos);
+    REQUIRE(from_string("bogus", TimestampFormat::Iso8601) == TimestampFormat::Iso8601);
+    REQUIRE(to_string(TimestampFormat::EpochNanos) == "epoch_ns");
+}
+
+// ============================================================================
+// Pattern layouts
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Reference implementation: the original ostringstream format_text.
+ */
+std::string reference_format_text(const LogEntry& entry) {
+    std::ostringstream oss;
+    oss << '[' << reference_strftime(entry.timestamp, false, "%Y-%m-%d %H:%M:%S") << "] ";
+    oss << '[' << to_string(entry.level) << "] ";
+    oss << '[' << entry.service_name << "] ";
+    oss << entry.message;
+    if (!entry.context.empty()) {
+        oss << " (";
+        bool first = true;
+        for (const auto& [key, value] : entry.context) {
+            if (!first) oss << ", ";
+            first = false;
+            oss << key << '=';
+            std::visit([&oss](const auto& v) {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, bool>) {
+                    oss << (v ? "true" : "false");
+                } else {
+                    oss << v;
+                }
+            }, value);
+        }
+        oss << ')';
+    }
+    if (entry.duration_ms) {
+        oss << " [" << *entry.duration_ms << "ms]";
+    }
+    if (entry.exception) {
+        oss << " [" << entry.exception->type << ": " << entry.exception->message << "]";
+    }
+    return oss.str();
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Pattern layout - default pattern matches classic text format", "[formatter][pattern]") {
+    auto entry = make_golden_entry();
+    REQUIRE(format_text(entry) == reference_format_text(entry));
+
+    entry.context = {
+        {"symbol", std::string("AAPL")},
+        {"qty", std::int64_t{-150}},
+        {"price", 187.42},
+        {"big", 1234567.0},
+        {"tiny", 0.000012345},
+        {"short", true}
+    };
+    entry.duration_ms = 12.3456789;
+    entry.exception = ExceptionInfo{"std::runtime_error", "boom"};
+    REQUIRE(format_text(entry) == reference_format_text(entry));
+}
+
+TEST_CASE("Pattern layout - all specifiers", "[formatter][pattern]") {
+    auto entry = make_golden_entry();
+    entry.context = {{"k", std::string("v")}};
+    entry.duration_ms = 1.5;
+
+    PatternLayout layout("%T|%l|%n|%S|%e|%v|%s:%#|%f|%m|%C|%D|%E|100%%|%q");
+    std::string out;
+    layout.format(entry, out);
+
+    REQUIRE(out ==
+        "2024-01-15T12:34:56.789123Z|INFO|agora.orders|order-service|production|1.2.3|"
+        "orders.cpp:42|void place_order(const Order&)|Order placed| (k=v)| [1.5ms]||100%|%q");
+}
+
+TEST_CASE("Pattern layout - optional fields vanish", "[formatter][pattern]") {
+    auto entry = make_golden_entry();
+    PatternLayout layout("[%l] %m%C%D%E");
+    std::string out;
+    layout.format(entry, out);
+    REQUIRE(out == "[INFO] Order placed");
+}
+
+TEST_CASE("Pattern layout - appends and honors timestamp format", "[formatter][pattern]") {
+    auto entry = make_golden_entry();
+    PatternLayout layout("%T %m");
+
+    std::string out = ">";
+    layout.format(entry, out, FormatOptions{TimestampFormat::EpochMicros});
+    REQUIRE(out == ">1705322096789123 Order placed");
+    REQUIRE(layout.pattern() == "%T %m");
+}
+
+TEST_CASE("Pattern layout - trailing percent is literal", "[formatter][pattern]") {
+    auto entry = make_golden_entry();
+    PatternLayout layout("%m %");
+    std::string out;
+    layout.format(entry, out);
+    REQUIRE(out == "Order placed %");
+}
+
+// ============================================================================
+// CBOR formatter
+// ============================================================================
+
+namespace {
+
+json decode_cbor(const std::string& bytes) {
+    return json::from_cbor(bytes);
+}
+
+std::string cbor_head(CborMajor major, std::uint64_t value) {
+    std::string out;
+    append_cbor_head(out, major, value);
+    return out;
+}
+
+std::string cbor_int(std::int64_t value) {
+    std::string out;
+    append_cbor_int(out, value);
+    return out;
+}
+
+std::string cbor_double(double value) {
+    std::string out;
+    append_cbor_double(out, value);
+    return out;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("CBOR formatter - same document as JSON", "[formatter][cbor]") {
+    auto entry = make_golden_entry();
+    REQUIRE(decode_cbor(format_cbor(entry)) == json::parse(format_json(entry)));
+
+    entry.context = {
+        {"symbol", std::string("AAPL")},
+        {"min", std::int64_t{-9'223'372'036'854'775'807 - 1}},
+        {"qty", std::int64_t{1'000'000}},
+        {"price", 101.25},
+        {"ratio", 0.1},
+        {"filled", false}
+    };
+    entry.exception = ExceptionInfo{"std::runtime_error", "broker \"X\" unavailable\n"};
+    entry.duration_ms = 12.345;
+    REQUIRE(decode_cbor(format_cbor(entry)) == json::parse(format_json(entry)));
+
+    FormatOptions epoch{TimestampFormat::EpochNanos};
+    REQUIRE(decode_cbor(format_cbor(entry, epoch)) == json::parse(format_json(entry, epoch)));
+}
+
+TEST_CASE("CBOR formatter - timestamp is a text string", "[formatter][cbor]") {
+    auto entry = make_golden_entry();
+    auto bytes = format_cbor(entry);
+    REQUIRE(bytes.find("\x69" "timestamp" "\x78\x1B" "2024-01-15T12:34:56.789123Z") != std::string::npos);
+}
+
+TEST_CASE("CBOR formatter - smaller than JSON", "[formatter][cbor]") {
+    auto entry = make_golden_entry();
+    entry.context = {{"qty", std::int64_t{1500}}, {"price", 187.42}, {"short", true}};
+    REQUIRE(format_cbor(entry).size() < format_json(entry).size());
+}
+
+TEST_CASE("CBOR formatter - length-delimited records", "[formatter][cbor]") {
+    auto entry = make_golden_entry();
+    CborFormatter formatter;
+
+    std::string out = "x";
+    formatter.format(entry, out);
+    formatter.format(entry, out);
+
+    auto payload = format_cbor(entry);
+    std::string prefix{
+        static_cast<char>(payload.size() >> 24), static_cast<char>(payload.size() >> 16),
+        static_cast<char>(payload.size() >> 8), static_cast<char>(payload.size())
+    };
+    REQUIRE(out == "x" + prefix + payload + prefix + payload);
+}
+
+TEST_CASE("CBOR writer - shortest heads", "[formatter][cbor]") {
+    REQUIRE(cbor_head(CborMajor::Unsigned, 23) == "\x17");
+    REQUIRE(cbor_head(CborMajor::Unsigned, 24) == std::string("\x18\x18"));
+    REQUIRE(cbor_head(CborMajor::Unsigned, 255) == std::string("\x18\xFF"));
+    REQUIRE(cbor_head(CborMajor::Unsigned, 256) == std::string("\x19\x01\x00", 3));
+    REQUIRE(cbor_head(CborMajor::Unsigned, 65536) == std::string("\x1A\x00\x01\x00\x00", 5));
+    REQUIRE(cbor_head(CborMajor::Unsigned, 1ULL << 32) == std::string("\x1B\x00\x00\x00\x01\x00\x00\x00\x00", 9));
+    REQUIRE(cbor_head(CborMajor::Text, 3) == "\x63");
+
+    REQUIRE(cbor_int(-1) == "\x20");
+    REQUIRE(cbor_int(-25) == std::string("\x38\x18"));
+    REQUIRE(cbor_int(std::numeric_limits<std::int64_t>::min()) ==
+            std::string("\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF"));
+}
+
+TEST_CASE("CBOR writer - floats use the narrowest exact width", "[formatter][cbor]") {
+    REQUIRE(cbor_double(1.5) == std::string("\xFA\x3F\xC0\x00\x00", 5));
+    REQUIRE(cbor_double(0.1) == std::string("\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 9));
+    REQUIRE(cbor_double(1e300).size() == 9);
+    REQUIRE(cbor_double(std::numeric_limits<double>::infinity()) ==
+            std::string("\xFA\x7F\x80\x00\x00", 5));
+}
+
+TEST_CASE("CBOR writer - invalid UTF-8 is replaced", "[formatter][cbor]") {
+    std::string out;
+    append_cbor_text(out, "a\xFF" "b");
+    REQUIRE(out == "\x65" "a\xEF\xBF\xBD" "b");
+}
+
+// ============================================================================
+// Output profiles
+// ============================================================================
+
+TEST_CASE("Unqualified function names", "[formatter][profile]") {
+    auto trim = [](std::string_view pretty) {
+        return SourceLocation{"f.cpp", 1, pretty}.unqualified_function();
+    };
+
+    REQUIRE(trim("void place_order(const Order&)") == "place_order");
+    REQUIRE(trim("void agora::OrderRouter::route(const Order&) const") == "route");
+    REQUIRE(trim("std::vector<std::pair<int, int> > ns::build(int)") == "build");
+    REQUIRE(trim("void ns::C<T>::go(T) const [with T = std::map<int, int>]") == "go");
+    REQUIRE(trim("int ns::f<int>(void (*)(int))") == "f");
+    REQUIRE(trim("bool ns::C<T>::operator()(int) const [with T = int]") == "operator()");
+    REQUIRE(trim("bool ns::Id::operator<(const ns::Id&) const") == "operator<");
+    REQUIRE(trim("ns::Id::operator bool() const") == "operator bool");
+    REQUIRE(trim("ns::Id::~Id()") == "~Id");
+    REQUIRE(trim("void __cdecl ns::run(void)") == "run");
+    REQUIRE(trim("int main()") == "main");
+    REQUIRE(trim("not a signature") == "not a signature");
+    REQUIRE(trim("") == "");
+
+    static_assert(SourceLocation{"f.cpp", 1, "void a::b(int)"}.unqualified_function() == "b");
+}
+
+TEST_CASE("Output profile - full is the default record", "[formatter][profile]") {
+    auto entry = make_golden_entry();
+    REQUIRE(format_json(entry, make_format_options(OutputProfile::Full)) == format_json(entry));
+}
+
+TEST_CASE("Output profile - compact", "[formatter][profile]") {
+    auto entry = make_golden_entry();
+    entry.context = {{"qty", std::int64_t{5}}};
+    entry.duration_ms = 1.5;
+    entry.exception = ExceptionInfo{"E", "boom"};
+
+    auto options = make_format_options(OutputProfile::Compact);
+    REQUIRE(format_json(entry, options) ==
+        R"({"ctx":{"qty":5},"dur_ms":1.5,"exc":{"msg":"boom","type":"E"},"file":"orders.cpp",)"
+        R"("fn":"place_order","lvl":"INFO","line":42,"logger":"agora.orders","msg":"Order placed",)"
+        R"("ts":"2024-01-15T12:34:56.789123Z"})");
+
+    std::string header;
+    format_json_header(entry, header, options);
+    REQUIRE(header == R"({"log_header":{"env":"production","svc":"order-service","ver":"1.2.3"}})");
+
+    REQUIRE(format_json(entry, options).size() < format_json(entry).size() * 3 / 4);
+}
+
+TEST_CASE("Output profile - minimal", "[formatter][profile]") {
+    auto entry = make_golden_entry();
+    auto options = make_format_options(OutputProfile::Minimal, TimestampFormat::EpochMicros);
+    REQUIRE(format_json(entry, options) ==
+        R"({"file":"orders.cpp","lvl":"INFO","line":42,"msg":"Order placed","ts":1705322096789123})");
+}
+
+TEST_CASE("Output profile - CBOR matches JSON", "[formatter][profile][cbor]") {
+    auto entry = make_golden_entry();
+    entry.context = {{"qty", std::int64_t{5}}};
+    entry.exception = ExceptionInfo{"E", "boom"};
+
+    for (auto profile : {OutputProfile::Compact, OutputProfile::Minimal}) {
+        auto options = make_format_options(profile);
+        REQUIRE(decode_cbor(format_cbor(entry, options)) == json::parse(format_json(entry, options)));
+
+        std::string json_header, cbor_header;
+        format_json_header(entry, json_header, options);
+        format_cbor_header(entry, cbor_header, options);
+        REQUIRE(decode_cbor(cbor_header) == json::parse(json_header));
+    }
+}
+
+TEST_CASE("Output profile - formatter headers only when metadata is moved", "[formatter][profile]") {
+    auto entry = make_golden_entry();
+    std::string out;
+
+    JsonFormatter{}.format_header(entry, out);
+    CborFormatter{}.format_header(entry, out);
+    PatternFormatter{}.format_header(entry, out);
+    REQUIRE(out.empty());
+
+    JsonFormatter{make_format_options(OutputProfile::Compact)}.format_header(entry, out);
+    REQUIRE(out == R"({"log_header":{"env":"production","svc":"order-service","ver":"1.2.3"}})" "\n");
+}
+
+TEST_CASE("Pattern layout - trimmed function", "[formatter][pattern][profile]") {
+    auto entry = make_golden_entry();
+    PatternLayout layout("%f");
+    std::string out;
+    FormatOptions options;
+    options.trim_function = true;
+    layout.format(entry, out, options);
+    REQUIRE(out == "place_order");
+}
+
+TEST_CASE("Batch formatter - matches per-entry JSON", "[formatter][batch]") {
+    std::vector<LogEntry> entries;
+    entries.push_back(make_golden_entry());
+
+    auto with_fields = make_golden_entry();
+    with_fields.level = Level::Error;
+    with_fields.message = "quote \" and\nnewline";
+    with_fields.context = {
+        {"zeta", std::string("last")},
+        {"alpha", std::int64_t{-42}},
+        {"ratio", 0.25},
+        {"ok", true}
+    };
+    with_fields.duration_ms = 12.5;
+    with_fields.exception = ExceptionInfo{"std::runtime_error", "boom"};
+    entries.push_back(with_fields);
+
+    auto other_service = make_golden_entry();
+    other_service.service_name = "billing \"svc\"";
+    entries.push_back(other_service);
+    entries.push_back(make_golden_entry());
+
+    RecordBatch batch;
+    for (const auto& entry : entries) {
+        batch.push_back(entry);
+    }
+    REQUIRE(batch.size() == 4);
+    REQUIRE(batch.metadata().size() == 3);
+
+    for (auto profile : {OutputProfile::Full, OutputProfile::Compact, OutputProfile::Minimal}) {
+        auto options = make_format_options(profile);
+        JsonFormatter formatter(options);
+        std::string expected;
+        for (const auto& entry : entries) {
+            formatter.format(entry, expected);
+        }
+
+        std::string out;
+        format_json_batch(batch, out, options);
+        REQUIRE(out == expected);
+    }
+}
+
+TEST_CASE("Batch formatter - clear and reuse", "[formatter][batch]") {
+    RecordBatch batch;
+    auto entry = make_golden_entry();
+    entry.context = {{"request_id", std::string("abc")}};
+    batch.push_back(entry);
+    batch.clear();
+    REQUIRE(batch.empty());
+    REQUIRE(batch.metadata().empty());
+
+    entry.message = "second";
+    batch.push_back(entry);
+    std::string out;
+    format_json_batch(batch, out);
+    REQUIRE(out == format_json(entry) + "\n");
+}
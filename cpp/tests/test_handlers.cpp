@@ -4,9 +4,18 @@
  *
  * Tests cover:
  * - Console handler (JSON and text format)
- * - File handler (basic file writing)
+ * - Buffered console handler (batched writes, stderr routing, drop mode)
+ * - journald / syslog handlers (native fields, memfd, RFC 5424, drops)
+ * - File handler (basic file writing, spill and replay on disk errors)
  * - Rotating file handler (size-based rotation)
+ * - Buffered file handler (contiguous buffers, rotation)
+ * - io_uring file handler (writes in flight, fsync, fallback)
+ * - mmap file handler (lock-free reservation, segment rolls, reopen)
+ * - Per-thread file handler (segments per thread, timestamp merge, torn tails)
  * - Thread-safe concurrent writes
+ * - Formatter/sink split: one serialization shared across handlers
+ * - Sink executor (parallel fan-out, per-sink order, lag metrics, drops)
+ * - Durable file handler (group commit, commit tokens, write errors)
  */
 
 #include <catch2/catch_test_macros.hpp>
@@ -14,15 +23,40 @@
 #include <agora/log/logger.hpp>
 #include <agora/log/config.hpp>
 #include <agora/log/handlers/console.hpp>
+#include <agora/log/handlers/buffered_console.hpp>
+#include <agora/log/handlers/journald.hpp>
+#include <agora/log/handlers/syslog.hpp>
 #include <agora/log/handlers/file.hpp>
 #include <agora/log/handlers/rotating_file.hpp>
+#include <agora/log/handlers/buffered_file.hpp>
+#include <agora/log/handlers/io_uring_file.hpp>
+#include <agora/log/handlers/mmap_file.hpp>
+#include <agora/log/handlers/per_thread_file.hpp>
+#include <agora/log/handlers/durable_file.hpp>
+#include <agora/log/commit.hpp>
+#include <agora/log/pattern.hpp>
+#include <agora/log/sink_executor.hpp>
+#include <agora/log/spill.hpp>
+#include <agora/log/thread_segment.hpp>
 
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <mutex>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <thread>
 #include <vector>
+#include <atomic>
+#include <iostream>
 #include <nlohmann/json.hpp>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 using namespace agora::log;
 using json = nlohmann::json;
@@ -82,6 +116,111 @@ TEST_CASE("Console handler text output", "[handler][console]") {
     fixture.TearDown();
 }
 
+namespace {
+
+// Lines currently readable from a pipe (read end made non-blocking)
+std::vector<std::string> drain_lines(int fd) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    std::string data;
+    char chunk[4096];
+    for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;) {
+        data.append(chunk, static_cast<std::size_t>(n));
+    }
+    std::vector<std::string> lines;
+    std::istringstream in(data);
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Buffered console handler batches records per stream", "[handler][console][buffered]") {
+    int out[2];
+    int err[2];
+    REQUIRE(::pipe(out) == 0);
+    REQUIRE(::pipe(err) == 0);
+    {
+        BufferedConsoleHandler handler(nullptr, 64 * 1024, 60'000, false, out[1], err[1]);
+
+        LogEntry entry;
+        entry.logger_name = "test.console";
+        for (int i = 0; i < 100; ++i) {
+            entry.level = i % 20 == 0 ? Level::Error : Level::Info;
+            entry.message = "Console entry " + std::to_string(i);
+            handler.write(entry);
+        }
+        REQUIRE(drain_lines(out[0]).empty());
+
+        handler.flush();
+        REQUIRE(handler.entries_written() == 100);
+        REQUIRE(handler.write_calls() == 2);  // One batch per stream
+
+        auto info = drain_lines(out[0]);
+        auto errors = drain_lines(err[0]);
+        REQUIRE(info.size() == 95);
+        REQUIRE(errors.size() == 5);
+        REQUIRE(json::parse(info.front())["message"] == "Console entry 1");
+        REQUIRE(json::parse(errors.back())["message"] == "Console entry 80");
+    }
+    for (int fd : {out[0], out[1], err[0], err[1]}) {
+        ::close(fd);
+    }
+}
+
+TEST_CASE("Buffered console handler drops instead of blocking on a full pipe", "[handler][console][buffered]") {
+    int out[2];
+    REQUIRE(::pipe(out) == 0);
+    std::vector<std::string> lines;
+    std::thread reader;
+    {
+        BufferedConsoleHandler handler(nullptr, 4096, 1, true, out[1], out[1]);
+
+        // Nobody reads the pipe: the writer thread blocks, callers must not
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&handler, t] {
+                LogEntry entry;
+                entry.level = Level::Info;
+                for (int i = 0; i < 5000; ++i) {
+                    entry.message = "Thread " + std::to_string(t) + " entry " + std::to_string(i);
+                    handler.write(entry);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(handler.dropped() > 0);
+        REQUIRE(handler.entries_written() + handler.dropped() == 20000);
+
+        // Let the pipe drain so the destructor can write the rest
+        reader = std::thread([&] {
+            std::string data;
+            char chunk[4096];
+            for (ssize_t n; (n = ::read(out[0], chunk, sizeof(chunk))) > 0;) {
+                data.append(chunk, static_cast<std::size_t>(n));
+            }
+            std::istringstream in(data);
+            for (std::string line; std::getline(in, line);) {
+                lines.push_back(line);
+            }
+        });
+        handler.flush();
+        REQUIRE(handler.dropped() + handler.entries_written() == 20000);
+    }
+    ::close(out[1]);
+    reader.join();
+    ::close(out[0]);
+
+    // Every accepted record arrives whole
+    REQUIRE(lines.size() > 0);
+    for (const auto& line : lines) {
+        REQUIRE(json::parse(line)["message"].get<std::string>().starts_with("Thread "));
+    }
+}
+
 TEST_CASE("File handler basic writing", "[handler][file]") {
     HandlerTestFixture fixture;
     fixture.SetUp();
@@ -224,3 +363,1291 @@ TEST_CASE("Handler flush on shutdown", "[handler][flush]") {
 
     fixture.TearDown();
 }
+
+namespace {
+
+/**
+ * @brief Formatter that counts how often it is invoked.
+ */
+class CountingFormatter : public Formatter {
+public:
+    mutable std::atomic<int> calls{0};
+
+    void format(const LogEntry& entry, std::string& out) const override {
+        ++calls;
+        out += entry.message;
+        out += '\n';
+    }
+};
+
+/**
+ * @brief Sink that records the bytes it receives.
+ */
+class CaptureHandler : public Handler {
+public:
+    explicit CaptureHandler(std::shared_ptr<const Formatter> formatter)
+        : Handler(std::move(formatter)) {}
+
+    void write_formatted(const LogEntry& /*entry*/, std::string_view record) override {
+        records.emplace_back(record);
+    }
+
+    void flush() noexcept override {}
+
+    std::vector<std::string> records;
+};
+
+/**
+ * @brief CaptureHandler whose writes wait until the gate opens.
+ */
+class GatedHandler : public CaptureHandler {
+public:
+    using CaptureHandler::CaptureHandler;
+
+    void write_formatted(const LogEntry& entry, std::string_view record) override {
+        ++waiting;
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return open_; });
+        --waiting;
+        CaptureHandler::write_formatted(entry, record);
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        cv_.notify_all();
+    }
+
+    std::atomic<int> waiting{0};  // Writers held at the gate
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool open_ = false;
+};
+
+}  // anonymous namespace
+
+TEST_CASE("Handler default write formats through its formatter", "[handler][formatter]") {
+    auto formatter = std::make_shared<CountingFormatter>();
+    CaptureHandler handler(formatter);
+
+    LogEntry entry;
+    entry.message = "hello";
+    handler.write(entry);
+
+    REQUIRE(formatter->calls == 1);
+    REQUIRE(handler.records.size() == 1);
+    REQUIRE(handler.records[0] == "hello\n");
+    REQUIRE(handler.formatter() == formatter.get());
+}
+
+TEST_CASE("Console and file share one serialized record", "[handler][formatter]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto log_file = fixture.test_log_dir / "shared.log";
+
+    auto config = Config{};
+    config.service_name = "test";
+    config.file_path = log_file;
+    config.console_enabled = true;
+    config.console_json = true;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    std::ostringstream captured;
+    auto* old_buf = std::cout.rdbuf(captured.rdbuf());
+
+    auto logger = get_logger("test.shared");
+    logger.info("Shared line", {{"k", std::int64_t{1}}});
+
+    std::cout.rdbuf(old_buf);
+    shutdown();
+
+    auto lines = fixture.read_lines(log_file);
+    REQUIRE(lines.size() == 1);
+    REQUIRE(captured.str() == lines[0] + "\n");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Synchronous dispatch formats once for handlers sharing a formatter", "[handler][formatter]") {
+    auto shared = std::make_shared<CountingFormatter>();
+    auto own = std::make_shared<CountingFormatter>();
+    auto first = std::make_shared<CaptureHandler>(shared);
+    auto second = std::make_shared<CaptureHandler>(shared);
+    auto third = std::make_shared<CaptureHandler>(own);
+    const std::vector<std::shared_ptr<Handler>> handlers{first, second, third};
+
+    for (int i = 1; i <= 3; ++i) {
+        LogEntry entry;
+        entry.message = "entry " + std::to_string(i);
+        dispatch(handlers, entry);
+
+        // One serialization per entry and formatter, whatever the handler count
+        REQUIRE(shared->calls == i);
+        REQUIRE(own->calls == i);
+    }
+
+    REQUIRE(first->records == second->records);
+    REQUIRE(first->records == third->records);
+    REQUIRE(first->records.back() == "entry 3\n");
+}
+
+TEST_CASE("Console text mode uses the configured pattern", "[handler][formatter]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "svc";
+    config.file_enabled = false;
+    config.console_json = false;
+    config.console_pattern = "%l|%S|%n|%m%C";
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    std::ostringstream captured;
+    auto* old_buf = std::cout.rdbuf(captured.rdbuf());
+
+    auto logger = get_logger("test.pattern");
+    logger.info("Hello", {{"k", std::string("v")}});
+
+    std::cout.rdbuf(old_buf);
+    shutdown();
+
+    REQUIRE(captured.str() == "INFO|svc|test.pattern|Hello (k=v)\n");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Rotating file handler writes length-delimited CBOR", "[handler][cbor]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "test";
+    config.console_enabled = false;
+    config.file_path = fixture.test_log_dir / "app.cbor";
+    config.file_format = FileFormat::Cbor;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    auto logger = get_logger("test.cbor");
+    logger.info("first", {{"qty", std::int64_t{10}}});
+    logger.warning("second");
+    shutdown();
+
+    std::ifstream file(config.file_path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<json> records;
+    std::size_t pos = 0;
+    while (pos + 4 <= bytes.size()) {
+        std::size_t length = 0;
+        for (int i = 0; i < 4; ++i) {
+            length = (length << 8) | static_cast<unsigned char>(bytes[pos + i]);
+        }
+        pos += 4;
+        REQUIRE(pos + length <= bytes.size());
+        records.push_back(json::from_cbor(bytes.substr(pos, length)));
+        pos += length;
+    }
+
+    REQUIRE(pos == bytes.size());
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0]["message"] == "first");
+    REQUIRE(records[0]["context"]["qty"] == 10);
+    REQUIRE(records[1]["level"] == "WARNING");
+    REQUIRE(records[1]["logger_name"] == "test.cbor");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Compact profile writes a header per file", "[handler][profile]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "svc";
+    config.version = "9.9.9";
+    config.console_enabled = false;
+    config.file_path = fixture.test_log_dir / "compact.log";
+    config.max_file_size_mb = 0.001;  // ~1 KB, forces rotation
+    config.output_profile = OutputProfile::Compact;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    auto logger = get_logger("test.compact");
+    for (int i = 0; i < 20; ++i) {
+        logger.info("Compact entry " + std::to_string(i));
+    }
+    shutdown();
+
+    auto check_file = [&](const fs::path& path) {
+        auto lines = fixture.read_lines(path);
+        REQUIRE(lines.size() >= 2);
+        auto header = json::parse(lines[0]);
+        REQUIRE(header["log_header"]["svc"] == "svc");
+        REQUIRE(header["log_header"]["ver"] == "9.9.9");
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            auto record = json::parse(lines[i]);
+            REQUIRE_FALSE(record.contains("svc"));
+            REQUIRE(record["logger"] == "test.compact");
+            REQUIRE(record["fn"].get<std::string>().find('(') == std::string::npos);
+        }
+    };
+
+    check_file(config.file_path);
+    check_file(config.file_path.string() + ".1");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Buffered file handler writes a buffer with one syscall", "[handler][buffered]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "buffered.log";
+    {
+        // Large buffer and interval: nothing is written until flush()
+        BufferedFileHandler handler(path, 1024 * 1024, 60'000);
+
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.service_name = "svc";
+        entry.logger_name = "test.buffered";
+        for (int i = 0; i < 100; ++i) {
+            entry.message = "Buffered entry " + std::to_string(i);
+            handler.write(entry);
+        }
+        REQUIRE(fixture.read_lines(path).empty());
+
+        handler.flush();
+        REQUIRE(handler.entries_written() == 100);
+        REQUIRE(handler.write_calls() == 1);
+
+        auto lines = fixture.read_lines(path);
+        REQUIRE(lines.size() == 100);
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            REQUIRE(json::parse(lines[i])["message"] == "Buffered entry " + std::to_string(i));
+        }
+
+        // Records left in the buffer are written on destruction
+        entry.message = "Last entry";
+        handler.write(entry);
+    }
+
+    auto lines = fixture.read_lines(path);
+    REQUIRE(lines.size() == 101);
+    REQUIRE(json::parse(lines.back())["message"] == "Last entry");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Buffered file handler disables rotation when the file cannot be reopened", "[handler][buffered]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "buffered_reopen.log";
+    {
+        BufferedFileHandler handler(path, 1024 * 1024, 60'000, nullptr, 2048, 3);
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = "first";
+        handler.write(entry);
+        handler.flush();
+
+        // The next batch crosses a rotation point; open() then fails with EMFILE
+        entry.message = std::string(200, 'x');
+        for (int i = 0; i < 20; ++i) {
+            handler.write(entry);
+        }
+        rlimit previous{};
+        ::getrlimit(RLIMIT_NOFILE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = 0;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+        handler.flush();
+        ::setrlimit(RLIMIT_NOFILE, &previous);
+
+        // The failure reached the fallback instead of escaping the batch
+        REQUIRE(handler.rotation_disabled());
+
+        entry.message = "after";
+        handler.write(entry);
+        handler.flush();
+        auto lines = fixture.read_lines(path);
+        REQUIRE_FALSE(lines.empty());
+        REQUIRE(json::parse(lines.back())["message"] == "after");
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Buffered file handler rotates on record boundaries", "[handler][buffered][profile]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "svc";
+    config.console_enabled = false;
+    config.file_path = fixture.test_log_dir / "buffered_rotation.log";
+    config.file_buffered = true;
+    config.max_file_size_mb = 0.001;  // ~1 KB, forces rotation
+    config.max_backup_count = 50;
+    config.output_profile = OutputProfile::Compact;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    auto logger = get_logger("test.buffered");
+    constexpr int kEntries = 60;
+    for (int i = 0; i < kEntries; ++i) {
+        logger.info("Buffered rotation entry " + std::to_string(i));
+    }
+    shutdown();
+
+    std::vector<fs::path> files;
+    for (int i = 50; i >= 1; --i) {
+        auto backup = fs::path(config.file_path.string() + "." + std::to_string(i));
+        if (fs::exists(backup)) {
+            files.push_back(backup);
+        }
+    }
+    files.push_back(config.file_path);
+    REQUIRE(files.size() > 2);
+
+    // Every file starts with a header and the records stay in order
+    int expected = 0;
+    for (const auto& file : files) {
+        REQUIRE(fs::file_size(file) <= 1048);
+        auto lines = fixture.read_lines(file);
+        REQUIRE(lines.size() >= 2);
+        REQUIRE(json::parse(lines[0]).contains("log_header"));
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            REQUIRE(json::parse(lines[i])["msg"] == "Buffered rotation entry " + std::to_string(expected++));
+        }
+    }
+    REQUIRE(expected == kEntries);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("io_uring file handler keeps records in order", "[handler][io_uring]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "uring.log";
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    {
+        // Small buffers so records span buffers and several writes are in flight
+        auto handler = make_io_uring_file_handler(path, 4096, 2, 60'000, nullptr, true);
+        auto* uring = dynamic_cast<IoUringFileHandler*>(handler.get());
+        if (io_uring_available()) {
+            REQUIRE(uring != nullptr);
+        } else {
+            REQUIRE(dynamic_cast<BufferedFileHandler*>(handler.get()) != nullptr);
+        }
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                LogEntry entry;
+                entry.level = Level::Info;
+                entry.logger_name = "thread" + std::to_string(t);
+                for (int i = 0; i < kPerThread; ++i) {
+                    entry.message = std::to_string(i);
+                    handler->write(entry);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        handler->flush();
+        REQUIRE(fixture.read_lines(path).size() == kThreads * kPerThread);
+        if (uring) {
+            REQUIRE(uring->writes_submitted() > 1);
+            REQUIRE(uring->write_errors() == 0);
+        }
+    }
+
+    std::vector<int> next(kThreads, 0);
+    for (const auto& line : fixture.read_lines(path)) {
+        auto record = json::parse(line);
+        int t = std::stoi(record["logger_name"].get<std::string>().substr(6));
+        REQUIRE(record["message"] == std::to_string(next[t]++));
+    }
+    REQUIRE(next == std::vector<int>(kThreads, kPerThread));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("io_uring file handler reopens a file a rotation could not", "[handler][io_uring]") {
+    if (!io_uring_available()) {
+        return;
+    }
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "uring_reopen.log";
+    {
+        IoUringFileHandler handler(path, 4096, 2, 60'000, nullptr, false, 2048, 3);
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = "first";
+        handler.write(entry);
+        handler.flush();
+
+        // The rotation renames the file but cannot open a new one (EMFILE)
+        entry.message = std::string(200, 'x');
+        for (int i = 0; i < 20; ++i) {
+            handler.write(entry);
+        }
+        rlimit previous{};
+        ::getrlimit(RLIMIT_NOFILE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = 0;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+        handler.flush();
+        ::setrlimit(RLIMIT_NOFILE, &previous);
+        REQUIRE(handler.write_errors() > 0);
+
+        // The next write opens the file again
+        entry.message = "after";
+        handler.write(entry);
+        handler.flush();
+        auto lines = fixture.read_lines(path);
+        REQUIRE_FALSE(lines.empty());
+        REQUIRE(json::parse(lines.back())["message"] == "after");
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("io_uring file output rotates with headers", "[handler][io_uring][profile]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "svc";
+    config.console_enabled = false;
+    config.file_path = fixture.test_log_dir / "uring_rotation.log";
+    config.file_io_uring = true;
+    config.file_buffer_size = 4096;
+    config.max_file_size_mb = 0.001;  // ~1 KB, forces rotation
+    config.max_backup_count = 50;
+    config.output_profile = OutputProfile::Compact;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    auto logger = get_logger("test.uring");
+    constexpr int kEntries = 60;
+    for (int i = 0; i < kEntries; ++i) {
+        logger.info("io_uring rotation entry " + std::to_string(i));
+    }
+    shutdown();
+
+    std::vector<fs::path> files;
+    for (int i = 50; i >= 1; --i) {
+        auto backup = fs::path(config.file_path.string() + "." + std::to_string(i));
+        if (fs::exists(backup)) {
+            files.push_back(backup);
+        }
+    }
+    files.push_back(config.file_path);
+    REQUIRE(files.size() > 2);
+
+    int expected = 0;
+    for (const auto& file : files) {
+        REQUIRE(fs::file_size(file) <= 1048);
+        auto lines = fixture.read_lines(file);
+        REQUIRE(lines.size() >= 2);
+        REQUIRE(json::parse(lines[0]).contains("log_header"));
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            REQUIRE(json::parse(lines[i])["msg"] == "io_uring rotation entry " + std::to_string(expected++));
+        }
+    }
+    REQUIRE(expected == kEntries);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("mmap file handler rolls segments under concurrent writers", "[handler][mmap]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "mmap.log";
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    {
+        // 8 KB segments: writers race on the boundary many times
+        MmapFileHandler handler(path, 8192, 100,
+            std::make_shared<JsonFormatter>(make_format_options(OutputProfile::Compact)));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                LogEntry entry;
+                entry.level = Level::Info;
+                entry.logger_name = "thread" + std::to_string(t);
+                for (int i = 0; i < kPerThread; ++i) {
+                    entry.message = std::to_string(i);
+                    handler.write(entry);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        handler.flush();
+        REQUIRE(handler.entries_written() == kThreads * kPerThread);
+        REQUIRE(handler.segments_mapped() > 2);
+    }
+
+    // Oldest backup first; every file is truncated to its data and starts with a header
+    std::vector<fs::path> files;
+    for (int i = 100; i >= 1; --i) {
+        auto backup = fs::path(path.string() + "." + std::to_string(i));
+        if (fs::exists(backup)) {
+            files.push_back(backup);
+        }
+    }
+    files.push_back(path);
+
+    std::vector<int> next(kThreads, 0);
+    for (const auto& file : files) {
+        REQUIRE(fs::file_size(file) <= 8192);
+        auto lines = fixture.read_lines(file);
+        REQUIRE(json::parse(lines[0]).contains("log_header"));
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            REQUIRE(lines[i].find('\0') == std::string::npos);
+            auto record = json::parse(lines[i]);
+            int t = std::stoi(record["logger"].get<std::string>().substr(6));
+            REQUIRE(record["msg"] == std::to_string(next[t]++));
+        }
+    }
+    REQUIRE(next == std::vector<int>(kThreads, kPerThread));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("mmap file handler appends after a torn, NUL-padded tail", "[handler][mmap]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    // What a crash leaves: complete records, a torn one, then preallocated NULs
+    auto path = fixture.test_log_dir / "mmap_crash.log";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "{\"msg\":\"before\"}\n{\"ms";
+        out << std::string(4096, '\0');
+    }
+
+    {
+        MmapFileHandler handler(path, 64 * 1024, 5,
+            std::make_shared<JsonFormatter>(make_format_options(OutputProfile::Compact)));
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = "after";
+        handler.write(entry);
+    }
+
+    // The old file was cut at its NULs and rotated; a reader skips the torn record
+    REQUIRE(fs::file_size(path.string() + ".1") == 21);
+    std::vector<std::string> records;
+    auto lines = fixture.read_lines(path.string() + ".1");
+    for (const auto& line : fixture.read_lines(path)) {
+        lines.push_back(line);
+    }
+    for (const auto& line : lines) {
+        REQUIRE(line.find('\0') == std::string::npos);
+        auto record = json::parse(line, nullptr, false);
+        if (!record.is_discarded()) {
+            records.push_back(record.contains("log_header") ? "header" : record["msg"].get<std::string>());
+        }
+    }
+    REQUIRE(records == std::vector<std::string>{"before", "header", "after"});
+
+    fixture.TearDown();
+}
+
+TEST_CASE("mmap file handler keeps its backups when a segment cannot be allocated", "[handler][mmap]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "mmap_full.log";
+    {
+        MmapFileHandler handler(path, 8192, 3,
+            std::make_shared<JsonFormatter>(make_format_options(OutputProfile::Compact)));
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = std::string(200, 'x');
+        auto write_until_rolled = [&] {
+            for (auto mapped = handler.segments_mapped(); handler.segments_mapped() == mapped;) {
+                handler.write(entry);
+            }
+        };
+        for (int i = 0; i < 4; ++i) {  // The first segment, then three rolls
+            write_until_rolled();
+        }
+        auto inode = [](const fs::path& file) {
+            struct stat st{};
+            return ::stat(file.c_str(), &st) == 0 ? st.st_ino : 0;
+        };
+        auto backups = std::vector<ino_t>{inode(path.string() + ".1"), inode(path.string() + ".2"),
+                                          inode(path.string() + ".3")};
+
+        // Segments cannot be allocated: fallocate fails with EFBIG (SIGXFSZ ignored)
+        auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous{};
+        ::getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = 4096;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+
+        int failures = 0;
+        for (int i = 0; i < 100; ++i) {
+            try {
+                handler.write(entry);
+            } catch (const std::system_error&) {
+                ++failures;
+            }
+        }
+
+        ::setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, previous_handler);
+
+        // Every record past the sealed segment failed, without rotating
+        REQUIRE(failures > 50);
+        REQUIRE(std::vector<ino_t>{inode(path.string() + ".1"), inode(path.string() + ".2"),
+                                   inode(path.string() + ".3")} == backups);
+        REQUIRE_FALSE(fs::exists(path.string() + ".next"));
+
+        write_until_rolled();
+    }
+    REQUIRE(fs::exists(path.string() + ".3"));
+    REQUIRE_FALSE(fs::exists(path.string() + ".4"));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("mmap file handler keeps appending to the live file when rotation fails", "[handler][mmap]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto path = fixture.test_log_dir / "mmap_stuck.log";
+    fs::create_directories(path.string() + ".1/in_the_way");  // Rotation cannot replace it
+    {
+        MmapFileHandler handler(path, 8192, 1,
+            std::make_shared<JsonFormatter>(make_format_options(OutputProfile::Compact)));
+        LogEntry entry;
+        entry.level = Level::Info;
+        for (int i = 0; i < 200; ++i) {
+            entry.message = "record " + std::to_string(i) + " " + std::string(200, 'x');
+            handler.write(entry);
+        }
+        REQUIRE(handler.segments_mapped() > 3);
+    }
+
+    // Segments continue the live file: one header, every record in order, no NUL gaps
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(contents.find('\0') == std::string::npos);
+    auto lines = fixture.read_lines(path);
+    REQUIRE(lines.size() == 201);
+    REQUIRE(lines[0].find("log_header") != std::string::npos);
+    for (std::size_t i = 1; i < lines.size(); ++i) {
+        REQUIRE(lines[i].find("record " + std::to_string(i - 1) + " ") != std::string::npos);
+    }
+
+    fixture.TearDown();
+}
+
+namespace {
+
+// Stand-in for journald / the syslog daemon: a bound Unix datagram socket
+class DatagramReceiver {
+public:
+    explicit DatagramReceiver(const fs::path& path) : path_(path) {
+        fs::remove(path_);
+        fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path_.c_str(), sizeof(address.sun_path) - 1);
+        REQUIRE(::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        timeval timeout{2, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~DatagramReceiver() {
+        ::close(fd_);
+        fs::remove(path_);
+    }
+
+    // Next datagram; a passed memfd is read back in its place
+    std::string receive() {
+        std::string data(256 * 1024, '\0');
+        iovec vector{data.data(), data.size()};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t n = ::recvmsg(fd_, &message, 0);
+        REQUIRE(n >= 0);
+        data.resize(static_cast<std::size_t>(n));
+
+        if (cmsghdr* header = CMSG_FIRSTHDR(&message); header && header->cmsg_type == SCM_RIGHTS) {
+            int memfd;
+            std::memcpy(&memfd, CMSG_DATA(header), sizeof(int));
+            REQUIRE(::fcntl(memfd, F_GET_SEALS) & F_SEAL_WRITE);
+            data.assign(static_cast<std::size_t>(::lseek(memfd, 0, SEEK_END)), '\0');
+            REQUIRE(::pread(memfd, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+            ::close(memfd);
+        }
+        return data;
+    }
+
+private:
+    fs::path path_;
+    int fd_;
+};
+
+}  // anonymous namespace
+
+TEST_CASE("journald handler sends native fields in batches", "[handler][journald]") {
+    auto path = fs::temp_directory_path() / "agora_journald_test.sock";
+    DatagramReceiver journal(path);
+    JournaldHandler handler(path, 1024 * 1024, 60'000);
+
+    LogEntry entry;
+    entry.level = Level::Warning;
+    entry.service_name = "svc";
+    entry.logger_name = "test.journald";
+    entry.location = {"main.cpp", 42, "run"};
+    entry.context = {{"request-id", "abc"}, {"attempt", std::int64_t{3}}};
+    for (int i = 0; i < 10; ++i) {
+        entry.message = "Journal entry " + std::to_string(i);
+        handler.write(entry);
+    }
+    entry.message = "two\nlines";
+    handler.write(entry);
+    handler.flush();
+    REQUIRE(handler.entries_sent() == 11);
+    REQUIRE(handler.send_calls() == 1);
+
+    auto first = journal.receive();
+    REQUIRE(first.starts_with("MESSAGE=Journal entry 0\nPRIORITY=4\nSYSLOG_IDENTIFIER=svc\n"));
+    REQUIRE(first.find("\nCODE_LINE=42\n") != std::string::npos);
+    REQUIRE(first.find("\nREQUEST_ID=abc\n") != std::string::npos);
+    REQUIRE(first.find("\nATTEMPT=3\n") != std::string::npos);
+    for (int i = 1; i < 10; ++i) {
+        REQUIRE(journal.receive().starts_with("MESSAGE=Journal entry " + std::to_string(i) + "\n"));
+    }
+
+    // Values with newlines use the length-prefixed form
+    auto multiline = journal.receive();
+    REQUIRE(multiline.starts_with(std::string("MESSAGE\n\x09\0\0\0\0\0\0\0two\nlines\n", 23)));
+}
+
+TEST_CASE("journald context keys never duplicate the formatter's fields", "[handler][journald]") {
+    LogEntry entry;
+    entry.level = Level::Error;
+    entry.message = "real";
+    entry.location = {"main.cpp", 7, "run"};
+    entry.context = {{"message", "fake"}, {"priority", std::int64_t{7}}, {"code_line", std::int64_t{1}},
+                     {"Syslog-Identifier", "other"}, {"2fa", true}, {"message_kind", "kept"}};
+
+    std::string out;
+    JournaldFormatter().format(entry, out);
+
+    auto count = [&](std::string_view field) {
+        std::size_t n = 0;
+        for (auto pos = out.find(field); pos != std::string::npos; pos = out.find(field, pos + 1)) {
+            n += pos == 0 || out[pos - 1] == '\n';
+        }
+        return n;
+    };
+    REQUIRE(count("MESSAGE=") == 1);
+    REQUIRE(count("PRIORITY=") == 1);
+    REQUIRE(count("CODE_LINE=") == 1);
+    REQUIRE(count("SYSLOG_IDENTIFIER=") == 0);
+    REQUIRE(out.starts_with("MESSAGE=real\nPRIORITY=3\n"));
+    REQUIRE(out.find("\nCTX_MESSAGE=fake\n") != std::string::npos);
+    REQUIRE(out.find("\nCTX_PRIORITY=7\n") != std::string::npos);
+    REQUIRE(out.find("\nCTX_CODE_LINE=1\n") != std::string::npos);
+    REQUIRE(out.find("\nCTX_SYSLOG_IDENTIFIER=other\n") != std::string::npos);
+    REQUIRE(out.find("\nCTX_2FA=true\n") != std::string::npos);
+    REQUIRE(out.find("\nMESSAGE_KIND=kept\n") != std::string::npos);
+}
+
+TEST_CASE("journald handler passes oversized records as a sealed memfd", "[handler][journald]") {
+    auto path = fs::temp_directory_path() / "agora_journald_memfd.sock";
+    DatagramReceiver journal(path);
+    JournaldHandler handler(path, 8 * 1024 * 1024, 60'000);
+
+    LogEntry entry;
+    entry.level = Level::Info;
+    entry.message = std::string(4 * 1024 * 1024, 'x');
+    handler.write(entry);
+    handler.flush();
+    REQUIRE(handler.entries_sent() == 1);
+    REQUIRE(handler.dropped() == 0);
+
+    auto record = journal.receive();
+    REQUIRE(record.size() > entry.message.size());
+    REQUIRE(record.starts_with("MESSAGE=xxxx"));
+}
+
+TEST_CASE("syslog handler sends RFC 5424 messages", "[handler][syslog]") {
+    auto path = fs::temp_directory_path() / "agora_syslog_test.sock";
+    DatagramReceiver syslog(path);
+    SyslogHandler handler(path, 16, 1024 * 1024, 60'000);
+
+    LogEntry entry;
+    entry.level = Level::Error;
+    entry.service_name = "svc";
+    entry.logger_name = "test.syslog";
+    entry.location = {"main.cpp", 7, "run"};
+    entry.context = {{"user", "a\"b]"}};
+    entry.message = "Something failed";
+    handler.write(entry);
+    handler.flush();
+
+    // local0 (16) * 8 + error (3) = 131
+    auto message = syslog.receive();
+    REQUIRE(message.starts_with("<131>1 "));
+    REQUIRE(message.find(" svc " + std::to_string(::getpid()) + " test.syslog [src@32473 file=\"main.cpp\" line=\"7\" function=\"run\"]") != std::string::npos);
+    REQUIRE(message.find("[ctx@32473 user=\"a\\\"b\\]\"]") != std::string::npos);
+    REQUIRE(message.ends_with("] Something failed"));
+}
+
+TEST_CASE("Datagram handlers drop instead of blocking when the daemon stalls", "[handler][syslog]") {
+    auto path = fs::temp_directory_path() / "agora_syslog_stall.sock";
+    DatagramReceiver syslog(path);  // Never read until the end
+    {
+        SyslogHandler handler(path, 1, 16 * 1024, 1);
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = std::string(200, 'm');
+        for (int i = 0; i < 20000; ++i) {
+            handler.write(entry);
+        }
+        REQUIRE(handler.dropped() > 0);
+    }
+}
+
+TEST_CASE("Sink executor writes sinks in parallel, each in order", "[handler][executor]") {
+    auto formatter = std::make_shared<CountingFormatter>();
+    auto fast = std::make_shared<CaptureHandler>(formatter);
+    auto slow = std::make_shared<GatedHandler>(formatter);
+
+    SinkExecutor executor({{"fast", fast}, {"slow", slow}}, 2);
+    const std::size_t both[] = {0, 1};
+
+    for (int i = 0; i < 100; ++i) {
+        LogEntry entry;
+        entry.message = "record " + std::to_string(i);
+        executor.submit(both, std::move(entry));
+    }
+
+    // The slow sink is stuck, the fast one still gets everything
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (executor.stats()[0].written < 100 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto stats = executor.stats();
+    REQUIRE(stats[0].name == "fast");
+    REQUIRE(stats[0].written == 100);
+    REQUIRE(stats[0].queued == 0);
+    REQUIRE(stats[1].written == 0);
+    REQUIRE(stats[1].queued == 100);
+
+    slow->open();
+    executor.drain();
+
+    // One serialization per record, shared by both sinks
+    REQUIRE(formatter->calls == 100);
+    for (const auto& sink : {std::static_pointer_cast<CaptureHandler>(fast), std::static_pointer_cast<CaptureHandler>(slow)}) {
+        REQUIRE(sink->records.size() == 100);
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(sink->records[static_cast<std::size_t>(i)] == "record " + std::to_string(i) + "\n");
+        }
+    }
+
+    stats = executor.stats();
+    REQUIRE(stats[1].written == 100);
+    REQUIRE(stats[1].max_queued == 100);
+    REQUIRE(stats[1].max_lag >= stats[0].max_lag);
+    REQUIRE(stats[1].max_lag > std::chrono::nanoseconds(0));
+}
+
+TEST_CASE("Sink executor drops for a full queue in drop mode", "[handler][executor]") {
+    auto formatter = std::make_shared<CountingFormatter>();
+    auto slow = std::make_shared<GatedHandler>(formatter);
+    auto fast = std::make_shared<CaptureHandler>(formatter);
+
+    SinkExecutor executor({{"slow", slow}, {"fast", fast}}, 2, 10, true);
+    const std::size_t slow_only[] = {0};
+    const std::size_t both[] = {0, 1};
+
+    for (int i = 0; i < 50; ++i) {
+        LogEntry entry;
+        entry.message = "x";
+        executor.submit(slow_only, std::move(entry));
+    }
+
+    slow->open();
+    executor.stop();
+
+    // At most one batch in flight plus a full queue were kept
+    auto stats = executor.stats();
+    REQUIRE(stats[0].dropped > 0);
+    REQUIRE(stats[0].written + stats[0].dropped == 50);
+    REQUIRE(stats[0].written <= 20);
+    REQUIRE(slow->records.size() == stats[0].written);
+    REQUIRE(stats[1].written == 0);
+
+    // After stop() records are written on the calling thread
+    LogEntry entry;
+    entry.message = "late";
+    executor.submit(both, std::move(entry));
+    REQUIRE(fast->records.back() == "late\n");
+}
+
+TEST_CASE("Sink executor writes after stop() behind the records still queued", "[handler][executor]") {
+    auto formatter = std::make_shared<CountingFormatter>();
+    auto slow = std::make_shared<GatedHandler>(formatter);
+
+    SinkExecutor executor({{"slow", slow}}, 1);
+    const std::size_t sink[] = {0};
+
+    for (int i = 0; i < 10; ++i) {
+        LogEntry entry;
+        entry.message = "record " + std::to_string(i);
+        executor.submit(sink, std::move(entry));
+    }
+    while (slow->waiting == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // stop() waits for the worker; a submit() meanwhile must not overtake it
+    std::thread stopper([&] { executor.stop(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::thread late([&] {
+        LogEntry entry;
+        entry.message = "late";
+        executor.submit(sink, std::move(entry));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(slow->waiting == 1);
+
+    slow->open();
+    stopper.join();
+    late.join();
+
+    REQUIRE(slow->records.size() == 11);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(slow->records[static_cast<std::size_t>(i)] == "record " + std::to_string(i) + "\n");
+    }
+    REQUIRE(slow->records.back() == "late\n");
+    REQUIRE(executor.stats()[0].written == 11);
+}
+
+TEST_CASE("Durable file handler group-commits concurrent writers", "[handler][durable]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto log_file = fixture.test_log_dir / "audit.log";
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 50;
+    std::atomic<int> committed{0};
+
+    {
+        DurableFileHandler handler(log_file);
+        REQUIRE(handler.durable());
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    LogEntry entry;
+                    entry.message = std::to_string(t) + ":" + std::to_string(i);
+                    entry.commit = std::make_shared<CommitState>(1);
+                    CommitToken token(entry.commit);
+                    handler.write(entry);
+                    if (token.wait()) {
+                        ++committed;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(committed == kThreads * kPerThread);
+        REQUIRE(handler.records_committed() == kThreads * kPerThread);
+        REQUIRE(handler.sync_calls() >= 1);
+        REQUIRE(handler.sync_calls() <= handler.records_committed());
+
+        // Records without a token are committed too; flush() waits for them
+        LogEntry entry;
+        entry.message = "untracked";
+        handler.write(entry);
+        handler.flush();
+        REQUIRE(handler.records_committed() == kThreads * kPerThread + 1);
+    }
+
+    auto lines = fixture.read_lines(log_file);
+    REQUIRE(lines.size() == kThreads * kPerThread + 1);
+    REQUIRE(lines.back().find("untracked") != std::string::npos);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Durable file handler fails tokens on write errors", "[handler][durable]") {
+    if (!fs::exists("/dev/full")) {
+        return;  // Needs a device that fails every write with ENOSPC
+    }
+
+    DurableFileHandler handler("/dev/full");
+
+    LogEntry entry;
+    entry.message = "lost";
+    entry.commit = std::make_shared<CommitState>(1);
+    CommitToken token(entry.commit);
+    handler.write(entry);
+
+    REQUIRE(token.wait_for(std::chrono::seconds(5)));
+    auto result = token.wait();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code == ENOSPC);
+    REQUIRE(handler.records_committed() == 0);
+}
+
+TEST_CASE("Per-thread file handler merges segments by timestamp", "[handler][per_thread]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto base = fixture.test_log_dir / "app.log";
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 500;
+    std::vector<fs::path> segments;
+
+    {
+        PerThreadFileHandler handler(base, std::make_shared<JsonFormatter>(make_format_options(OutputProfile::Compact)), 4096, 0);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    LogEntry entry;
+                    entry.timestamp = std::chrono::system_clock::now();
+                    entry.message = std::to_string(t) + ":" + std::to_string(i);
+                    handler.write(entry);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        segments = handler.segment_paths();
+        REQUIRE(segments.size() >= 1);
+        REQUIRE(segments.size() <= kThreads);
+        REQUIRE(handler.entries_written() == kThreads * kPerThread);
+    }
+    REQUIRE(find_thread_segments(base) == segments);
+
+    SegmentMerger merger(segments);
+    SegmentFrame frame;
+    std::vector<int> next(kThreads, 0);
+    std::int64_t last_timestamp = 0;
+    int records = 0;
+    int headers = 0;
+    while (*merger.next(frame)) {
+        REQUIRE(frame.timestamp_ns >= last_timestamp);
+        last_timestamp = frame.timestamp_ns;
+        if (frame.header) {
+            ++headers;
+            continue;
+        }
+        auto record = json::parse(frame.record);
+        auto message = record["msg"].get<std::string>();
+        int t = std::stoi(message.substr(0, message.find(':')));
+        int i = std::stoi(message.substr(message.find(':') + 1));
+        REQUIRE(i == next[t]++);  // Each thread's records stay in order
+        ++records;
+    }
+    REQUIRE(records == kThreads * kPerThread);
+    REQUIRE(headers == static_cast<int>(segments.size()));
+    REQUIRE(merger.truncated().empty());
+
+    // merge_thread_segments keeps the first header only
+    std::ostringstream out;
+    auto result = merge_thread_segments(segments, out);
+    REQUIRE(result.has_value());
+    REQUIRE(result->records == kThreads * kPerThread);
+    std::istringstream lines(out.str());
+    std::string line;
+    std::getline(lines, line);
+    REQUIRE(json::parse(line).contains("log_header"));
+    int count = 0;
+    while (std::getline(lines, line)) {
+        REQUIRE_FALSE(json::parse(line).contains("log_header"));
+        ++count;
+    }
+    REQUIRE(count == kThreads * kPerThread);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Per-thread file handler never appends to an earlier run", "[handler][per_thread]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto base = fixture.test_log_dir / "app.log";
+    auto write_one = [&](const std::string& message) {
+        PerThreadFileHandler handler(base);
+        LogEntry entry;
+        entry.timestamp = std::chrono::system_clock::now();
+        entry.message = message;
+        handler.write(entry);
+    };
+
+    write_one("first");
+    auto segments = find_thread_segments(base);
+    REQUIRE(segments.size() == 1);
+
+    // Crash mid-write: the first run's segment ends in half a frame
+    {
+        std::ofstream torn(segments[0], std::ios::binary | std::ios::app);
+        torn.write("\x01\x02\x03", 3);
+    }
+
+    write_one("second");
+    segments = find_thread_segments(base);
+    REQUIRE(segments.size() == 2);
+    REQUIRE(thread_segment_index(base, segments[1]) == 1u);
+
+    std::ostringstream out;
+    auto result = merge_thread_segments(segments, out);
+    REQUIRE(result.has_value());
+    REQUIRE(result->records == 2);
+    REQUIRE(result->truncated == std::vector<fs::path>{segments[0]});
+    REQUIRE(out.str().find("first") < out.str().find("second"));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Spill buffer sheds lower levels first", "[handler][spill]") {
+    SpillBuffer spill(40);
+    std::string ten(10, 'x');
+
+    REQUIRE(spill.push(Level::Debug, "d1" + std::string(8, '.')));
+    REQUIRE(spill.push(Level::Info, "i1" + std::string(8, '.')));
+    REQUIRE(spill.push(Level::Debug, "d2" + std::string(8, '.')));
+    REQUIRE(spill.push(Level::Error, "e1" + std::string(8, '.')));
+    REQUIRE(spill.bytes() == 40);
+
+    // Full: a WARNING displaces the oldest DEBUG, then the next DEBUG
+    REQUIRE(spill.push(Level::Warning, "w1" + std::string(8, '.')));
+    REQUIRE(spill.push(Level::Warning, "w2" + std::string(8, '.')));
+    REQUIRE(spill.shed()[SpillBuffer::index(Level::Debug)] == 2);
+
+    // Only INFO and above left: a DEBUG record is dropped itself
+    REQUIRE_FALSE(spill.push(Level::Debug, ten));
+    REQUIRE(spill.shed()[SpillBuffer::index(Level::Debug)] == 3);
+
+    // Arrival order is kept across levels
+    std::vector<std::string> order;
+    while (!spill.empty()) {
+        order.emplace_back(spill.front().substr(0, 2));
+        spill.pop_front();
+    }
+    REQUIRE(order == std::vector<std::string>{"i1", "e1", "w1", "w2"});
+    REQUIRE(spill.bytes() == 0);
+}
+
+TEST_CASE("File handler spills while the disk fails and replays on recovery", "[handler][spill]") {
+    HandlerTestFixture fixture;
+    fixture.SetUp();
+
+    auto log_file = fixture.test_log_dir / "spill.log";
+    auto make_entry = [](Level level, std::string message) {
+        LogEntry entry;
+        entry.level = level;
+        entry.message = std::move(message);
+        return entry;
+    };
+
+    {
+        FileHandler handler(log_file, nullptr, {}, SpillOptions{
+            .spill_bytes = 1024 * 1024,
+            .slow_write = std::chrono::milliseconds(0),
+            .retry_initial = std::chrono::milliseconds(1),
+            .retry_max = std::chrono::milliseconds(4)
+        });
+        handler.write(make_entry(Level::Info, "before"));
+        handler.flush();
+
+        // The file may not grow: writes fail with EFBIG (SIGXFSZ ignored)
+        auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous{};
+        ::getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = static_cast<rlim_t>(fs::file_size(log_file));
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+
+        // Larger than the stream buffer, so the write reaches the disk at once
+        handler.write(make_entry(Level::Error, "large " + std::string(16 * 1024, 'x')));
+        auto stats = handler.disk_stats();
+        REQUIRE(stats.degraded);
+        REQUIRE(stats.degradations == 1);
+        REQUIRE(stats.write_errors >= 1);
+
+        for (int i = 0; i < 20; ++i) {
+            handler.write(make_entry(Level::Debug, "spilled " + std::to_string(i)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stats = handler.disk_stats();
+        REQUIRE(stats.degraded);
+        REQUIRE(stats.spilled == 21);
+        REQUIRE(stats.retries >= 1);
+        REQUIRE(stats.spill_bytes > 16 * 1024);
+
+        ::setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, previous_handler);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        handler.write(make_entry(Level::Info, "after"));
+        handler.flush();
+        stats = handler.disk_stats();
+        REQUIRE_FALSE(stats.degraded);
+        REQUIRE(stats.recoveries == 1);
+        REQUIRE(stats.replayed == 21);
+        REQUIRE(stats.spill_bytes == 0);
+        REQUIRE(stats.shed_total() == 0);
+    }
+
+    auto lines = fixture.read_lines(log_file);
+    REQUIRE(lines.size() == 23);
+    REQUIRE(json::parse(lines[0])["message"] == "before");
+    REQUIRE(json::parse(lines[1])["message"].get<std::string>().starts_with("large"));
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE(json::parse(lines[2 + i])["message"] == "spilled " + std::to_string(i));
+    }
+    REQUIRE(json::parse(lines[22])["message"] == "after");
+
+    fixture.TearDown();
+}
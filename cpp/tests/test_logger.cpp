@@ -9,6 +9,10 @@
  * - Context inheritance (parent → child loggers)
  * - with_context() creates new logger with merged context
  * - Timer functionality (RAII duration logging)
+ * - Record size limits (UTF-8-safe truncation, truncation counter)
+ * - Per-handler levels and routing by logger-name prefix
+ * - Parallel sink fan-out (Config::sink_workers)
+ * - Durable audit records with commit tokens
  */
 
 #include <catch2/catch_test_macros.hpp>
@@ -17,6 +21,8 @@
 #include <agora/log/logger.hpp>
 #include <agora/log/config.hpp>
 #include <agora/log/context.hpp>
+#include <agora/log/limits.hpp>
+#include <agora/log/sink_executor.hpp>
 
 #include <filesystem>
 #include <fstream>
@@ -518,3 +524,231 @@ TEST_CASE("Performance - logging overhead", "[logger][performance]") {
 
     fixture.TearDown();
 }
+
+TEST_CASE("UTF-8 safe truncation", "[logger][limits]") {
+    // "é" is 2 bytes, "€" is 3 bytes
+    REQUIRE(utf8_prefix("abc", 10) == "abc");
+    REQUIRE(utf8_prefix("abc", 2) == "ab");
+    REQUIRE(utf8_prefix("a\xC3\xA9" "b", 2) == "a");
+    REQUIRE(utf8_prefix("a\xC3\xA9" "b", 3) == "a\xC3\xA9");
+    REQUIRE(utf8_prefix("\xE2\x82\xAC\xE2\x82\xAC", 5) == "\xE2\x82\xAC");
+    REQUIRE(utf8_prefix("abc", 0) == "");
+
+    std::string out;
+    REQUIRE_FALSE(assign_truncated(out, "short", 10));
+    REQUIRE(out == "short");
+    std::string accents;
+    for (int i = 0; i < 30; ++i) accents += "\xC3\xA9";
+    REQUIRE(assign_truncated(out, accents, 51));  // 3 content bytes -> one whole "é"
+    REQUIRE(out == "\xC3\xA9...[truncated 58 bytes]");
+    REQUIRE_FALSE(assign_truncated(out, out, 51));  // Idempotent
+    REQUIRE_FALSE(assign_truncated(out, std::string(100, 'x'), 0));
+    REQUIRE(out.size() == 100);
+}
+
+TEST_CASE("Record limits", "[logger][limits]") {
+    LogEntry entry;
+    entry.message = std::string(1000, 'm');
+    entry.context = {
+        {"small", std::string("keep me")},
+        {"big", std::string(5000, 'b')},
+        {"n", std::int64_t{42}}
+    };
+
+    SECTION("Field cap") {
+        REQUIRE(apply_limits(entry, RecordLimits{.max_field_bytes = 100}));
+        REQUIRE(entry.message == std::string(52, 'm') + "...[truncated 948 bytes]");
+        REQUIRE(std::get<std::string>(entry.context["big"]).size() <= 100);
+        REQUIRE(std::get<std::string>(entry.context["small"]) == "keep me");
+    }
+
+    SECTION("Record cap shortens the largest fields first") {
+        REQUIRE(apply_limits(entry, RecordLimits{.max_record_bytes = 2048}));
+        auto& big = std::get<std::string>(entry.context["big"]);
+        REQUIRE(std::get<std::string>(entry.context["small"]) == "keep me");
+        REQUIRE(big.ends_with("bytes]"));
+        REQUIRE(entry.message.ends_with("bytes]"));
+        REQUIRE(entry.message.size() + big.size() + 7 <= 2048);
+    }
+
+    SECTION("Within limits is untouched") {
+        auto copy = entry;
+        REQUIRE_FALSE(apply_limits(entry, RecordLimits{.max_field_bytes = 10000, .max_record_bytes = 100000}));
+        REQUIRE(entry.message == copy.message);
+    }
+
+    SECTION("Too many keys are dropped") {
+        for (int i = 0; i < 200; ++i) {
+            entry.context["key_" + std::to_string(i)] = std::int64_t{i};
+        }
+        REQUIRE(apply_limits(entry, RecordLimits{.max_record_bytes = 1024}));
+        REQUIRE(entry.context.contains("_dropped_keys"));
+        REQUIRE(entry.context.size() < 50);
+    }
+}
+
+TEST_CASE("Logger enforces record limits", "[logger][limits]") {
+    LoggerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = fixture.create_test_config();
+    config.limits = RecordLimits{.max_field_bytes = 1024, .max_record_bytes = 4096};
+    REQUIRE(initialize(config).has_value());
+
+    auto before = truncated_records();
+    auto logger = get_logger("test.limits");
+    logger.info(std::string(1'000'000, 'x'), {{"payload", std::string(1'000'000, 'y')}});
+    logger.info("normal");
+
+    auto logs = fixture.flush_and_read_logs();
+    REQUIRE(logs.size() == 2);
+    REQUIRE(logs[0]["message"].get<std::string>().size() <= 1024);
+    REQUIRE(logs[0]["message"].get<std::string>().ends_with("...[truncated 999024 bytes]"));
+    REQUIRE(logs[0]["context"]["payload"].get<std::string>().size() <= 1024);
+    REQUIRE(logs[1]["message"] == "normal");
+    REQUIRE(truncated_records() == before + 1);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Handler levels and routing by logger prefix", "[logger][routing]") {
+    LoggerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = fixture.create_test_config();
+    auto audit_file = fixture.test_log_dir / "audit.log";
+
+    SECTION("Per-handler threshold") {
+        config.file_level = Level::Warning;
+        REQUIRE(initialize(config).has_value());
+
+        auto logger = get_logger("test.threshold");
+        logger.debug("dropped");
+        logger.info("dropped");
+        logger.warning("kept");
+
+        auto logs = fixture.flush_and_read_logs();
+        REQUIRE(logs.size() == 1);
+        REQUIRE(logs[0]["message"] == "kept");
+    }
+
+    SECTION("Routes by longest prefix") {
+        config.routes = {
+            Route{.prefix = "agora.audit", .file = audit_file},
+            Route{.prefix = "agora.marketdata", .level = Level::Info},
+            Route{.prefix = "agora.marketdata.depth", .level = Level::Error},
+        };
+        REQUIRE(initialize(config).has_value());
+
+        get_logger("agora.audit.trades").debug("audit");
+        get_logger("agora.auditor").debug("not audit");
+        auto md = get_logger("agora.marketdata.feed").with_context({{"venue", "XNAS"}});
+        md.debug("md debug");
+        md.info("md info");
+        get_logger("agora.marketdata.depth").warning("depth warning");
+        get_logger("agora.oms").debug("oms debug");
+
+        auto logs = fixture.flush_and_read_logs();
+        REQUIRE(logs.size() == 3);
+        REQUIRE(logs[0]["message"] == "not audit");
+        REQUIRE(logs[1]["message"] == "md info");
+        REQUIRE(logs[2]["message"] == "oms debug");
+
+        auto audit = read_json_logs(audit_file);
+        REQUIRE(audit.size() == 1);
+        REQUIRE(audit[0]["message"] == "audit");
+        REQUIRE(audit[0]["logger_name"] == "agora.audit.trades");
+    }
+
+    SECTION("Route with explicit handlers plus its file") {
+        config.routes = {Route{.prefix = "agora.audit", .handlers = {"file"}, .file = audit_file}};
+        REQUIRE(initialize(config).has_value());
+
+        get_logger("agora.audit").info("both");
+
+        REQUIRE(fixture.flush_and_read_logs().size() == 1);
+        REQUIRE(read_json_logs(audit_file).size() == 1);
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Parallel sink fan-out keeps per-file order", "[logger][executor]") {
+    LoggerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = fixture.create_test_config();
+    auto audit_file = fixture.test_log_dir / "audit.log";
+    config.sink_workers = 2;
+    config.routes = {Route{.prefix = "agora.audit", .handlers = {"file"}, .file = audit_file}};
+    REQUIRE(initialize(config).has_value());
+
+    auto logger = get_logger("agora.audit");
+    for (int i = 0; i < 500; ++i) {
+        logger.info("event", {{"seq", std::int64_t{i}}});
+    }
+    {
+        auto timer = logger.timer("timed");
+    }
+
+    auto logs = fixture.flush_and_read_logs();
+    auto audit = read_json_logs(audit_file);
+    REQUIRE(logs.size() == 501);
+    REQUIRE(audit.size() == 501);
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(logs[static_cast<std::size_t>(i)]["context"]["seq"] == i);
+        REQUIRE(audit[static_cast<std::size_t>(i)]["context"]["seq"] == i);
+    }
+    REQUIRE(logs[500]["message"] == "timed");
+
+    auto stats = sink_stats();
+    REQUIRE(stats.size() == 2);
+    REQUIRE(stats[0].name == "file");
+    REQUIRE(stats[0].written == 501);
+    REQUIRE(stats[1].name == audit_file.string());
+    REQUIRE(stats[1].queued == 0);
+
+    fixture.TearDown();
+    REQUIRE(sink_stats().empty());
+}
+
+TEST_CASE("Critical and audit records return commit tokens", "[logger][durable]") {
+    LoggerTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = fixture.create_test_config();
+    auto audit_file = fixture.test_log_dir / "audit.log";
+    config.durable_file_enabled = true;
+    config.durable_file_path = audit_file;
+    config.routes = {Route{.prefix = "agora.audit", .handlers = {"durable"}}};
+    fs::remove(audit_file);
+
+    SECTION("Synchronous handlers") {
+        REQUIRE(initialize(config).has_value());
+    }
+    SECTION("Sink executor") {
+        config.sink_workers = 2;
+        REQUIRE(initialize(config).has_value());
+    }
+
+    auto audit = get_logger("agora.audit.orders");
+    auto token = audit.audit("order accepted", {{"order_id", std::int64_t{42}}});
+    REQUIRE(token.durable());
+    REQUIRE(token.wait().has_value());
+    REQUIRE(token.ready());
+    REQUIRE(audit.critical("kill switch").wait().has_value());
+
+    // The record is on disk before the token completes
+    auto records = read_json_logs(audit_file);
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0]["message"] == "order accepted");
+    REQUIRE(records[0]["context"]["order_id"] == 42);
+
+    // Loggers not routed to a durable handler get a completed token
+    auto other = get_logger("agora.oms").critical("not durable");
+    REQUIRE_FALSE(other.durable());
+    REQUIRE(other.ready());
+    REQUIRE(other.wait().has_value());
+
+    fixture.TearDown();
+}
@@ -7,17 +7,28 @@
  * - Backup file naming (app.log.1, app.log.2, etc.)
  * - Max backup count enforcement (oldest deleted)
  * - Thread-safe rotation during concurrent writes
+ * - Preallocated / O_DIRECT segments
+ * - Background rotation (prepared next segment, crash recovery)
+ * - Time-based and hybrid rotation (timestamped backups)
+ * - Compression, sequence naming and size/age retention of backups
  */
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <agora/log/logger.hpp>
 #include <agora/log/config.hpp>
+#include <agora/log/handlers/segment_file.hpp>
+#include <agora/log/handlers/rotating_file.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <thread>
 #include <vector>
+#include <sys/resource.h>
 
 using namespace agora::log;
 namespace fs = std::filesystem;
@@ -344,3 +355,657 @@ TEST_CASE("Startup with existing log file", "[rotation][startup]") {
 
     fixture.TearDown();
 }
+
+TEST_CASE("Preallocated direct I/O segments keep exact sizes", "[rotation][segment]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto config = Config{};
+    config.service_name = "test";
+    config.file_path = fixture.test_log_file;
+    config.max_file_size_mb = 0.010;  // 10 KB per file
+    config.max_backup_count = 20;
+    config.console_enabled = false;
+    config.file_preallocate = true;
+    config.file_direct_io = true;
+
+    auto result = initialize(config);
+    REQUIRE(result.has_value());
+
+    {
+        auto logger = get_logger("test.segment");
+        for (int i = 0; i < 100; ++i) {
+            logger.info("Segment entry", {
+                {"sequence", std::int64_t{i}},
+                {"padding", "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX"}
+            });
+        }
+
+        // Flushed data is readable while the segment is open; only the
+        // tail block may carry NUL padding
+        flush();
+        std::ifstream file(fixture.test_log_file, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        auto end = content.find_last_not_of('\0');
+        REQUIRE(end != std::string::npos);
+        REQUIRE(content[end] == '\n');
+        REQUIRE(content.size() - end - 1 < SegmentFile::kBlockSize);
+    }
+
+    // The handler closes (and truncates) its segment once the last logger is gone
+    shutdown();
+
+    // After close every file is truncated to its records, none over the limit
+    std::size_t total = 0;
+    for (const auto& file : fixture.get_log_files()) {
+        std::ifstream in(file, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        REQUIRE(content.find('\0') == std::string::npos);
+        REQUIRE(content.size() <= 10485);
+        total += fixture.count_lines(file);
+    }
+    REQUIRE(total == 100);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Direct I/O segment drops crash padding on reopen", "[rotation][segment]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    // Simulate a crash after a padded tail block was written
+    std::string existing = "{\"n\":1}\n";
+    {
+        std::ofstream file(fixture.test_log_file, std::ios::binary);
+        file << existing << std::string(SegmentFile::kBlockSize - existing.size(), '\0');
+    }
+
+    SegmentFile segment;
+    segment.open(fixture.test_log_file, SegmentOptions{.preallocate_bytes = 64 * 1024, .direct_io = true});
+    REQUIRE(segment.size() == existing.size());
+
+    std::string next = "{\"n\":2}\n";
+    segment.write(next);
+    segment.close();
+
+    std::ifstream in(fixture.test_log_file, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(content == existing + next);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Segment closed after a failed write keeps no unwritten bytes", "[rotation][segment]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    std::string first = "{\"n\":1}\n";
+    SegmentFile segment;
+    segment.open(fixture.test_log_file, SegmentOptions{.preallocate_bytes = 64 * 1024});
+    segment.write(first);
+    segment.flush();
+
+    // The file may grow by 3 bytes only: the next record is written in part,
+    // then the write fails with EFBIG (SIGXFSZ ignored)
+    auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit previous{};
+    ::getrlimit(RLIMIT_FSIZE, &previous);
+    rlimit limit = previous;
+    limit.rlim_cur = first.size() + 3;
+    ::setrlimit(RLIMIT_FSIZE, &limit);
+    segment.write("{\"n\":2}\n");
+    REQUIRE_THROWS_AS(segment.flush(), std::system_error);
+    segment.close();
+    ::setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, previous_handler);
+
+    // No torn record: reopening appends right after the last complete write
+    segment.open(fixture.test_log_file, SegmentOptions{.preallocate_bytes = 64 * 1024});
+    segment.write("{\"n\":3}\n");
+    segment.close();
+
+    std::ifstream in(fixture.test_log_file, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(content == first + "{\"n\":3}\n");
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Background rotation keeps the next segment prepared", "[rotation][background]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto next = fs::path(fixture.test_log_file.string() + ".next");
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024, 50);
+        REQUIRE(fs::exists(next));
+
+        LogEntry entry;
+        entry.level = Level::Info;
+        for (int i = 0; i < 100; ++i) {
+            entry.message = "Background entry " + std::to_string(i);
+            handler.write(entry);
+        }
+
+        // flush() waits for the renames, so every record is in its final file
+        handler.flush();
+        REQUIRE(handler.rotations() > 2);
+        REQUIRE_FALSE(handler.rotation_disabled());
+        REQUIRE(fs::exists(next));
+        REQUIRE(fs::file_size(next) == 0);
+    }
+
+    // The unused prepared segment is removed on close
+    REQUIRE_FALSE(fs::exists(next));
+
+    auto files = fixture.get_log_files();
+    std::reverse(files.begin(), files.end());  // Oldest backup first
+    int expected = 0;
+    for (const auto& file : files) {
+        REQUIRE(fs::file_size(file) <= 1024);
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line)) {
+            REQUIRE(line.find("Background entry " + std::to_string(expected++) + "\"") != std::string::npos);
+        }
+    }
+    REQUIRE(expected == 100);
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Records left in the next segment by a crash are rotated in", "[rotation][background]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    // A crash between swapping segments and renaming them
+    auto next = fs::path(fixture.test_log_file.string() + ".next");
+    std::ofstream(fixture.test_log_file) << "{\"n\":1}\n";
+    std::ofstream(next) << "{\"n\":2}\n";
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024 * 1024, 5);
+        LogEntry entry;
+        entry.message = "after restart";
+        handler.write(entry);
+    }
+
+    REQUIRE(fixture.count_lines(fixture.test_log_file.string() + ".1") == 1);
+    std::ifstream in(fixture.test_log_file);
+    std::string line;
+    REQUIRE(std::getline(in, line));
+    REQUIRE(line == "{\"n\":2}");
+    REQUIRE(std::getline(in, line));
+    REQUIRE(line.find("after restart") != std::string::npos);
+    REQUIRE_FALSE(fs::exists(next));
+
+    fixture.TearDown();
+}
+
+namespace {
+
+// Start of the UTC hour containing now, plus @p hours
+std::chrono::system_clock::time_point hour_start(int hours) {
+    auto now = std::chrono::floor<std::chrono::hours>(std::chrono::system_clock::now());
+    return now + std::chrono::hours(hours);
+}
+
+std::string hour_stamp(std::chrono::system_clock::time_point time, const char* format = "%Y-%m-%dT%H") {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    char out[32];
+    std::strftime(out, sizeof(out), format, &tm);
+    return out;
+}
+
+std::vector<std::string> messages(const fs::path& path) {
+    std::vector<std::string> result;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        auto start = line.find("\"message\":\"") + 11;
+        result.push_back(line.substr(start, line.find('"', start) - start));
+    }
+    return result;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("A failed rotation keeps app.log live and is retried", "[rotation][background]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    // The oldest backup cannot be deleted until the test removes it
+    auto blocker = fs::path(fixture.test_log_file.string() + ".1");
+    fs::create_directories(blocker / "in_the_way");
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024, 1);
+        LogEntry entry;
+        entry.level = Level::Info;
+        int written = 0;
+        auto write = [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                entry.message = "Retried entry " + std::to_string(written++);
+                handler.write(entry);
+            }
+            handler.flush();
+        };
+
+        write(30);
+        REQUIRE(handler.rotations() == 0);
+        REQUIRE(handler.rotation_paused());
+        REQUIRE_FALSE(handler.rotation_disabled());
+        REQUIRE(fixture.count_lines(fixture.test_log_file) == 30);
+
+        fs::remove_all(blocker);
+        for (int i = 0; i < 300 && handler.rotations() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            write(1);
+        }
+        REQUIRE(handler.rotations() > 0);
+        REQUIRE_FALSE(handler.rotation_paused());
+
+        // Every record is in app.log or its backup, in order
+        std::vector<std::string> all = messages(blocker);
+        for (auto& message : messages(fixture.test_log_file)) {
+            all.push_back(std::move(message));
+        }
+        REQUIRE(all.size() == static_cast<std::size_t>(written));
+        for (int i = 0; i < written; ++i) {
+            REQUIRE(all[static_cast<std::size_t>(i)] == "Retried entry " + std::to_string(i));
+        }
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Hourly rotation names files after their period", "[rotation][time]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 0, 10, nullptr, {}, RotationInterval::Hourly);
+        LogEntry entry;
+        auto write = [&](std::chrono::system_clock::time_point time, const char* message) {
+            entry.timestamp = time;
+            entry.message = message;
+            handler.write(entry);
+        };
+
+        write(hour_start(1) - std::chrono::seconds(1), "a");
+        write(hour_start(1), "b");
+        write(hour_start(1) + std::chrono::minutes(30), "c");
+        write(hour_start(2) + std::chrono::seconds(1), "d");
+        handler.flush();
+        REQUIRE(handler.rotations() == 2);
+    }
+
+    auto base = fixture.test_log_file.string() + ".";
+    REQUIRE(messages(base + hour_stamp(hour_start(0))) == std::vector<std::string>{"a"});
+    REQUIRE(messages(base + hour_stamp(hour_start(1))) == std::vector<std::string>{"b", "c"});
+    REQUIRE(messages(fixture.test_log_file) == std::vector<std::string>{"d"});
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Hybrid rotation splits a period by size", "[rotation][time]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now());
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024, 50, nullptr, {}, RotationInterval::Daily);
+        LogEntry entry;
+        entry.timestamp = std::chrono::system_clock::now();
+        for (int i = 0; i < 20; ++i) {
+            entry.message = "entry " + std::to_string(i);
+            handler.write(entry);
+        }
+        entry.timestamp = today + std::chrono::days(1);
+        entry.message = "tomorrow";
+        handler.write(entry);
+    }
+
+    // today, today.1, today.2, ... hold the entries in order, tomorrow's is current
+    auto base = fixture.test_log_file.string() + "." + hour_stamp(today, "%Y-%m-%d");
+    REQUIRE(fs::exists(base + ".1"));
+    int expected = 0;
+    for (std::size_t index = 0;; ++index) {
+        fs::path path = index == 0 ? base : base + "." + std::to_string(index);
+        if (!fs::exists(path)) {
+            break;
+        }
+        REQUIRE(fs::file_size(path) <= 1024);
+        for (const auto& message : messages(path)) {
+            REQUIRE(message == "entry " + std::to_string(expected++));
+        }
+    }
+    REQUIRE(expected == 20);
+    REQUIRE(messages(fixture.test_log_file) == std::vector<std::string>{"tomorrow"});
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Time-based rotation keeps max_backup_count newest files", "[rotation][time]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 0, 2, nullptr, {}, RotationInterval::Hourly);
+        LogEntry entry;
+        for (int hour = 0; hour < 5; ++hour) {
+            entry.timestamp = hour_start(hour);
+            entry.message = "hour " + std::to_string(hour);
+            handler.write(entry);
+        }
+    }
+
+    auto base = fixture.test_log_file.string() + ".";
+    REQUIRE_FALSE(fs::exists(base + hour_stamp(hour_start(1))));
+    REQUIRE(messages(base + hour_stamp(hour_start(2))) == std::vector<std::string>{"hour 2"});
+    REQUIRE(messages(base + hour_stamp(hour_start(3))) == std::vector<std::string>{"hour 3"});
+    REQUIRE(messages(fixture.test_log_file) == std::vector<std::string>{"hour 4"});
+
+    fixture.TearDown();
+}
+
+namespace {
+
+// Poll until @p done, since backups are compressed in the background
+template <typename Predicate>
+bool eventually(Predicate done) {
+    for (int i = 0; i < 500 && !done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return done();
+}
+
+bool compressed_magic(const fs::path& path, Compression compression) {
+    unsigned char magic[4] = {};
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(magic), 4);
+    if (compression == Compression::Zstd) {
+        return magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd;
+    }
+    return magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Rotated backups are compressed in the background", "[rotation][compress]") {
+    if (default_compression() == Compression::None) {
+        SUCCEED("No compression library in this build");
+        return;
+    }
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto base = fixture.test_log_file.string() + ".";
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024, 3, nullptr, {}, RotationInterval::None, true);
+        auto suffix = std::string(compression_suffix(handler.compression()));
+        REQUIRE(handler.compression() == default_compression());
+
+        LogEntry entry;
+        entry.level = Level::Info;
+        auto write = [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                entry.message = "Compressible entry " + std::to_string(i);
+                handler.write(entry);
+            }
+            handler.flush();
+        };
+        auto all_compressed = [&] {
+            for (int i = 1; i <= 3; ++i) {
+                if (fs::exists(base + std::to_string(i)) || !fs::exists(base + std::to_string(i) + suffix)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        write(100);
+        REQUIRE(eventually(all_compressed));
+        REQUIRE(handler.backups_compressed() >= 3);
+        REQUIRE_FALSE(fs::exists(base + "4" + suffix));
+        std::uint64_t total = 0;
+        for (int i = 1; i <= 3; ++i) {
+            auto path = base + std::to_string(i) + suffix;
+            REQUIRE(compressed_magic(path, handler.compression()));
+            total += fs::file_size(path);
+        }
+        REQUIRE(eventually([&] { return handler.backup_bytes() == total; }));
+        REQUIRE(total < 3 * 1024);
+
+        // The cascade shifts compressed backups and drops the oldest
+        auto oldest = fs::last_write_time(base + "2" + suffix);
+        for (auto rotations = handler.rotations(); handler.rotations() == rotations;) {
+            write(1);
+        }
+        REQUIRE(eventually(all_compressed));
+        REQUIRE(fs::last_write_time(base + "3" + suffix) == oldest);
+        REQUIRE_FALSE(fs::exists(base + "4" + suffix));
+    }
+    REQUIRE_FALSE(fs::exists(fixture.test_log_file.string() + ".compressing"));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Uncompressed backups from an earlier run are compressed on start", "[rotation][compress]") {
+    if (default_compression() == Compression::None) {
+        SUCCEED("No compression library in this build");
+        return;
+    }
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto base = fixture.test_log_file.string() + ".";
+    std::ofstream(base + "1") << "{\"n\":1}\n";
+    std::ofstream(base + "2") << "{\"n\":2}\n";
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024 * 1024, 5, nullptr, {}, RotationInterval::None, true);
+        auto suffix = std::string(compression_suffix(handler.compression()));
+        REQUIRE(eventually([&] { return handler.backups_compressed() == 2; }));
+        REQUIRE(fs::exists(base + "1" + suffix));
+        REQUIRE(fs::exists(base + "2" + suffix));
+        REQUIRE_FALSE(fs::exists(base + "1"));
+        REQUIRE_FALSE(fs::exists(base + "2"));
+    }
+
+    fixture.TearDown();
+}
+
+namespace {
+
+std::string segment_name(const fs::path& file, std::uint64_t sequence) {
+    char digits[24];
+    std::snprintf(digits, sizeof(digits), ".%06llu", static_cast<unsigned long long>(sequence));
+    return file.filename().string() + digits;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Sequence naming keeps backups in place behind a symlink", "[rotation][sequence]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    const std::size_t backups = 150;
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 256, backups, nullptr, {},
+                                    RotationInterval::None, false, BackupNaming::Sequence);
+        LogEntry entry;
+        entry.level = Level::Info;
+        for (int i = 0; i < 600; ++i) {
+            entry.message = "Sequenced entry " + std::to_string(i);
+            handler.write(entry);
+        }
+        handler.flush();
+
+        std::uint64_t current = handler.sequence();
+        REQUIRE(handler.rotations() > backups);
+        REQUIRE(current == handler.rotations() + 1);
+        REQUIRE(fs::is_symlink(fixture.test_log_file));
+        REQUIRE(fs::read_symlink(fixture.test_log_file) == segment_name(fixture.test_log_file, current));
+
+        // Exactly max_backup_count segments behind the current one, in order
+        std::vector<std::string> all;
+        std::uint64_t backup_bytes = 0;
+        for (std::uint64_t sequence = current - backups; sequence <= current; ++sequence) {
+            auto segment = fixture.test_log_dir / segment_name(fixture.test_log_file, sequence);
+            REQUIRE(fs::file_size(segment) <= 256);
+            backup_bytes += sequence < current ? fs::file_size(segment) : 0;
+            for (auto& message : messages(segment)) {
+                all.push_back(std::move(message));
+            }
+        }
+        REQUIRE_FALSE(fs::exists(fixture.test_log_dir / segment_name(fixture.test_log_file, current - backups - 1)));
+        REQUIRE(handler.backup_bytes() == backup_bytes);
+        REQUIRE(all.back() == "Sequenced entry 599");
+        int first = std::stoi(all.front().substr(16));
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            REQUIRE(all[i] == "Sequenced entry " + std::to_string(first + static_cast<int>(i)));
+        }
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Sequence naming continues after a restart", "[rotation][sequence]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    // A plain file (e.g. from cascade naming) becomes the first segment
+    std::ofstream(fixture.test_log_file) << "{\"n\":1}\n";
+    for (int run = 0; run < 2; ++run) {
+        RotatingFileHandler handler(fixture.test_log_file, 1024 * 1024, 5, nullptr, {},
+                                    RotationInterval::None, false, BackupNaming::Sequence);
+        REQUIRE(handler.sequence() == 1);
+        LogEntry entry;
+        entry.message = "run " + std::to_string(run);
+        handler.write(entry);
+    }
+
+    REQUIRE(fs::is_symlink(fixture.test_log_file));
+    REQUIRE(fixture.count_lines(fixture.test_log_file) == 3);
+    REQUIRE(fixture.count_lines(fixture.test_log_dir / segment_name(fixture.test_log_file, 1)) == 3);
+    REQUIRE_FALSE(fs::exists(fixture.test_log_dir / segment_name(fixture.test_log_file, 2)));
+
+    fixture.TearDown();
+}
+
+TEST_CASE("A disk error during a pending rotation reopens the live segment", "[rotation][sequence]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024, 5, nullptr, {},
+                                    RotationInterval::None, false, BackupNaming::Sequence,
+                                    SpillOptions{.slow_write = std::chrono::milliseconds(0),
+                                                 .retry_initial = std::chrono::milliseconds(1),
+                                                 .retry_max = std::chrono::milliseconds(1)});
+
+        // The symlink cannot move: app.log keeps pointing at segment 1
+        fs::create_directories(fixture.test_log_file.string() + ".link/in_the_way");
+        LogEntry entry;
+        entry.level = Level::Info;
+        entry.message = "before";
+        while (handler.sequence() == 1) {
+            handler.write(entry);
+        }
+        handler.flush();
+        REQUIRE(handler.rotation_paused());
+        auto live = fixture.test_log_dir / segment_name(fixture.test_log_file, 2);
+        REQUIRE(fs::read_symlink(fixture.test_log_file) == segment_name(fixture.test_log_file, 1));
+
+        // A write fails (EFBIG, SIGXFSZ ignored) and the handler closes its file
+        auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous{};
+        ::getrlimit(RLIMIT_FSIZE, &previous);
+        rlimit limit = previous;
+        limit.rlim_cur = fs::file_size(live);
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        entry.message = "large " + std::string(16 * 1024, 'x');
+        handler.write(entry);
+        ::setrlimit(RLIMIT_FSIZE, &previous);
+        std::signal(SIGXFSZ, previous_handler);
+        REQUIRE(handler.disk_stats().degraded);
+
+        // Recovery reopens segment 2, not the backup app.log still points at
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        entry.message = "after";
+        handler.write(entry);
+        handler.flush();
+        REQUIRE_FALSE(handler.disk_stats().degraded);
+        REQUIRE(messages(live).back() == "after");
+        REQUIRE(messages(fixture.test_log_dir / segment_name(fixture.test_log_file, 1)).back() == "before");
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Size retention deletes the oldest backups in the background", "[rotation][retention]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 256, 100, nullptr, {},
+                                    RotationInterval::None, false, BackupNaming::Sequence, {},
+                                    RetentionOptions{.max_total_bytes = 2048});
+        LogEntry entry;
+        entry.level = Level::Info;
+        for (int i = 0; i < 200; ++i) {
+            entry.message = "Retained entry " + std::to_string(i);
+            handler.write(entry);
+        }
+        handler.flush();
+        REQUIRE(handler.rotations() > 20);
+        REQUIRE(eventually([&] { return handler.backup_bytes() <= 2048; }));
+        REQUIRE(handler.backups_expired() > 0);
+
+        // The newest backups survive, without gaps, next to the live segment
+        std::uint64_t current = handler.sequence();
+        std::uint64_t bytes = 0;
+        std::uint64_t sequence = current - 1;
+        for (; fs::exists(fixture.test_log_dir / segment_name(fixture.test_log_file, sequence)); --sequence) {
+            bytes += fs::file_size(fixture.test_log_dir / segment_name(fixture.test_log_file, sequence));
+        }
+        REQUIRE(sequence + 1 < current);
+        REQUIRE(bytes == handler.backup_bytes());
+        REQUIRE(bytes + 256 > 2048);  // One more backup would not have fit
+        REQUIRE(fs::exists(fixture.test_log_dir / segment_name(fixture.test_log_file, current)));
+        REQUIRE(fs::exists(fixture.test_log_dir / segment_name(fixture.test_log_file, current + 1)));
+    }
+
+    fixture.TearDown();
+}
+
+TEST_CASE("Age retention deletes expired backups but not the live file", "[rotation][retention]") {
+    RotationTestFixture fixture;
+    fixture.SetUp();
+
+    auto base = fixture.test_log_file.string() + ".";
+    auto two_days_ago = fs::file_time_type::clock::now() - std::chrono::hours(48);
+    auto write_file = [](const fs::path& path, fs::file_time_type modified) {
+        std::ofstream(path) << "{\"n\":1}\n";
+        fs::last_write_time(path, modified);
+    };
+    write_file(fixture.test_log_file, two_days_ago);
+    write_file(base + "1", fs::file_time_type::clock::now());
+    write_file(base + "2.gz", two_days_ago);
+    write_file(base + "3", two_days_ago);
+    {
+        RotatingFileHandler handler(fixture.test_log_file, 1024 * 1024, 5, nullptr, {},
+                                    RotationInterval::None, false, BackupNaming::Cascade, {},
+                                    RetentionOptions{.max_age = std::chrono::hours(24)});
+        REQUIRE(eventually([&] { return handler.backups_expired() == 2; }));
+        REQUIRE_FALSE(fs::exists(base + "2.gz"));
+        REQUIRE_FALSE(fs::exists(base + "3"));
+        REQUIRE(fs::exists(base + "1"));
+        REQUIRE(fs::exists(fixture.test_log_file));
+        REQUIRE(fs::exists(base + "next"));
+        REQUIRE(handler.backup_bytes() == fs::file_size(base + "1"));
+    }
+
+    fixture.TearDown();
+}
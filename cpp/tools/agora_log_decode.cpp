@@ -0,0 +1,68 @@
+/**
+ * @file agora_log_decode.cpp
+ * @brief Convert binary log files back to JSON lines
+ *
+ * Usage: agora-log-decode [FILE...]
+ *
+ * Reads each FILE (or stdin when none is given) and writes one JSON line
+ * per entry to stdout, identical to what format_json produces.
+ */
+
+#include <agora/log/binary.hpp>
+#include <agora/log/formatter.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+int decode(std::istream& in, std::string_view name) {
+    agora::log::BinaryDecoder decoder(in);
+    agora::log::LogEntry entry;
+    std::string line;
+
+    while (true) {
+        auto result = decoder.next(entry);
+        if (!result) {
+            std::cerr << "agora-log-decode: " << name << ": " << result.error().message << '\n';
+            return 1;
+        }
+        if (!*result) {
+            return 0;
+        }
+
+        line.clear();
+        agora::log::format_json(entry, line);
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && (std::string_view(argv[1]) == "-h" || std::string_view(argv[1]) == "--help")) {
+        std::cout << "Usage: agora-log-decode [FILE...]\n"
+                  << "Convert agora binary log files to JSON lines on stdout.\n";
+        return 0;
+    }
+
+    if (argc == 1) {
+        return decode(std::cin, "<stdin>");
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "agora-log-decode: cannot open " << argv[i] << '\n';
+            status = 1;
+            continue;
+        }
+        status |= decode(in, argv[i]);
+    }
+    return status;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file agora_log_merge.cpp
+ * @brief Merge per-thread log segments into one timestamp-ordered stream
+ *
+ * Usage: agora-log-merge [-o OUTPUT] PATH...
+ *
+ * Each PATH is a segment (app.log.t3) or the base path of a per-thread
+ * file handler (app.log), which stands for all of its segments. The
+ * records are written unchanged, in timestamp order, to OUTPUT or stdout.
+ */
+
+#include <agora/log/thread_segment.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void usage(std::ostream& out) {
+    out << "Usage: agora-log-merge [-o OUTPUT] PATH...\n"
+        << "Merge per-thread log segments (app.log.t0, app.log.t1, ...) by timestamp.\n"
+        << "A PATH that is not a segment stands for all segments of that base path.\n";
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    fs::path output;
+    std::vector<fs::path> segments;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage(std::cout);
+            return 0;
+        }
+        if (arg == "-o") {
+            if (++i == argc) {
+                usage(std::cerr);
+                return 2;
+            }
+            output = argv[i];
+            continue;
+        }
+
+        fs::path path(arg);
+        auto parent = path.parent_path();
+        bool is_segment = fs::is_regular_file(path) &&
+            agora::log::thread_segment_index(parent / path.stem(), path).has_value();
+        if (is_segment) {
+            segments.push_back(path);
+            continue;
+        }
+        auto found = agora::log::find_thread_segments(path);
+        if (found.empty()) {
+            std::cerr << "agora-log-merge: no segments for " << arg << '\n';
+            return 1;
+        }
+        segments.insert(segments.end(), found.begin(), found.end());
+    }
+
+    if (segments.empty()) {
+        usage(std::cerr);
+        return 2;
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "agora-log-merge: cannot open " << output.string() << '\n';
+            return 1;
+        }
+    } else {
+        std::ios::sync_with_stdio(false);
+    }
+
+    auto result = agora::log::merge_thread_segments(segments, output.empty() ? std::cout : file);
+    if (!result) {
+        std::cerr << "agora-log-merge: " << result.error().message << '\n';
+        return 1;
+    }
+    for (const auto& path : result->truncated) {
+        std::cerr << "agora-log-merge: " << path.string() << ": ends in a partial record (skipped)\n";
+    }
+    return 0;
+}